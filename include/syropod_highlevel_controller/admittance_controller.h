@@ -11,11 +11,11 @@
 
 #include "standard_includes.h"
 #include "parameters_and_states.h"
-#include <boost/numeric/odeint.hpp>
 
 #include "model.h"
 
 #define ADMITTANCE_DEADBAND 0.0
+#define MATRIX_EXPONENTIAL_TAYLOR_ORDER 12 ///< Order of taylor series used in calculating state transition matrices
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// This class handles the application of an admittance controller to the robot model. Specifically it calculates a
@@ -36,8 +36,9 @@ public:
   AdmittanceController(std::shared_ptr<Model> model, const Parameters& params);
   
   /// Iterates through legs in the robot model and updates the tip position offset value for each.
-  /// The calculation is achieved through the use of a classical Runge-Kutta ODE solver with a force input
-  /// acquired from a tip force callback OR from estimation from joint effort values.
+  /// Since the virtual mass/spring/damper system is linear, the calculation is achieved by applying the exact
+  /// discrete-time solution of the system over the integrator step time to the states of all legs together, with a
+  /// force input acquired from a tip force callback OR from estimation from joint effort values.
   /// @todo Implement admittance control in x/y axis
   void updateAdmittance(void);
   
@@ -61,9 +62,25 @@ public:
   void updateStiffness(std::shared_ptr<WalkController> walker);
 
 private:
+  /// Generates the discrete-time state transition and input matrices of the virtual mass/spring/damper system over
+  /// the integrator step time, using the matrix exponential of the augmented continuous-time system.
+  /// @param[in] mass The virtual mass of the system
+  /// @param[in] stiffness The virtual stiffness of the system
+  /// @param[in] damping_ratio The virtual damping ratio of the system
+  /// @param[in] step_time The time period over which the system is discretised
+  void generateStateTransition(const double& mass, const double& stiffness,
+                               const double& damping_ratio, const double& step_time);
+
   std::shared_ptr<Model> model_; ///< Pointer to the robot model object
   const Parameters &params_;     ///< Pointer to parameter data structure for storing parameter variables
 
+  Eigen::Matrix2d state_transition_;         ///< Discrete-time state transition matrix of the virtual system
+  Eigen::Vector2d input_transition_;         ///< Discrete-time input matrix of the virtual system
+  Eigen::Vector4d transition_parameters_;    ///< The system parameters from which the transition was generated
+  Eigen::Matrix<double, 2, Eigen::Dynamic> admittance_states_; ///< The batched admittance states of every leg
+  Eigen::Matrix<double, 3, Eigen::Dynamic> tip_forces_;        ///< The batched tip force inputs to every leg
+  Eigen::Matrix<double, 3, Eigen::Dynamic> admittance_deltas_; ///< The batched tip position offsets of every leg
+
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
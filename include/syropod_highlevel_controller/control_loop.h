@@ -0,0 +1,26 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_CONTROL_LOOP_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_CONTROL_LOOP_H
+
+#include "state_controller.h"
+
+/// Runs the controller. Sets rosconsole messaging level and loop rate, waits to acquire initial joint states and for
+/// the system to start, initialises the 'StateController' and then calls the state controller loop and publishers
+/// each cycle, and sends messages for the user interface. In headless simulation the loop is instead stepped in
+/// lockstep with a simulated clock, without waiting for hardware or user input. Subscription callbacks are serviced
+/// from the state controller callback queue on the calling thread between cycles.
+/// @param[in] state The state controller to be run
+/// @param[in] running Flag denoting if the controller should continue running (checked each cycle)
+/// @return Exit status of the control loop (zero on success)
+int runControlLoop(StateController& state, const std::atomic<bool>& running);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_CONTROL_LOOP_H
@@ -16,6 +16,43 @@
 
 #define ID_LIMIT 10000                    ///< Id value limit to prevent overflow
 #define TRAJECTORY_DURATION 1             ///< Time for trajectory markers to exist (sec)
+#define STATIC_MARKER_TOLERANCE 1.0e-4    ///< Change in static marker origin/orientation below which it is unchanged
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Enum designating layers of visualisation markers, each of which may be generated at its own rate.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+enum DebugLayer
+{
+  ROBOT_MODEL_LAYER,          ///< Robot model markers (/shc/debug/robot_model)
+  GRAVITY_LAYER,              ///< Gravity estimate marker (/shc/debug/gravity)
+  WALK_PLANE_LAYER,           ///< Walk plane marker (/shc/debug/walk_plane)
+  TERRAIN_LAYER,              ///< Terrain estimate markers (/shc/debug/terrain)
+  TIP_TRAJECTORY_LAYER,       ///< Tip trajectory markers (/shc/debug/tip_trajectories)
+  JOINT_TORQUE_LAYER,         ///< Joint torque markers (/shc/debug/joint_torque)
+  DEFAULT_TIP_POSITION_LAYER, ///< Default tip position markers (/shc/debug/default_tip_positions)
+  TARGET_TIP_POSITION_LAYER,  ///< Target tip position markers (/shc/debug/target_tip_positions)
+  WORKSPACE_LAYER,            ///< Workspace markers (/shc/debug/workspace)
+  WALKSPACE_LAYER,            ///< Walkspace markers (/shc/debug/walkspace)
+  BEZIER_CURVE_LAYER,         ///< Bezier curve control node markers (/shc/debug/bezier_curves)
+  STRIDE_LAYER,               ///< Stride vector markers (/shc/debug/stride)
+  TIP_FORCE_LAYER,            ///< Tip force markers (/shc/debug/tip_force)
+  DEBUG_LAYER_COUNT,          ///< Misc enum defining number of Debug Layers
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Inputs from which the static (workspace and walkspace) markers of a leg were last published, allowing these markers
+/// to be republished only when the underlying workspace or walkspace changes.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct StaticMarkerState
+{
+  Workspace workspace_;               ///< Workspace from which workspace markers were last published
+  Eigen::Vector3d workspace_origin_;  ///< Origin of workspace (identity tip less body clearance) when last published
+  LimitMap walkspace_;                ///< Walkspace from which walkspace markers were last published
+  Eigen::Vector3d walkspace_origin_;  ///< Origin of walkspace (default tip position) when last published
+  Eigen::Vector3d walk_plane_normal_; ///< Walk plane normal when walkspace markers were last published
+  bool workspace_published_ = false;  ///< Flag denoting if workspace markers are published and current
+  bool walkspace_published_ = false;  ///< Flag denoting if walkspace markers are published and current
+};
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// This class handles generation and publishing of visualisations for display in rviz for debugging purposes.
@@ -29,6 +66,21 @@ public:
   /// Modifier for the time_delta_ member variable.
   inline void setTimeDelta(const double &time_delta) { time_delta_ = time_delta; };
 
+  /// Sets the divisor of the control rate at which each layer of markers is generated.
+  /// @param[in] rate_divisors Map of control rate divisors keyed by layer name (layers not in map are not divided)
+  void setRateDivisors(const std::map<std::string, int> &rate_divisors);
+
+  /// Advances the visualisation cycle count, to be called once per control cycle before generating markers. Static
+  /// markers are marked for republishing if their topics have gained subscribers since the previous cycle.
+  /// @param[in] model A pointer to the robot model object, used to estimate the scale of markers
+  void advanceCycle(std::shared_ptr<Model> model);
+
+  /// Determines if the markers of a layer are to be generated this cycle, i.e. if the cycle count is a multiple of the
+  /// layer rate divisor and the topic of the layer has subscribers.
+  /// @param[in] layer The layer of markers
+  /// @return Bool denoting if markers of the layer are to be generated this cycle
+  bool isLayerDue(const DebugLayer &layer);
+
   /// Publishes visualisation markers which represent the robot model for display in RVIZ. Consists of line segments.
   /// linking the origin points of each joint and tip of each leg.
   /// @param[in] model A pointer to the robot model object
@@ -60,12 +112,14 @@ public:
   /// @param[in] leg A pointer to a leg of the robot model object
   void generateTargetTipPositions(std::shared_ptr<Leg> leg);
 
-  /// Publishes visualisation markers which represent the 2D walkspace for each leg.
+  /// Publishes visualisation markers which represent the 2D walkspace for each leg. Markers are only republished if
+  /// the walkspace, its origin or the walk plane normal have changed since last published.
   /// @param[in] leg A pointer to a leg of the robot model object
   /// @param[in] walkspace  A map of walkspace radii for a range of bearings to be visualised
   void generateWalkspace(std::shared_ptr<Leg> leg, const LimitMap &walkspace);
 
-  /// Publishes visualisation markers which represent the 3D workspace for each leg.
+  /// Publishes visualisation markers which represent the 3D workspace for each leg. Markers are only republished if the
+  /// workspace or its origin have changed since last published.
   /// @param[in] leg A pointer to a leg of the robot model object
   /// @param[in] body_clearance The vertical offset of the body above the walk plane
   void generateWorkspace(std::shared_ptr<Leg> leg, const double &body_clearance);
@@ -101,6 +155,24 @@ private:
   ros::Publisher tip_rotation_publisher_;         ///< Publisher for topic "/shc/visualisation/tip_rotation"
   ros::Publisher gravity_publisher_;              ///< Publisher for topic "/shc/visualisation/gravity"
   ros::Publisher terrain_publisher_;              ///< Publisher for topic "/shc/visualisation/terrain"
+  ros::Publisher* layer_publishers_[DEBUG_LAYER_COUNT]; ///< Pointers to the publisher of each layer of markers
+
+  int rate_divisors_[DEBUG_LAYER_COUNT];          ///< Divisors of control rate at which each layer is generated
+  long cycle_ = 0;                                ///< Count of visualisation cycles
+  uint32_t workspace_subscriber_count_ = 0;       ///< Number of workspace topic subscribers in previous cycle
+  uint32_t walkspace_subscriber_count_ = 0;       ///< Number of walkspace topic subscribers in previous cycle
+  std::map<int, StaticMarkerState> static_marker_states_; ///< Static marker publishing state, keyed by leg id number
+
+  /// Markers reused each cycle so that point buffers are not reallocated
+  visualization_msgs::Marker robot_model_marker_;         ///< Robot model line list marker
+  visualization_msgs::Marker tip_trajectory_marker_;      ///< Tip trajectory marker
+  visualization_msgs::Marker bezier_stance_marker_;       ///< Stance bezier curve control node marker
+  visualization_msgs::Marker bezier_swing_1_marker_;      ///< Primary swing bezier curve control node marker
+  visualization_msgs::Marker bezier_swing_2_marker_;      ///< Secondary swing bezier curve control node marker
+  visualization_msgs::Marker joint_torque_marker_;        ///< Joint torque marker
+  visualization_msgs::Marker walkspace_marker_;           ///< Walkspace line strip marker
+  visualization_msgs::MarkerArray workspace_marker_array_;      ///< Workspace plane line strip markers
+  visualization_msgs::MarkerArray workspace_cage_marker_array_; ///< Workspace cage line strip markers
 
   double time_delta_ = 0.0;   ///< Time period of main loop cycle used for marker duration
   int tip_position_id_ = 0;   ///< Id for tip trajectory markers
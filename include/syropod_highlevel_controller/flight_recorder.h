@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_FLIGHT_RECORDER_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_FLIGHT_RECORDER_H
+
+#include "standard_includes.h"
+#include "pose.h"
+#include "model.h"
+
+#include <mutex>
+#include <type_traits>
+
+#define FLIGHT_RECORDER_VERSION 1           ///< Version of flight record file format (increment on change)
+#define FLIGHT_RECORDER_MAGIC 0x53484346    ///< Identifier written at start of each flight record file ("SHCF")
+#define FLIGHT_RECORDER_MAX_LEGS 8          ///< Maximum number of legs recorded in each flight record
+#define FLIGHT_RECORDER_NAME_LENGTH 16      ///< Maximum length (including terminator) of recorded leg names
+#define FLIGHT_RECORDER_POLL_PERIOD 0.1     ///< Period at which the flush thread checks for flush requests (sec)
+
+/// Enum designating the body pose components recorded in each flight record.
+enum FlightRecordPose
+{
+  CURRENT_POSE_RECORD,
+  MANUAL_POSE_RECORD,
+  AUTO_POSE_RECORD,
+  IMU_POSE_RECORD,
+  INCLINATION_POSE_RECORD,
+  ADMITTANCE_POSE_RECORD,
+  WALK_PLANE_POSE_RECORD,
+  TIP_ALIGN_POSE_RECORD,
+  FLIGHT_RECORD_POSE_COUNT, // Misc enum defining number of Flight Record Poses
+};
+
+/// Fixed layout record of a pose (position and w, x, y, z quaternion rotation).
+struct PoseRecord
+{
+  double position_[3]; ///< The recorded position
+  double rotation_[4]; ///< The recorded rotation quaternion (w, x, y, z)
+};
+
+/// Fixed layout record of the state of a single leg for a single control cycle.
+struct LegRecord
+{
+  double desired_joint_positions_[MAX_LEG_JOINTS]; ///< The desired position of each joint of the leg (rad)
+  double current_joint_positions_[MAX_LEG_JOINTS]; ///< The current position of each joint of the leg (rad)
+  PoseRecord desired_tip_pose_;                    ///< The desired tip pose of the leg
+  PoseRecord current_tip_pose_;                    ///< The current tip pose of the leg
+  double admittance_delta_[3];                     ///< The tip position offset generated by admittance control (m)
+  int32_t phase_;                                  ///< The step phase of the leg stepper
+  int32_t step_state_;                             ///< The step state of the leg stepper
+  int32_t leg_state_;                              ///< The state of the leg
+  int32_t padding_;                                ///< Unused padding maintaining fixed record alignment
+};
+
+/// Fixed layout record of controller state for a single control cycle.
+struct FlightRecord
+{
+  uint64_t cycle_;                                ///< The control cycle number
+  double time_;                                   ///< The ROS time of the control cycle (sec)
+  int32_t robot_state_;                           ///< The state of the robot
+  int32_t walk_state_;                            ///< The state of the walk controller
+  PoseRecord poses_[FLIGHT_RECORD_POSE_COUNT];    ///< The body pose and each component pose of the pose controller
+  LegRecord legs_[FLIGHT_RECORDER_MAX_LEGS];      ///< The state of each leg, indexed by leg id number
+};
+
+/// Fixed layout header written at the start of each flight record file, describing the recorded robot.
+struct FlightRecorderHeader
+{
+  uint32_t magic_;                                                      ///< Flight record file identifier
+  uint32_t version_;                                                    ///< Flight record file format version
+  uint32_t record_size_;                                                ///< Size of each flight record (bytes)
+  uint32_t leg_count_;                                                  ///< Number of recorded legs
+  uint32_t joint_counts_[FLIGHT_RECORDER_MAX_LEGS];                     ///< Number of recorded joints of each leg
+  char leg_names_[FLIGHT_RECORDER_MAX_LEGS][FLIGHT_RECORDER_NAME_LENGTH]; ///< Identification name of each leg
+  uint64_t record_count_;                                               ///< Number of records following the header
+};
+
+static_assert(std::is_trivially_copyable<FlightRecord>::value, "Flight records must be trivially copyable");
+static_assert(std::is_trivially_copyable<FlightRecorderHeader>::value, "Flight headers must be trivially copyable");
+
+/// Writes a pose into a fixed layout pose record.
+/// @param[in] pose The pose to be recorded
+/// @param[out] record The pose record to be written
+inline void recordPose(const Pose& pose, PoseRecord* record)
+{
+  record->position_[0] = pose.position_[0];
+  record->position_[1] = pose.position_[1];
+  record->position_[2] = pose.position_[2];
+  record->rotation_[0] = pose.rotation_.w();
+  record->rotation_[1] = pose.rotation_.x();
+  record->rotation_[2] = pose.rotation_.y();
+  record->rotation_[3] = pose.rotation_.z();
+}
+
+/// Accessor for the name of a flight record pose component.
+/// @param[in] pose The flight record pose component
+/// @return The name of the pose component
+inline std::string getFlightRecordPoseName(const FlightRecordPose& pose)
+{
+  const std::string names[FLIGHT_RECORD_POSE_COUNT] =
+    { "current_pose", "manual_pose", "auto_pose", "imu_pose",
+      "inclination_pose", "admittance_pose", "walk_plane_pose", "tip_align_pose" };
+  return names[pose];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class implements an in-process flight recorder of per control cycle controller state. Records are written by
+/// the control thread into a preallocated ring buffer without locks or allocation. On request (or on destruction) a
+/// background thread copies the most recent records out of the ring buffer, discarding any overwritten during the
+/// copy, and flushes them to a memory mapped file under the ROS home directory. Flushed files may be converted to CSV
+/// using the flight recorder reader tool.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class FlightRecorder
+{
+public:
+  /// Constructor for flight recorder. Preallocates the ring buffer and flush buffer and starts the flush thread.
+  /// @param[in] model Pointer to the robot model class object, describing the recorded legs and joints
+  /// @param[in] capacity The number of records (control cycles) held by the ring buffer
+  /// @param[in] file_prefix The prefix of the name of each flushed flight record file
+  FlightRecorder(std::shared_ptr<Model> model, const int& capacity, const std::string& file_prefix);
+
+  /// Destructor for flight recorder. Stops the flush thread and flushes all records held by the ring buffer.
+  ~FlightRecorder(void);
+
+  /// Accessor for the record to be written for the current control cycle. Only to be called by the control thread.
+  /// @return Reference to the next record slot of the ring buffer
+  inline FlightRecord& getNextRecord(void)
+  {
+    return records_[head_.load(std::memory_order_relaxed) % records_.size()];
+  };
+
+  /// Commits the record returned by getNextRecord() once written. Only to be called by the control thread. The release
+  /// fence following the head increment orders it before any write to the next record slot (as for a seqlock writer)
+  /// so that a flush observing a write to a slot also observes the head increment which invalidates it.
+  inline void commitRecord(void)
+  {
+    head_.fetch_add(1, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_release);
+  };
+
+  /// Requests the flush thread to flush the records held by the ring buffer. Does not block.
+  inline void requestFlush(void) { flush_requested_ = true; };
+
+  /// Copies the records currently held by the ring buffer and writes them to a new memory mapped flight record file.
+  /// @return Bool denoting if the records were successfully written
+  bool flush(void);
+
+private:
+  /// Main function of the flush thread. Polls for flush requests until the flight recorder is destroyed.
+  void run(void);
+
+  std::vector<FlightRecord> records_;             ///< Preallocated ring buffer of records written by control thread
+  std::vector<FlightRecord> flush_records_;       ///< Preallocated buffer of records copied from ring buffer on flush
+  std::atomic<uint64_t> head_{ 0 };               ///< Count of records committed to the ring buffer
+  std::atomic<bool> flush_requested_{ false };    ///< Flag denoting if a flush has been requested
+  std::atomic<bool> running_{ true };             ///< Flag denoting if the flush thread should continue running
+  std::mutex flush_mutex_;                        ///< Mutex serialising flushes (never locked by control thread)
+  std::thread flush_thread_;                      ///< Thread flushing records to file on request
+  FlightRecorderHeader header_;                   ///< Header describing recorded robot written to each file
+  std::string file_prefix_;                       ///< Prefix of the name of each flushed flight record file
+  int flush_count_ = 0;                           ///< Number of flight record files written
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_FLIGHT_RECORDER_H
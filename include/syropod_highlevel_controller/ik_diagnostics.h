@@ -0,0 +1,84 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_IK_DIAGNOSTICS_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_IK_DIAGNOSTICS_H
+
+#include "standard_includes.h"
+#include "model.h"
+#include "snapshot_buffer.h"
+
+#include <diagnostic_msgs/DiagnosticArray.h>
+
+#define IK_DIAGNOSTICS_POLL_PERIOD 0.05 ///< Period at which the reporting thread checks for new snapshots (sec)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Snapshot of the clamping and inverse kinematics deviation events of all joints and legs over a reporting period.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct IKDiagnosticsSnapshot
+{
+  double period_ = 0.0;                  ///< Duration of the reporting period covered by the snapshot (sec)
+  std::vector<JointDiagnostics> joints_; ///< Clamping events of each joint, indexed by joint state store index
+  std::vector<LegDiagnostics> legs_;     ///< IK deviation events of each leg, indexed by leg id number
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class reports the joint clamping and inverse kinematics deviation events recorded by the robot model. At each
+/// reporting period the control thread copies the fixed size event records of each joint and leg into a preallocated
+/// lock-free snapshot buffer and resets them. A reporting thread formats each snapshot into a throttled warning and a
+/// diagnostics message on /diagnostics, so that no strings are formatted and no messages published on the control
+/// thread however frequently events occur.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class IKDiagnosticsReporter
+{
+public:
+  /// Constructor for IK diagnostics reporter. Preallocates snapshots and diagnostics message and starts the reporting
+  /// thread.
+  /// @param[in] model Pointer to the robot model class object whose events are reported
+  /// @param[in] report_period The period between reports (sec)
+  /// @param[in] log_warnings Flag denoting if reports containing events are also output as warnings
+  /// @param[in] hardware_id The hardware identifier of the diagnostics status of each leg
+  IKDiagnosticsReporter(std::shared_ptr<Model> model, const double& report_period, const bool& log_warnings,
+                        const std::string& hardware_id);
+
+  /// Destructor for IK diagnostics reporter. Stops the reporting thread.
+  ~IKDiagnosticsReporter(void);
+
+  /// Counts control cycles and, once per reporting period, commits a snapshot of the events recorded by the robot
+  /// model and resets them. To be called once per control cycle by the control thread after inverse kinematics.
+  void update(void);
+
+private:
+  /// Main function of the reporting thread. Formats and publishes each committed snapshot until destroyed.
+  void run(void);
+
+  /// Formats a snapshot into the diagnostics message and, if events occurred and warnings are enabled, a warning.
+  /// @param[in] snapshot The snapshot of events to be reported
+  void report(const IKDiagnosticsSnapshot& snapshot);
+
+  std::shared_ptr<Model> model_;                ///< Pointer to robot model object whose events are reported
+  std::shared_ptr<SnapshotBuffer<IKDiagnosticsSnapshot>> snapshot_buffer_; ///< Snapshots passed to reporting thread
+  int report_divisor_ = 1;                      ///< Divisor of control rate at which snapshots are committed
+  long cycle_ = 0;                              ///< Count of control cycles since reporting began
+  double report_period_;                        ///< The period between reports (sec)
+  bool log_warnings_;                           ///< Flag denoting if reports containing events are output as warnings
+
+  std::vector<std::string> joint_names_;        ///< Name of each joint, indexed by joint state store index
+  std::vector<std::string> leg_names_;          ///< Name of each leg, indexed by leg id number
+  std::vector<int> leg_joint_offsets_;          ///< Joint state store index of first joint of each leg
+  std::vector<int> leg_joint_counts_;           ///< Number of joints of each leg
+  ros::Publisher diagnostics_publisher_;        ///< Publisher for topic "/diagnostics"
+  diagnostic_msgs::DiagnosticArray diagnostics_msg_; ///< Diagnostics message with a status for each leg
+
+  std::thread report_thread_;                   ///< Thread formatting and publishing reports
+  std::atomic<bool> running_{ true };           ///< Flag denoting if the reporting thread should continue running
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_IK_DIAGNOSTICS_H
@@ -12,17 +12,24 @@
 #include "standard_includes.h"
 #include "parameters_and_states.h"
 #include "pose.h"
+#include "worker_pool.h"
 #include "syropod_highlevel_controller/LegState.h"
 
 #define IK_TOLERANCE 0.005          ///< Tolerance between desired & resultant tip position from IK/FK(m)
 #define HALF_BODY_DEPTH 0.05        ///< Threshold used to estimate if leg tip has broken the plane of the robot body(m)
 #define DLS_COEFFICIENT 0.02        ///< Coefficient used in Damped Least Squares method for inverse kinematics
 #define JOINT_LIMIT_COST_WEIGHT 0.1 ///< Gain used in determining cost weight for joints approaching limits
-
-#define BEARING_STEP 45          ///< Step to increment bearing in workspace generation algorithm (deg)
-#define MAX_POSITION_DELTA 0.002 ///< Position delta to increment search position in workspace generation algorithm (m)
-#define MAX_WORKSPACE_RADIUS 1.0 ///< Maximum radius allowed in workspace polygedron plane (m)
-#define WORKSPACE_LAYERS 10      ///< Number of planes in workspace polyhedron
+#define MAX_LEG_JOINTS 6            ///< Maximum number of joints per leg supported by the kinematics solvers
+#define ANALYTIC_IK_DH_TOLERANCE 1.0e-6 ///< Tolerance of DH parameter checks selecting closed form 3 DOF IK solver
+
+#define BEARING_STEP 45             ///< Step to increment bearing in workspace generation algorithm (deg)
+#define MAX_POSITION_DELTA 0.002    ///< Position delta to increment search position in workspace generation algorithm (m)
+#define MAX_WORKSPACE_RADIUS 1.0    ///< Maximum radius allowed in workspace polygedron plane (m)
+#define WORKSPACE_LAYERS 10         ///< Number of planes in workspace polyhedron
+#define SEARCH_STRIDE 0.02          ///< Coarse stride along search line used in bisection workspace search (m)
+#define MAX_SEARCH_IK_ITERATIONS 10 ///< Max IK iterations used to reach each test position in bisection workspace search
+#define WORKSPACE_GRID_LAYERS 41    ///< Number of uniformly spaced layers resampled into dense workspace grid
+#define WORKSPACE_GRID_BEARINGS (360 / BEARING_STEP + 1) ///< Number of bearings (0-360 inclusive) in workspace grid
 
 class Leg;
 class Joint;
@@ -49,6 +56,67 @@ public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fixed size record of the clamping events of a single joint, accumulated by the control thread over a diagnostics
+/// reporting period without allocation or string formatting.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct JointDiagnostics
+{
+  uint32_t velocity_clamp_count_ = 0; ///< Number of cycles in which the desired velocity was clamped
+  uint32_t position_clamp_count_ = 0; ///< Number of cycles in which the desired position was clamped
+  double max_velocity_excess_ = 0.0;  ///< Largest excess of desired speed beyond the maximum angular speed (rad/s)
+  double max_position_excess_ = 0.0;  ///< Largest excess of desired position beyond the position limits (rad)
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Fixed size record of the inverse kinematics deviation events of a single leg, accumulated by the control thread
+/// over a diagnostics reporting period without allocation or string formatting.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct LegDiagnostics
+{
+  uint32_t deviation_counts_[3] = { 0, 0, 0 };     ///< Number of cycles tip deviated beyond IK_TOLERANCE (x, y, z)
+  double max_deviations_[3] = { 0.0, 0.0, 0.0 };   ///< Largest deviation of tip from desired position (x, y, z) (m)
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class stores the state of every joint in a robot model as contiguous (structure of arrays) blocks, with the
+/// joints of each leg occupying a consecutive slice. Joint objects hold references into this store so that sweeps
+/// across the joints of a leg or of the whole robot read linear memory rather than scattered Joint objects.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class JointStateStore
+{
+public:
+  /// Constructor for joint state store. Allocates fixed size storage which is never resized, ensuring references
+  /// held by Joint objects remain valid for the lifetime of the store.
+  /// @param[in] joint_count The total number of joints to be stored
+  JointStateStore(const int& joint_count);
+
+  /// Accessor for the number of joints in the store.
+  /// @return The number of joints in the store
+  inline int getJointCount(void) const { return joint_count_; };
+
+  std::vector<double> desired_positions_;       ///< The desired angular positions of each joint
+  std::vector<double> desired_velocities_;      ///< The desired angular velocities of each joint
+  std::vector<double> desired_efforts_;         ///< The desired angular efforts of each joint
+  std::vector<double> prev_desired_positions_;  ///< The desired angular positions of each joint at previous iteration
+  std::vector<double> prev_desired_velocities_; ///< The desired angular velocities of each joint at previous iteration
+  std::vector<double> prev_desired_efforts_;    ///< The desired angular efforts of each joint at previous iteration
+  std::vector<double> current_positions_;       ///< The current positions of each joint according to hardware
+  std::vector<double> current_velocities_;      ///< The current velocities of each joint according to hardware
+  std::vector<double> current_efforts_;         ///< The current efforts of each joint according to hardware
+  std::vector<double> default_positions_;       ///< The default positions of each joint
+  std::vector<double> default_velocities_;      ///< The default velocities of each joint
+  std::vector<double> default_efforts_;         ///< The default efforts of each joint
+  std::vector<double> min_positions_;           ///< The minimum positions allowed for each joint
+  std::vector<double> max_positions_;           ///< The maximum positions allowed for each joint
+  std::vector<double> offsets_;                 ///< The position offsets applied at output of SHC for each joint
+  std::vector<double> max_angular_speeds_;      ///< The maximum angular speeds of each joint
+  std::vector<JointDiagnostics> diagnostics_;   ///< The clamping events of each joint since last diagnostics report
+
+private:
+  const int joint_count_;                       ///< The total number of joints in the store
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// This class serves as the top-level parent of each leg object and associated tip/joint/link objects. It contains data
 /// which is relevant to the robot body or the robot as a whole rather than leg dependent data.
@@ -67,6 +135,11 @@ public:
   /// @param[in] model A pointer to a existing reference robot model object
   Model(std::shared_ptr<Model> model);
 
+  /// Copy Constructor for a robot model object using given parameters in place of those of the existing Model object.
+  /// @param[in] model A pointer to a existing reference robot model object
+  /// @param[in] params The parameter data structure used by the new model (must outlive the new model)
+  Model(std::shared_ptr<Model> model, const Parameters& params);
+
   /// Accessor for leg object container.
   /// @return Pointer to leg container object
   inline LegContainer* getLegContainer(void) { return &leg_container_; };
@@ -75,6 +148,10 @@ public:
   /// @return Pointer to debug visualiser object
   inline std::shared_ptr<DebugVisualiser> getDebugVisualiser(void) { return debug_visualiser_; };
 
+  /// Accessor for the parameter data structure used by the robot model.
+  /// @return The parameter data structure used by the robot model
+  inline const Parameters& getParameters(void) { return params_; };
+
   /// Accessor for leg count (number of legs in robot model).
   /// @return Number of legs in the robot model
   inline int getLegCount(void) { return leg_count_; };
@@ -87,10 +164,22 @@ public:
   /// @return The default pose of the robot model body
   inline Pose getDefaultPose(void) { return default_pose_; };
 
+  /// Accessor for the joint state store containing the state of all joints within the robot model.
+  /// @return Pointer to the joint state store of the robot model
+  inline std::shared_ptr<JointStateStore> getJointStateStore(void) { return joint_state_store_; };
+
   /// Accessor for the time delta value which defines the period of the ros cycle.
   /// @return The time delta value which define the period of the ros cycle
   inline double getTimeDelta(void) { return time_delta_; }
 
+  /// Accessor for the worker pool used to update legs concurrently.
+  /// @return Pointer to the worker pool (NULL if legs are updated serially)
+  inline std::shared_ptr<WorkerPool> getWorkerPool(void) { return worker_pool_; };
+
+  /// Modifier for the worker pool used to update legs concurrently.
+  /// @param[in] worker_pool Pointer to the worker pool (NULL to update legs serially)
+  inline void setWorkerPool(std::shared_ptr<WorkerPool> worker_pool) { worker_pool_ = worker_pool; };
+
   /// Modifier for the current pose of the robot model body.
   /// @param[in] pose The input pose to be set as the current robot model body pose
   inline void setCurrentPose(const Pose& pose)  { current_pose_ = pose; };
@@ -126,6 +215,11 @@ public:
   /// @param[in] leg_id_name The identification name of the requested leg object pointer
   /// @return The pointer to leg requested via identification name input
   std::shared_ptr<Leg> getLegByIDName(const std::string& leg_id_name);
+
+  /// Returns the index in the joint state store of the joint requested via identification name string input.
+  /// @param[in] joint_id_name The identification name of the requested joint
+  /// @return The joint state store index of the requested joint (-1 if no joint of that name exists)
+  int getJointStateIndex(const std::string& joint_id_name);
   
   /// Accessor for imu data.
   /// @return The imu data structure of the robot model
@@ -155,11 +249,12 @@ public:
   /// Updates joint default positions for each leg according to current joint positions of each leg.
   void updateDefaultConfiguration(void);
   
-  /// Generates workspace polyhedron for each leg in model.
+  /// Generates workspace polyhedron for each leg in model. If the parallel_workspace_generation parameter is set (and
+  /// workspace debug visualisation is off) the search for each leg is run concurrently on a pool of worker threads.
   void generateWorkspaces(void);
   
   /// Updates model configuration by applying inverse kinematics to solve desired tip poses generated from walk/pose
-  /// controllers.
+  /// controllers. Legs are solved concurrently if a worker pool has been set.
   void updateModel(void);
   
   /// Estimates the acceleration vector due to gravity from pitch and roll orientations from IMU data
@@ -170,6 +265,10 @@ private:
   const Parameters& params_;                     ///< Pointer to parameter structure for storing parameter variables
   std::shared_ptr<DebugVisualiser> debug_visualiser_; ///< Pointer to debug visualiser object
   LegContainer leg_container_;                   ///< The container map for all robot model leg objects
+  std::shared_ptr<JointStateStore> joint_state_store_; ///< Contiguous store of state for all robot model joints
+  std::unordered_map<std::string, std::shared_ptr<Leg>> leg_name_index_; ///< Index of legs by identification name
+  std::unordered_map<std::string, int> joint_name_index_; ///< Index of joint state store slots by joint name
+  std::shared_ptr<WorkerPool> worker_pool_;      ///< Pool of worker threads used to update legs concurrently
   
   int leg_count_;                ///< The number of leg objects within the robot model
   double time_delta_;            ///< The time period of the ros cycle
@@ -181,18 +280,78 @@ public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 };
 
+typedef std::map<int, double> Workplane;
+typedef std::map<double, Workplane> Workspace;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class holds a compact representation of a leg workspace as a dense grid of radii, indexed by layer and
+/// bearing, with uniformly spaced layers resampled from the (non uniformly spaced) workplanes of the Workspace map.
+/// Radii at arbitrary heights and bearings are found via constant time bilinear lookup without allocation.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class WorkspaceGrid
+{
+public:
+  /// Generates the dense grid from a workspace, linearly interpolating workplanes between bounding workspace layers.
+  /// A workspace with a single workplane generates a grid of two identical layers.
+  /// @param[in] workspace The workspace from which to generate the grid
+  void generate(const Workspace& workspace);
+
+  /// Accessor for whether the grid has been generated from a non empty workspace.
+  /// @return Bool denoting if the grid is defined
+  inline bool isDefined(void) const { return !radii_.empty(); };
+
+  /// Accessor for whether a height lies between the lowest and highest layers of the grid.
+  /// @param[in] height The height from workspace origin
+  /// @return Bool denoting if the height lies within the grid
+  inline bool isWithinHeight(const double& height) const
+  {
+    return isDefined() && height >= min_height_ && height <= max_height_;
+  };
+
+  /// Bilinearly interpolates the workspace radius at the given height and bearing. Heights beyond the grid are
+  /// clamped to the lowest/highest layer and bearings are wrapped to 0-360 degrees.
+  /// @param[in] height The height from workspace origin
+  /// @param[in] bearing The bearing from the workspace origin (deg)
+  /// @return The interpolated workspace radius (zero if grid is undefined)
+  inline double getRadius(const double& height, const double& bearing) const
+  {
+    if (!isDefined())
+    {
+      return 0.0;
+    }
+    double layer = clamped((height - min_height_) / layer_spacing_, 0.0, double(layer_count_ - 1));
+    int lower_layer = std::min(int(layer), layer_count_ - 2);
+    double layer_progress = layer - lower_layer;
+    double column = std::fmod(std::fmod(bearing, 360.0) + 360.0, 360.0) / BEARING_STEP;
+    int lower_column = std::min(int(column), WORKSPACE_GRID_BEARINGS - 2);
+    double column_progress = column - lower_column;
+    const double* lower = &radii_[lower_layer * WORKSPACE_GRID_BEARINGS + lower_column];
+    const double* upper = lower + WORKSPACE_GRID_BEARINGS;
+    double lower_radius = lower[0] + (lower[1] - lower[0]) * column_progress;
+    double upper_radius = upper[0] + (upper[1] - upper[0]) * column_progress;
+    return lower_radius + (upper_radius - lower_radius) * layer_progress;
+  };
+
+private:
+  std::vector<double> radii_;  ///< Radii of each layer (lowest first) at each BEARING_STEP bearing from 0-360 degrees
+  int layer_count_ = 0;        ///< The number of layers in the grid
+  double min_height_ = 0.0;    ///< The height of the lowest layer from workspace origin
+  double max_height_ = 0.0;    ///< The height of the highest layer from workspace origin
+  double layer_spacing_ = 1.0; ///< The uniform height spacing between layers
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// This class handles data for each 'leg' object of the parent robot model and contains functions which allow the
 /// application of both forward and inverse kinematics. This class contains all child Joint, Link and Tip objects
 /// associated with the leg.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 typedef std::vector<double> state_type; // Impedance state used in admittance controller
-typedef std::map<int, double> Workplane;
-typedef std::map<double, Workplane> Workspace;
 typedef Eigen::aligned_allocator<std::pair<const int, std::shared_ptr<Joint>>> JointAlignedAllocator;
 typedef std::map<int, std::shared_ptr<Joint>, std::less<int>, JointAlignedAllocator> JointContainer;
 typedef Eigen::aligned_allocator<std::pair<const int, std::shared_ptr<Link>>> LinkAlignedAllocator;
 typedef std::map<int, std::shared_ptr<Link>, std::less<int>, LinkAlignedAllocator> LinkContainer;
+typedef Eigen::Matrix<double, 6, 1> TipDelta; // Change in tip position (first 3) and rotation (last 3)
+typedef Eigen::Matrix<double, Eigen::Dynamic, 1, Eigen::ColMajor, MAX_LEG_JOINTS, 1> JointVector; // Stack allocated
 class Leg : public std::enable_shared_from_this<Leg>
 {
 public:
@@ -219,13 +378,36 @@ public:
   /// @return The number of child joint objects of the leg
   inline int getJointCount(void) { return joint_count_; };
 
+  /// Accessor for the joint state store which holds the state of the child joint objects of this leg.
+  /// @return Pointer to the joint state store of the leg
+  inline std::shared_ptr<JointStateStore> getJointStateStore(void) { return joint_state_store_; };
+
+  /// Accessor for the index of the first child joint of this leg within the joint state store.
+  /// @return The index of the first joint of the leg within the joint state store
+  inline int getJointStateOffset(void) { return joint_state_offset_; };
+
+  /// Accessor for the inverse kinematics deviation events of this leg since diagnostics were last reset.
+  /// @return The inverse kinematics deviation events of this leg
+  inline const LegDiagnostics& getDiagnostics(void) { return diagnostics_; };
+
+  /// Resets the inverse kinematics deviation events of this leg, and the clamping events of each of its joints.
+  void resetDiagnostics(void);
+
   /// Accessor for the step coordination group of this leg.
   /// @return the step coordination group of the leg
   inline int getGroup(void) { return group_; };
   
   /// Accessor for the workspace polyhedron.
   /// @return the workspace polyhedron of the leg
-  inline Workspace getWorkspace(void) { return workspace_; };
+  inline const Workspace& getWorkspace(void) { return workspace_; };
+
+  /// Accessor for the dense grid representation of the workspace polyhedron.
+  /// @return the dense workspace grid of the leg
+  inline const WorkspaceGrid& getWorkspaceGrid(void) { return workspace_grid_; };
+
+  /// Accessor for the revision of the workspace, incremented each time the workspace is set.
+  /// @return The revision of the workspace of the leg
+  inline int getWorkspaceRevision(void) { return workspace_revision_; };
 
   /// Accessor for the cuurent state of this leg.
   /// @return The current state of the leg
@@ -315,9 +497,15 @@ public:
   /// @return The default pose of the robot body
   inline Pose getDefaultBodyPose(void) { return model_->getDefaultPose(); };
   
-  /// Modifier for the workspace of the leg.
+  /// Modifier for the workspace of the leg. Regenerates the dense workspace grid and increments the workspace revision,
+  /// invalidating walkspace contributions generated from the previous workspace.
   /// @param[in] workspace The new leg workspace
-  inline void setWorkspace(const Workspace& workspace) { workspace_ = workspace; };
+  inline void setWorkspace(const Workspace& workspace)
+  {
+    workspace_ = workspace;
+    workspace_grid_.generate(workspace_);
+    workspace_revision_++;
+  };
 
   /// Modifier for the curent state of this leg.
   /// @param[in] leg_state The new state of this leg
@@ -401,8 +589,23 @@ public:
   /// Generates workspace polyhedron for this leg by searching for kinematic limitations.
   /// @return The generated workspace object
   Workspace generateWorkspace(void);
-  
-  /// Generates interpolated workplane within workspace from given height above workspace origin.
+
+  /// Searches along the line from origin to target tip position for the kinematic limit of this leg, using a coarse
+  /// stride followed by bisection refinement to IK_TOLERANCE resolution. The leg is left at the furthest reachable
+  /// tip position found along the search line.
+  /// @param[in] origin_tip_position The reachable tip position from which the search begins
+  /// @param[in] target_tip_position The tip position at which the search ends
+  /// @return The distance from the search origin to the furthest reachable tip position along the search line
+  double searchWorkspaceLimit(const Eigen::Vector3d& origin_tip_position, const Eigen::Vector3d& target_tip_position);
+
+  /// Iteratively applies inverse kinematics (in simulation) until the tip reaches the input tip position within
+  /// IK_TOLERANCE, the solution stops converging or MAX_SEARCH_IK_ITERATIONS is reached.
+  /// @param[in] tip_position The desired tip position
+  /// @return Bool denoting if the input tip position was reached within IK_TOLERANCE
+  bool solveTipPosition(const Eigen::Vector3d& tip_position);
+  
+  /// Generates interpolated workplane within workspace from given height above workspace origin, via the dense
+  /// workspace grid.
   /// @param[in] height The desired workplane height from workspace origin
   /// @return The interpolated workplane at input height
   Workplane getWorkplane(const double& height);
@@ -452,9 +655,14 @@ public:
   inline void setDesiredTipVelocity(const Eigen::Vector3d& tip_velocity) { desired_tip_velocity_ = tip_velocity; };
   
   /// Calculates an estimate for the tip force vector acting on this leg, using the calculated state jacobian and 
-  /// values for the torque on each joint in the leg.
+  /// values for the torque on each joint in the leg. Dispatches to the kernel specialised on the joint count of the leg.
   /// @todo Implement rotation to tip frame
-  void calculateTipForce(void);
+  inline void calculateTipForce(void) { (this->*tip_force_solver_)(); };
+
+  /// Calculates an estimate for the tip force vector acting on this leg for a leg with N joints.
+  /// @see calculateTipForce
+  template <int N>
+  void calculateTipForceFixed(void);
   
   /// Checks tip force magnitude against touchdown/liftoff thresholds to instantaneously define the location of the 
   /// step plane.
@@ -462,23 +670,45 @@ public:
   
   /// Applies inverse kinematics to calculate required joint positions to achieve desired tip pose. Inverse
   /// kinematics is generated via the calculation of a jacobian for the current state of the leg, which is used as per
-  /// the Damped Least Squares method to generate a change in joint position for each joint.
+  /// the Damped Least Squares method to generate a change in joint position for each joint. Dispatches to the kernel
+  /// specialised on the joint count of the leg (selected at construction).
   /// @param[in] delta The iterative change in tip position and rotation
   /// @param[in] solve_rotation Flag denoting if IK should solve for rotation as well rather than just position
   /// @return The position delta for each joint in the model to achieve desired tip position delta. 
   /// @todo Calculate optimal DLS coefficient (this value currently works sufficiently)
-  Eigen::VectorXd solveIK(const Eigen::MatrixXd& delta, const bool& solve_rotation);
+  inline JointVector solveIK(const TipDelta& delta, const bool& solve_rotation)
+  {
+    return (this->*ik_solver_)(delta, solve_rotation);
+  };
+
+  /// Inverse kinematics kernel for a leg with N joints. Uses fixed size jacobian matrices and solves the damped
+  /// system via LDLT decomposition so no heap allocation occurs.
+  /// @see solveIK
+  template <int N>
+  JointVector solveIKFixed(const TipDelta& delta, const bool& solve_rotation);
+
+  /// Closed form inverse kinematics solver for 3 DOF legs whose femur and tibia joint axes are parallel (femur link
+  /// DH parameter 'alpha' of zero) and non-parallel to the coxa joint axis. Solves for the joint positions which place
+  /// the tip exactly at the target position, choosing the solution (of the up to four elbow/reach configurations)
+  /// closest to the current desired joint positions, preferring solutions with all joints within limits. Only valid if
+  /// selected at leg generation (see initAnalyticIK).
+  /// @param[in] target_tip_position The target tip position in the frame of the first joint of the leg
+  /// @param[out] joint_position_delta The position delta for each joint to achieve the target tip position
+  /// @return Flag denoting if the target tip position is reachable and a solution was found
+  bool solveIKAnalytic(const Eigen::Vector3d& target_tip_position, JointVector* joint_position_delta);
   
   /// Updates the joint positions of each joint in this leg based on the input vector. Clamps joint velocities and
   /// positions based on limits and calculates a ratio of proximity of joint position to limits.
   /// @param[in] delta The iterative change in joint position for each joint
   /// @param[in] simulation Flag denoting if this execution is for simulation purposes rather than normal use
   /// @return The ratio of the proximity of the joint position to it's limits (i.e. 0.0 = at limit, 1.0 = furthest away)
-  double updateJointPositions(const Eigen::VectorXd& delta, const bool& simulation);
+  double updateJointPositions(const JointVector& delta, const bool& simulation);
 
-  /// Applies inverse kinematics solution to achieve desired tip position. Clamps joint positions and velocities
-  /// within limits and applies forward kinematics to update tip position. Returns an estimate of the chance of solving
-  /// IK within thresholds on the next iteration. 0.0 denotes failure on THIS iteration.
+  /// Applies inverse kinematics solution to achieve desired tip position. The closed form solver is used for compatible
+  /// 3 DOF legs when tip rotation is unconstrained, falling back to the iterative solver if the target is unreachable.
+  /// Clamps joint positions and velocities within limits and applies forward kinematics to update tip position.
+  /// Returns an estimate of the chance of solving IK within thresholds on the next iteration. 0.0 denotes failure on
+  /// THIS iteration.
   /// @param[in] simulation Flag denoting if this execution is for simulation purposes rather than normal use
   /// @return A double between 0.0 and 1.0 which estimates the chance of solving IK within thresholds on the next 
   /// iteration. 0.0 denotes failure on THIS iteration.
@@ -491,7 +721,26 @@ public:
   /// @return Calculated new tip pose by applying forward kinematics
   Pose applyFK(const bool& set_current = true, const bool& use_actual = false);
 
+  /// Applies forward kinematics to the actual joint positions from motor outputs to calculate the actual tip pose,
+  /// without modifying the cached joint transforms (which continue to represent desired joint positions).
+  /// @return Calculated actual tip pose in the robot frame
+  Pose calculateActualTipPose(void);
+
 private:
+  /// Selects the inverse kinematics and tip force kernels specialised on the joint count of this leg.
+  void initKinematicSolvers(void);
+
+  /// Selects the closed form inverse kinematics solver if enabled and the leg is a compatible 3 DOF chain. Requires
+  /// links to have been generated.
+  void initAnalyticIK(void);
+
+  typedef JointVector (Leg::*IKSolver)(const TipDelta&, const bool&);
+  typedef void (Leg::*TipForceSolver)(void);
+  IKSolver ik_solver_;                ///< Pointer to the inverse kinematics kernel specialised on joint count
+  TipForceSolver tip_force_solver_;   ///< Pointer to the tip force estimation kernel specialised on joint count
+  bool analytic_ik_ = false;          ///< Flag denoting if the closed form 3 DOF inverse kinematics solver is used
+  LegDiagnostics diagnostics_;        ///< Inverse kinematics deviation events since diagnostics were last reset
+
   std::shared_ptr<Model> model_;     ///< A pointer to the parent robot model object
   const Parameters& params_;         ///< Pointer to parameter data structure for storing parameter variables
   JointContainer joint_container_;   ///< The container object for all child Joint objects
@@ -504,9 +753,13 @@ private:
   const int id_number_;         ///< The identification number for this leg
   const std::string id_name_;   ///< The identification name for this leg
   const int joint_count_;       ///< The number of child Joint objects associated with this leg
+  std::shared_ptr<JointStateStore> joint_state_store_; ///< The store holding the state of child Joint objects
+  int joint_state_offset_;      ///< The index of the first child Joint object within the joint state store
   LegState leg_state_;          ///< The current state of this leg
   
   Workspace workspace_;         ///< Polyhedron (planes of radii) representing workspace of this leg
+  WorkspaceGrid workspace_grid_; ///< Dense grid of workspace radii for constant time lookup
+  int workspace_revision_ = 0;   ///< Revision of the workspace, incremented each time the workspace is set
 
   ros::Publisher leg_state_publisher_;     ///< The ros publisher object that publishes state messages for this leg
   ros::Publisher asc_leg_state_publisher_; ///< The ros publisher object that publishes ASC state messages for this leg
@@ -587,15 +840,22 @@ public:
   /// Constructor for null joint object. Acts as a null joint object for use in ending kinematic chains.
   Joint(void);
 
+  /// Accessor for the index of this joint within the joint state store of the parent leg.
+  /// @return The index of this joint within the joint state store
+  inline int getStateIndex(void) const { return state_index_; };
+
   /// Returns the transformation matrix from the specified target joint of the robot model to this joint. 
   /// Target joint defaults to the origin of the kinematic chain.
   /// @param[in] target_joint_id ID number of joint object defining the target joint for the transformation
   /// @return The transformation matrix from target joint to this joint
   inline Eigen::Matrix4d getTransformFromJoint(const int& target_joint_id = 0) const
   {
-    std::shared_ptr<Joint> next_joint = reference_link_->actuating_joint_;
-    bool at_target = (target_joint_id == next_joint->id_number_);
-    return at_target ? current_transform_ : next_joint->getTransformFromJoint(target_joint_id) * current_transform_;
+    if (target_joint_id == 0)
+    {
+      return origin_transform_;
+    }
+    std::shared_ptr<Joint> target_joint = parent_leg_->getJointByIDNumber(target_joint_id);
+    return target_joint->origin_transform_inverse_ * origin_transform_;
   };
 
   /// Returns the pose of (or a pose relative to) the origin of this joint in the frame of the robot model.
@@ -603,8 +863,7 @@ public:
   /// @return The input pose transformed into the robot frame
   inline Pose getPoseRobotFrame(const Pose& joint_frame_pose = Pose::Identity()) const
   {
-    Eigen::Matrix4d transform = getTransformFromJoint();
-    return joint_frame_pose.transform(transform);
+    return joint_frame_pose.transform(origin_transform_);
   };
 
   /// Returns the pose of (or a pose relative to) the origin of the robot model in the frame of this joint.
@@ -612,40 +871,56 @@ public:
   /// @return The input pose transformed into the frame of this joint
   inline Pose getPoseJointFrame(const Pose& robot_frame_pose = Pose::Identity()) const
   {
-    Eigen::MatrixXd transform = getTransformFromJoint();
-    return robot_frame_pose.transform(transform.inverse());
+    return robot_frame_pose.transform(origin_transform_inverse_);
   };
 
+  /// Updates the cached transforms between the origin of the kinematic chain and this joint from the current
+  /// transform of this joint and the cached origin transform of the previous joint in the chain.
+  inline void updateOriginTransform(void)
+  {
+    origin_transform_ = reference_link_->actuating_joint_->origin_transform_ * current_transform_;
+    origin_transform_inverse_ = invertRigidTransform(origin_transform_);
+  };
+
+private:
+  const std::shared_ptr<JointStateStore> state_store_; ///< A pointer to the store holding the state of this joint
+  const int state_index_;                      ///< The index of this joint within the joint state store
+
+public:
   const std::shared_ptr<Leg> parent_leg_;      ///< A pointer to the parent leg object associated with this joint
   const std::shared_ptr<Link> reference_link_; ///< A pointer to the reference Link object associated with this joint
   const int id_number_;                        ///< The identification number for this joint
   const std::string id_name_;                  ///< The identification name for this joint
   Eigen::Matrix4d current_transform_;          ///< The current transformation matrix between previous joint and joint
   Eigen::Matrix4d identity_transform_;         ///< The identity transformation matrix between previous joint and joint
+  Eigen::Matrix4d origin_transform_;           ///< The cached transformation matrix between chain origin and joint
+  Eigen::Matrix4d origin_transform_inverse_;   ///< The cached transformation matrix between joint and chain origin
+  double transform_position_ = UNASSIGNED_VALUE; ///< The joint position used to generate the current transform
 
   ros::Publisher desired_position_publisher_;  ///< The ros publisher for publishing desired position values
 
-  const double min_position_ = 0.0;            ///< The minimum position allowed for this joint
-  const double max_position_ = 0.0;            ///< The maximum position allowed for this joint
-  const double offset_ = 0.0;                  ///< The position offset applied at output of SHC
+  // NOTE: The following references view into the joint state store
+  const double& min_position_;                 ///< The minimum position allowed for this joint
+  const double& max_position_;                 ///< The maximum position allowed for this joint
+  const double& offset_;                       ///< The position offset applied at output of SHC
   std::vector<double> packed_positions_ ;      ///< The defined position of this joint in a 'packed' state
   const double unpacked_position_ = 0.0;       ///< The defined position of this joint in an 'unpacked' state
-  const double max_angular_speed_ = 0.0;       ///< The maximum angular speed of this joint
+  const double& max_angular_speed_;            ///< The maximum angular speed of this joint
 
-  double desired_position_ = 0.0;      ///< The desired angular position of this joint
-  double desired_velocity_ = 0.0;      ///< The desired angular velocity of this joint
-  double desired_effort_ = 0.0;        ///< The desired angular effort of this joint
-  double prev_desired_position_ = 0.0; ///< The desired angular position of this joint at the previous iteration
-  double prev_desired_velocity_ = 0.0; ///< The desired angular velocity of this joint at the previous iteration
-  double prev_desired_effort_ = 0.0;   ///< The desired angular effort of this joint at the previous iteration
+  double& desired_position_;           ///< The desired angular position of this joint
+  double& desired_velocity_;           ///< The desired angular velocity of this joint
+  double& desired_effort_;             ///< The desired angular effort of this joint
+  double& prev_desired_position_;      ///< The desired angular position of this joint at the previous iteration
+  double& prev_desired_velocity_;      ///< The desired angular velocity of this joint at the previous iteration
+  double& prev_desired_effort_;        ///< The desired angular effort of this joint at the previous iteration
 
-  double current_position_ = UNASSIGNED_VALUE; ///< The current position of this joint according to hardware
-  double current_velocity_ = 0.0;              ///< The current velocity of this joint according to hardware
-  double current_effort_ = 0.0;                ///< The current effort of this joint according to hardware
+  double& current_position_;           ///< The current position of this joint according to hardware
+  double& current_velocity_;           ///< The current velocity of this joint according to hardware
+  double& current_effort_;             ///< The current effort of this joint according to hardware
   
-  double default_position_ = UNASSIGNED_VALUE; ///< The default position of this joint
-  double default_velocity_ = 0.0;              ///< The default velocity of this joint
-  double default_effort_ = 0.0;                ///< The default effort of this joint
+  double& default_position_;           ///< The default position of this joint
+  double& default_velocity_;           ///< The default velocity of this joint
+  double& default_effort_;             ///< The default effort of this joint
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -673,9 +948,12 @@ public:
   /// @return The transformation matrix from target joint to the tip
   inline Eigen::Matrix4d getTransformFromJoint(const int& target_joint_id = 0) const
   {
-    std::shared_ptr<Joint> next_joint = reference_link_->actuating_joint_;
-    bool at_target = (target_joint_id == next_joint->id_number_);
-    return at_target ? current_transform_ : next_joint->getTransformFromJoint(target_joint_id) * current_transform_;
+    if (target_joint_id == 0)
+    {
+      return origin_transform_;
+    }
+    std::shared_ptr<Joint> target_joint = parent_leg_->getJointByIDNumber(target_joint_id);
+    return target_joint->origin_transform_inverse_ * origin_transform_;
   };
 
   /// Returns the pose of (or a pose relative to) the origin of the tip in the frame of the robot model.
@@ -683,8 +961,7 @@ public:
   /// @return The input pose transformed into the robot frame
   inline Pose getPoseRobotFrame(const Pose& tip_frame_pose = Pose::Identity()) const
   {
-    Eigen::Matrix4d transform = getTransformFromJoint();
-    return tip_frame_pose.transform(transform);
+    return tip_frame_pose.transform(origin_transform_);
   };
   
   /// Returns the pose of (or a pose relative to) the origin of the robot model in the frame of the tip.
@@ -692,8 +969,15 @@ public:
   /// @return The input pose transformed into the tip frame
   inline Pose getPoseTipFrame(const Pose& robot_frame_pose = Pose::Identity()) const
   {
-    Eigen::Matrix4d transform = getTransformFromJoint();
-    return robot_frame_pose.transform(transform.inverse());
+    return robot_frame_pose.transform(origin_transform_inverse_);
+  };
+
+  /// Updates the cached transforms between the origin of the kinematic chain and the tip from the current
+  /// transform of the tip and the cached origin transform of the final joint in the chain.
+  inline void updateOriginTransform(void)
+  {
+    origin_transform_ = reference_link_->actuating_joint_->origin_transform_ * current_transform_;
+    origin_transform_inverse_ = invertRigidTransform(origin_transform_);
   };
 
   const std::shared_ptr<Leg> parent_leg_;      ///< A pointer to the parent leg object associated with the tip
@@ -701,6 +985,9 @@ public:
   const std::string id_name_;                  ///< The identification name for the tip
   Eigen::Matrix4d current_transform_;          ///< The current transformation matrix between previous joint and tip
   Eigen::Matrix4d identity_transform_;         ///< The identity transformation matrix between previous joint and tip
+  Eigen::Matrix4d origin_transform_;           ///< The cached transformation matrix between chain origin and tip
+  Eigen::Matrix4d origin_transform_inverse_;   ///< The cached transformation matrix between tip and chain origin
+  double transform_position_ = UNASSIGNED_VALUE; ///< The joint position used to generate the current transform
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
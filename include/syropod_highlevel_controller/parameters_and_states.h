@@ -284,6 +284,18 @@ struct Parameters
   // Motor Interface parameters
   Parameter<bool> individual_control_interface;   ///< Flag requesting the individual desired joint position format
   Parameter<bool> combined_control_interface;     ///< Flag requesting the combined desired joint position format
+  Parameter<bool> threaded_telemetry;             ///< Flag requesting telemetry topics be published on own thread
+  Parameter<bool> threaded_callbacks;             ///< Flag requesting sensor input callbacks be serviced on own thread
+  Parameter<double> odom_check_period;            ///< Period between checks of tf tree for odom frame (sec)
+  Parameter<double> frame_transform_refresh_period; ///< Max period between publishing unchanged joint/tip frames (sec)
+  Parameter<std::map<std::string, int>> telemetry_rate_divisors; ///< Map of control rate divisors for telemetry topics
+  Parameter<bool> timing_profiler;                ///< Flag requesting control loop timing statistics be recorded
+  Parameter<double> timing_publish_rate;          ///< Rate at which control loop timing statistics are published
+  Parameter<bool> flight_recorder;                ///< Flag requesting per cycle controller state be flight recorded
+  Parameter<int> flight_recorder_length;          ///< Number of most recent control cycles held by flight recorder
+  Parameter<bool> real_time_mode;                 ///< Flag requesting control loop be executed in real time mode
+  Parameter<int> real_time_core;                  ///< Processor core to which control thread is pinned (-1 for none)
+  Parameter<int> real_time_priority;              ///< SCHED_FIFO priority of control thread in real time mode
 
   // Model parameters
   Parameter<std::string> syropod_type;             ///< The type of the robot described by these parameters
@@ -294,6 +306,13 @@ struct Parameters
   Parameter<bool> clamp_joint_positions;           ///< A bool denoting if joint position limits are adhered to
   Parameter<bool> clamp_joint_velocities;          ///< A bool denoting if joint velocity limits are adhered to
   Parameter<bool> ignore_IK_warnings;              ///< A bool denoting if IK deviation warnings are displayed to user
+  Parameter<double> IK_diagnostics_period;         ///< Period between reports of IK clamping/deviation events (sec)
+  Parameter<bool> analytic_IK;                     ///< A bool denoting if closed form IK is used for 3 DOF legs
+  Parameter<bool> parallel_workspace_generation;   ///< A bool denoting if leg workspaces are generated concurrently
+  Parameter<bool> parallel_leg_updates;            ///< A bool denoting if per leg IK/stepper updates run concurrently
+  Parameter<int> leg_worker_threads;               ///< Number of worker threads used for concurrent leg updates
+  Parameter<std::string> workspace_generation_method; ///< String denoting the workspace limit search method
+  Parameter<bool> use_workspace_cache;             ///< A bool denoting if generated workspaces are cached on disk
 
   Parameter<std::map<std::string, double>> joint_parameters[8][6]; ///< Array of maps of joint parameter names & values*
   Parameter<std::map<std::string, double>> link_parameters[8][7];  ///< Array of maps of link parameter names & values*
@@ -317,6 +336,7 @@ struct Parameters
   Parameter<bool> gravity_aligned_tips;             ///< Flag denoting if tip should align with gravity direction
   Parameter<double> touchdown_threshold;            ///< Threshold of tip force before touchdown is recognized
   Parameter<double> liftoff_threshold;              ///< Threshold of tip force before liftoff is recognized
+  Parameter<std::vector<double>> odometry_prediction_horizons; ///< Time horizons of cached odometry predictions (sec)
   Parameter<std::map<std::string, double>> linear_cruise_velocity;  ///< Set values used in cruise control mode if used
   Parameter<std::map<std::string, double>> leg_stance_positions[8]; ///< Array of maps of default tip stance positions
 
@@ -324,6 +344,7 @@ struct Parameters
   Parameter<std::string> auto_pose_type;             ///< String denoting the default auto posing cycle type
   Parameter<bool> start_up_sequence;                 ///< Flag allowing execution of start up and shutdown sequences
   Parameter<double> time_to_start;                   ///< The time to complete a direct start up
+  Parameter<bool> plan_transition_sequence;          ///< Flag denoting if start up sequences are planned in advance
   
   Parameter<std::map<std::string, double>> rotation_pid_gains; ///< PID gains used in imu based automatic posing
   Parameter<std::map<std::string, double>> max_translation;    ///< The maximum allowable linear translation positions
@@ -375,6 +396,10 @@ struct Parameters
   Parameter<bool> debug_workspace_calc;      ///< Flag determining if workspace calculations output debug info
   Parameter<bool> debug_IK;                  ///< Flag determining if inverse kinematics engine outputs debug info
   Parameter<bool> debug_rviz;                ///< Flag determining if visualisation markers are output for debugging
+  Parameter<std::map<std::string, int>> debug_rviz_rate_divisors; ///< Map of control rate divisors for marker layers
+  Parameter<bool> headless_simulation;       ///< Flag determining if controller runs in headless lockstep simulation
+  Parameter<double> simulation_duration;     ///< Simulated time after which headless simulation ends (0.0 = unlimited)
+  Parameter<std::vector<double>> simulation_velocity; ///< Body velocity input applied during headless simulation
 
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -26,6 +26,15 @@
 
 class AutoPoser;
 
+typedef std::vector<Pose, Eigen::aligned_allocator<Pose>> TransitionPoses;
+
+/// Struct storing a start up/shut down transition sequence planned in simulation for a stance configuration.
+struct TransitionSequence
+{
+  int transition_step_count_ = 0;                   ///< Total number of transition steps in the sequence
+  std::map<int, TransitionPoses> transition_poses_; ///< Transition tip poses of each leg keyed by leg id number
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// This class has two purposes. One is to manage functions which iteratively execute robot leg posing sequences, both
 /// via direct joint control, and via tip position control and inverse kinematics (IK). Such sequences include the
@@ -47,6 +56,12 @@ public:
   /// @param[in] params Pointer to the parameter struct object
   PoseController(std::shared_ptr<Model> model, const Parameters &params);
 
+  /// PoseController class constructor taking ownership of its parameters, used by sequence planning controllers so
+  /// that parameters are not modified (e.g. by dynamic reconfigure) whilst planning on another thread.
+  /// @param[in] model Pointer to the robot model class object
+  /// @param[in] params Pointer to the parameter struct object owned by this controller
+  PoseController(std::shared_ptr<Model> model, std::shared_ptr<const Parameters> params);
+
   /// Accessor for pose reset mode.
   /// @return The pose reset mode (Mode for controlling which posing axes to reset to zero)
   inline PoseResetMode getPoseResetMode(void) { return pose_reset_mode_; };
@@ -63,6 +78,30 @@ public:
   /// @return Cyclical custom automatic body pose, a component of total applied body pose
   inline Pose getAutoPose(void) { return auto_pose_; };
 
+  /// Accessor for manual pose.
+  /// @return User controlled manual body pose, a component of total applied body pose
+  inline Pose getManualPose(void) { return manual_pose_; };
+
+  /// Accessor for imu pose.
+  /// @return IMU feedback based automatic body pose, a component of total applied body pose
+  inline Pose getIMUPose(void) { return imu_pose_; };
+
+  /// Accessor for inclination pose.
+  /// @return Pose to improve stability on inclined terrain, a component of total applied body pose
+  inline Pose getInclinationPose(void) { return inclination_pose_; };
+
+  /// Accessor for admittance pose.
+  /// @return Pose to correct admittance control based sagging, a component of total applied body pose
+  inline Pose getAdmittancePose(void) { return admittance_pose_; };
+
+  /// Accessor for walk plane pose.
+  /// @return Pose used to align robot body parallel with walk plane and normal at clearance
+  inline Pose getWalkPlanePose(void) { return walk_plane_pose_; };
+
+  /// Accessor for tip align pose.
+  /// @return Pose used to align final links of legs vertically during 2nd half of swing
+  inline Pose getTipAlignPose(void) { return tip_align_pose_; };
+
   /// Accessor for pose phase length.
   /// @return The phase length of the auto posing cycle
   inline int getPhaseLength(void) { return pose_phase_length_; };
@@ -158,13 +197,34 @@ public:
 
   /// Executes saved transition sequence in direction defined by 'sequence' (START_UP or SHUT_DOWN) through the use of
   /// the function StepToPosition() to move to pre-defined tip positions for each leg in the robot model. If no sequence
-  /// exists for target stance, it generates one iteratively by checking workspace limitations.
+  /// exists for target stance, it uses one planned in advance (see planSequence) or generates one iteratively by
+  /// checking workspace limitations.
   /// @param[in] sequence The requested sequence - either START_UP or SHUT_DOWN
   /// @return Returns an int from 0 to 100 signifying the progress of the sequence (100 meaning 100% complete)
   /// @see parameters_and_states.h (for SequenceSelection definition)
   /// @todo Make sequential leg stepping coordination an option instead of only simultaneous (direct) & groups (tripod)
   int executeSequence(const SequenceSelection &sequence);
 
+  /// Generates a key identifying the stance configuration (initial tip positions, default tip positions and current
+  /// body pose) for which a transition sequence is generated. The key is only rebuilt if the stance has changed.
+  /// @return The string key identifying the current stance configuration
+  const std::string& generateSequenceKey(void);
+
+  /// Collects any completed sequence planning results and, if the saved transition sequence requires regeneration
+  /// and no sequence has been planned for the current stance configuration, starts planning a start up sequence in a
+  /// background thread. The sequence is planned in simulation on a copy of the robot model, starting from the current
+  /// tip poses, using the iterative sequence generation of executeSequence().
+  void planSequence(void);
+
+  /// Iteratively executes a start up sequence on the robot model of this controller until complete, generating the
+  /// transition sequence. Used by the sequence planner on a copy of the robot model.
+  /// @return Bool denoting if the sequence was successfully generated
+  bool generateSequence(void);
+
+  /// Sets the transition sequence of each Leg Poser from the sequence planned for the current stance configuration.
+  /// @return Bool denoting if a planned sequence exists for the current stance configuration
+  bool loadPlannedSequence(void);
+
   /// Iterates through legs in robot model and, in simulation, moves them in a linear trajectory directly from
   /// their current tip position to its default tip position (as defined by the walk controller). The joint states for
   /// each leg are saved for the deafult tip position and then the joint moved inpdependently from initial position to
@@ -261,6 +321,7 @@ public:
   void calculateDefaultPose(void);
 
 private:
+  std::shared_ptr<const Parameters> owned_params_; ///< Parameters owned by this controller (sequence planners only)
   std::shared_ptr<Model> model_; ///< Pointer to robot model object
   const Parameters &params_;     ///< Pointer to parameter data structure for storing parameter variables
 
@@ -302,6 +363,17 @@ private:
   bool vertical_transition_complete_ = false;   ///< Flags if the vertical transition has completed without error
   bool first_sequence_execution_ = true;        ///< Flags if the controller has executed its first sequence
   bool reset_transition_sequence_ = true;       ///< Flags if the saved transition sequence needs to be regenerated
+  bool sequence_planner_ = false;               ///< Flags if this controller plans sequences on a model copy
+
+  std::shared_ptr<PoseController> sequence_planning_poser_;         ///< Pose controller of in progress planning
+  std::future<bool> sequence_planning_;                             ///< Result of in progress sequence planning
+  std::string sequence_planning_key_;                               ///< Stance key of in progress sequence planning
+  std::vector<double> sequence_stance_;                             ///< Stance configuration of current key request
+  std::vector<double> sequence_key_stance_;                         ///< Stance configuration of last generated key
+  std::string sequence_key_;                                        ///< Last generated stance key
+  std::string planned_sequence_key_;                                ///< Stance key of latest planned sequence
+  TransitionSequence planned_sequence_;                             ///< Latest planned sequence
+  std::string failed_sequence_key_;                                 ///< Stance key of latest failed sequence planning
 
   std::vector<double> default_joint_positions_[8]; ///< Joint positions for default stance used in Direct Startup
 
@@ -518,6 +590,10 @@ public:
   /// @return The transition tip pose of the requested index
   inline Pose getTransitionPose(const int &index) { return transition_poses_[index]; }
 
+  /// Accessor for the transition sequence of tip poses.
+  /// @return The vector of transition tip poses
+  inline const TransitionPoses &getTransitionSequence(void) { return transition_poses_; };
+
   /// Returns true if the transition pose, of the requested index, exists.
   /// @param[in] index The index of the transition pose for checking existence
   /// @return Flag denoting whether the transition pose of the requested index exists
@@ -588,7 +664,7 @@ private:
   Pose target_tip_pose_;                    ///< Target tip pose used in bezier curve equations
   ExternalTarget external_target_;          ///< Externally set target tip pose object
 
-  std::vector<Pose, Eigen::aligned_allocator<Pose>> transition_poses_; ///< Vector of transition target tip poses
+  TransitionPoses transition_poses_;        ///< Vector of transition target tip poses
 
   bool leg_completed_step_ = false; ///< Flag denoting if leg has completed its required step in a sequence
 
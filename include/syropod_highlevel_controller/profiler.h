@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_PROFILER_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_PROFILER_H
+
+#include "standard_includes.h"
+#include <syropod_highlevel_controller/TimingState.h>
+
+#include <chrono>
+#include <iomanip>
+
+#define TIMING_HISTOGRAM_MINIMUM 1.0e-6     ///< Lower bound of the first timing histogram bucket (sec)
+#define TIMING_BUCKETS_PER_DECADE 16        ///< Number of logarithmically spaced histogram buckets per decade
+#define TIMING_HISTOGRAM_BUCKET_COUNT 128   ///< Number of timing histogram buckets (spans 1us to 100s)
+#define TIMING_PERCENTILE 0.99              ///< Percentile reported for each timing stage
+
+/// Enum designating control loop stages instrumented by the timing profiler.
+enum TimingStage
+{
+  CONTROL_CYCLE_TIMING,
+  CONTROL_LOOP_TIMING,
+  UPDATE_CURRENT_POSE_TIMING,
+  UPDATE_ADMITTANCE_TIMING,
+  UPDATE_WALK_TIMING,
+  UPDATE_STANCE_TIMING,
+  UPDATE_MODEL_TIMING,
+  PUBLISH_LEG_STATE_TIMING,
+  PUBLISH_VELOCITY_TIMING,
+  PUBLISH_POSE_TIMING,
+  PUBLISH_WALKSPACE_TIMING,
+  PUBLISH_ROTATION_POSE_ERROR_TIMING,
+  PUBLISH_FRAME_TRANSFORMS_TIMING,
+  UPDATE_TELEMETRY_TIMING,
+  RVIZ_DEBUGGING_TIMING,
+  PUBLISH_DESIRED_JOINT_STATE_TIMING,
+  WAKEUP_JITTER_TIMING,
+  TIMING_STAGE_COUNT, // Misc enum defining number of Timing Stages
+};
+
+/// Struct accumulating duration statistics and a logarithmic duration histogram for a single timing stage.
+struct TimingStatistics
+{
+  /// Adds a duration sample to the statistics.
+  /// @param[in] duration The sampled duration (sec)
+  void addSample(const double& duration);
+
+  /// Estimates the given percentile of sampled durations from the histogram.
+  /// @param[in] percentile The percentile (0.0 -> 1.0) to estimate
+  /// @return The upper bound of the histogram bucket containing the percentile (sec)
+  double getPercentile(const double& percentile) const;
+
+  /// Accessor for the mean sampled duration.
+  /// @return The mean of all sampled durations (sec)
+  inline double getMean(void) const { return count_ > 0 ? sum_ / count_ : 0.0; };
+
+  uint64_t count_ = 0;                                   ///< Number of duration samples
+  double sum_ = 0.0;                                     ///< Sum of sampled durations (sec)
+  double min_ = 0.0;                                     ///< Minimum sampled duration (sec)
+  double max_ = 0.0;                                     ///< Maximum sampled duration (sec)
+  uint32_t histogram_[TIMING_HISTOGRAM_BUCKET_COUNT] = {}; ///< Logarithmically spaced histogram of sampled durations
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class records durations of instrumented stages of the control loop, counts control cycles which overrun the
+/// control period and generates timing summaries for publishing and logging. All sampling occurs on the control thread.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class Profiler
+{
+public:
+  /// Constructor for profiler object.
+  /// @param[in] enabled Flag denoting if timing samples are recorded
+  /// @param[in] period The control period against which control cycle overruns are counted (sec)
+  Profiler(const bool& enabled, const double& period);
+
+  /// Accessor for the enabled state of the profiler.
+  /// @return Flag denoting if timing samples are recorded
+  inline bool isEnabled(void) const { return enabled_; };
+
+  /// Accessor for the count of control cycles which exceeded the control period.
+  /// @return The number of overrun control cycles
+  inline uint64_t getOverrunCount(void) const { return overrun_count_; };
+
+  /// Accessor for the statistics of a timing stage.
+  /// @param[in] stage The timing stage
+  /// @return The accumulated timing statistics for the stage
+  inline const TimingStatistics& getStatistics(const TimingStage& stage) const { return statistics_[stage]; };
+
+  /// Adds a duration sample to the statistics of a timing stage. Control cycle samples exceeding the control period
+  /// are counted as overruns.
+  /// @param[in] stage The timing stage sampled
+  /// @param[in] duration The sampled duration (sec)
+  void addSample(const TimingStage& stage, const double& duration);
+
+  /// Generates a timing state message summarising the statistics of all sampled timing stages.
+  /// @param[out] msg The timing state message to populate
+  void generateTimingMsg(syropod_highlevel_controller::TimingState* msg) const;
+
+  /// Logs a table summarising the statistics of all sampled timing stages.
+  void dump(void) const;
+
+  /// Accessor for the name of a timing stage.
+  /// @param[in] stage The timing stage
+  /// @return The name of the timing stage
+  static std::string getStageName(const TimingStage& stage);
+
+private:
+  bool enabled_;                                        ///< Flag denoting if timing samples are recorded
+  double period_;                                       ///< Control period against which overruns are counted (sec)
+  uint64_t overrun_count_ = 0;                          ///< Number of control cycles exceeding the control period
+  TimingStatistics statistics_[TIMING_STAGE_COUNT];     ///< Accumulated statistics for each timing stage
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class times the duration of its own scope and adds it as a sample of a timing stage to the given profiler on
+/// destruction. The clock is not read if the profiler is disabled.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class ScopedTimer
+{
+public:
+  /// Constructor for scoped timer. Records start time of the timed scope if the profiler is enabled.
+  /// @param[in] profiler A pointer to the profiler to which the sample is added
+  /// @param[in] stage The timing stage sampled
+  inline ScopedTimer(Profiler* profiler, const TimingStage& stage)
+    : profiler_(profiler->isEnabled() ? profiler : NULL)
+    , stage_(stage)
+  {
+    if (profiler_)
+    {
+      start_ = std::chrono::steady_clock::now();
+    }
+  };
+
+  /// Destructor for scoped timer. Adds the duration of the timed scope to the profiler if enabled.
+  inline ~ScopedTimer(void)
+  {
+    if (profiler_)
+    {
+      std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_;
+      profiler_->addSample(stage_, duration.count());
+    }
+  };
+
+private:
+  Profiler* profiler_;                               ///< Pointer to profiler (NULL if profiler disabled)
+  TimingStage stage_;                                ///< The timing stage sampled
+  std::chrono::steady_clock::time_point start_;      ///< The start time of the timed scope
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_PROFILER_H
@@ -0,0 +1,57 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_REAL_TIME_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_REAL_TIME_H
+
+#include "standard_includes.h"
+
+#include <time.h>
+
+#define REAL_TIME_HEAP_PREFAULT_SIZE (32 * 1024 * 1024) ///< Size of heap prefaulted on entering real time mode (bytes)
+#define REAL_TIME_STACK_PREFAULT_SIZE (256 * 1024)      ///< Size of stack prefaulted on entering real time mode (bytes)
+
+/// Configures the calling thread for real time execution of the control loop. Locks all current and future memory
+/// pages of the process, prefaults the heap and stack, pins the calling thread to the given processor core and sets
+/// its scheduling policy to SCHED_FIFO at the given priority. Each step which fails (e.g. due to insufficient
+/// privileges) is reported and skipped rather than aborting.
+/// @param[in] core The processor core to which the calling thread is pinned (not pinned if negative)
+/// @param[in] priority The SCHED_FIFO real time priority of the calling thread (1 -> 99)
+/// @return Bool denoting if all real time configuration steps succeeded
+bool initRealTime(const int& core, const int& priority);
+
+/// Reverts the calling thread to non real time execution by setting its scheduling policy to SCHED_OTHER and allowing
+/// it to run on any processor core. Called first by helper threads started from the real time control thread, which
+/// would otherwise inherit its SCHED_FIFO priority and core and so be unable to be preempted by it.
+void resetRealTime(void);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class maintains a fixed control rate by sleeping until absolute deadlines on the monotonic clock, preventing
+/// the accumulation of drift from loop execution time and wake up latency inherent in relative sleeps. Used in place
+/// of ros::Rate in real time mode.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class RealTimeRate
+{
+public:
+  /// Constructor for real time rate. The first deadline is one period after construction.
+  /// @param[in] period The period of the rate (sec)
+  RealTimeRate(const double& period);
+
+  /// Sleeps until the next deadline. If the deadline has already passed by over a period (i.e. the loop has overrun)
+  /// the deadlines are reset relative to the current time rather than attempting to catch up on missed cycles.
+  /// @return The wake up jitter (the time by which wake up lagged the deadline) (sec)
+  double sleep(void);
+
+private:
+  int64_t period_;   ///< The period of the rate (nsec)
+  int64_t deadline_; ///< The next absolute deadline on the monotonic clock (nsec)
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_REAL_TIME_H
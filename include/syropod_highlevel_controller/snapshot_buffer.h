@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_SNAPSHOT_BUFFER_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_SNAPSHOT_BUFFER_H
+
+#include "standard_includes.h"
+
+#define SNAPSHOT_INDEX_MASK 0x3 ///< Mask of the buffer index within the shared snapshot slot
+#define SNAPSHOT_FRESH_FLAG 0x4 ///< Flag within the shared snapshot slot denoting unread data
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class implements a lock-free snapshot buffer for passing the latest state from a single writer thread to a
+/// single reader thread. Three buffers are rotated such that the writer always owns a 'back' buffer, the reader always
+/// owns a 'front' buffer and a third 'middle' buffer is exchanged atomically between them. Neither thread ever blocks
+/// and the reader always receives the most recent complete snapshot (intermediate snapshots may be skipped).
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class T>
+class SnapshotBuffer
+{
+public:
+  /// Constructor for snapshot buffer. Initialises all buffers as copies of the given initial snapshot, allowing
+  /// snapshot storage to be preallocated.
+  /// @param[in] initial The initial snapshot value
+  SnapshotBuffer(const T& initial = T())
+    : buffers_{ initial, initial, initial }
+    , back_(0)
+    , middle_(1)
+    , front_(2)
+  {
+  };
+
+  /// Accessor for the back buffer owned by the writer thread.
+  /// @return Reference to the back buffer in which the writer generates the next snapshot
+  inline T& getBack(void) { return buffers_[back_]; };
+
+  /// Commits the back buffer as the latest snapshot, making it available to the reader. The writer receives the
+  /// previous middle buffer as its new back buffer (which may contain stale data).
+  /// @return Flag denoting if the previous snapshot was replaced before the reader acquired it, in which case the new
+  /// back buffer holds that dropped snapshot
+  inline bool commit(void)
+  {
+    int previous = middle_.exchange(back_ | SNAPSHOT_FRESH_FLAG, std::memory_order_acq_rel);
+    back_ = previous & SNAPSHOT_INDEX_MASK;
+    return previous & SNAPSHOT_FRESH_FLAG;
+  };
+
+  /// Acquires the latest committed snapshot as the front buffer if one has been committed since the last update.
+  /// @return Flag denoting if a new snapshot has been acquired
+  inline bool update(void)
+  {
+    if (!(middle_.load(std::memory_order_relaxed) & SNAPSHOT_FRESH_FLAG))
+    {
+      return false;
+    }
+    front_ = middle_.exchange(front_, std::memory_order_acq_rel) & SNAPSHOT_INDEX_MASK;
+    return true;
+  };
+
+  /// Accessor for the front buffer owned by the reader thread.
+  /// @return Reference to the latest snapshot acquired by the reader
+  inline const T& getFront(void) { return buffers_[front_]; };
+
+private:
+  T buffers_[3];            ///< The three rotating snapshot buffers
+  int back_;                ///< The index of the buffer owned by the writer thread
+  std::atomic<int> middle_; ///< The index (and fresh flag) of the buffer exchanged between threads
+  int front_;               ///< The index of the buffer owned by the reader thread
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_SNAPSHOT_BUFFER_H
@@ -13,6 +13,7 @@
 #include <ros/console.h>
 #include <ros/assert.h>
 #include <ros/exceptions.h>
+#include <ros/callback_queue.h>
 
 #include <dynamic_reconfigure/server.h>
 
@@ -48,6 +49,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <memory>
+#include <array>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <unordered_map>
 
 #define UNASSIGNED_VALUE double(INT_MAX) ///< Value used to determine if variable has been assigned
 #define PROGRESS_COMPLETE 100            ///< Value denoting 100% and a completion of progress of various functions
@@ -314,6 +320,21 @@ inline std::string stringFormat(const std::string &format, Args... args)
   return std::string(buf.get(), buf.get() + size - 1); // We don't want the '\0' inside
 }
 
+/// Returns the path of the ROS home directory ($ROS_HOME, defaulting to ~/.ros) under which generated files are stored.
+/// @return The path of the ROS home directory
+inline std::string getROSHomePath(void)
+{
+  if (getenv("ROS_HOME"))
+  {
+    return getenv("ROS_HOME");
+  }
+  else if (getenv("HOME"))
+  {
+    return std::string(getenv("HOME")) + "/.ros";
+  }
+  return ".";
+}
+
 ///  Returns a vector representing a 3d point at a given time input along a 2nd order bezier curve defined by input
 ///  control nodes.
 ///  @param[in] points An array of control node vectors.
@@ -419,6 +440,35 @@ inline T quarticBezierDot(const T* points, const double& t)
           12.0 * s * t * t * (points[3] - points[2]) + 4.0 * t * t * t * (points[4] - points[3]));
 }
 
+/// Generates the Bernstein basis weights of each control node for the derivative of a 4th order bezier curve at a
+/// given time input, scaled by a given factor. The weights depend only on the time input and may be precomputed such
+/// that the (scaled) derivative for any control nodes is given by bezierWeightedSum().
+/// @param[in] t A time input from 0.0 to 1.0
+/// @param[in] scaler A factor by which all weights are scaled
+/// @return The array of weights for each of the 5 control nodes
+inline std::array<double, 5> quarticBezierDotWeights(const double& t, const double& scaler = 1.0)
+{
+  double s = 1.0 - t;
+  std::array<double, 5> weights;
+  weights[0] = scaler * (-4.0 * s * s * s);
+  weights[1] = scaler * (4.0 * s * s * s - 12.0 * s * s * t);
+  weights[2] = scaler * (12.0 * s * s * t - 12.0 * s * t * t);
+  weights[3] = scaler * (12.0 * s * t * t - 4.0 * t * t * t);
+  weights[4] = scaler * (4.0 * t * t * t);
+  return weights;
+}
+
+/// Returns the sum of 4th order bezier curve control nodes each multiplied by a precomputed basis weight.
+/// @param[in] points An array of control node vectors
+/// @param[in] weights The array of basis weights for each control node (see quarticBezierDotWeights())
+/// @return Vector representation generated using the given input array of control node vectors and weights
+template <class T>
+inline T bezierWeightedSum(const T* points, const std::array<double, 5>& weights)
+{
+  return points[0] * weights[0] + points[1] * weights[1] + points[2] * weights[2] +
+         points[3] * weights[3] + points[4] * weights[4];
+}
+
 /// Returns a vector representing a 3d point at a given time input along a 4th order bezier curve defined by input
 /// control nodes. Depending on the complexity of the target curve, it will generate points that will pass through
 /// the defined control points. If the target curve is too complex the generate point will approximately go near
@@ -473,6 +523,18 @@ inline Eigen::Matrix4d createDHMatrix(const double& d, const double& theta, cons
   return m;
 }
 
+/// Inverts a rigid body homogeneous transformation matrix (such as a DH matrix) using the transpose of the rotation
+/// component, avoiding a general 4x4 matrix inverse.
+/// @param[in] transform The rigid body transformation matrix to be inverted
+/// @return The inverse of the input transformation matrix
+inline Eigen::Matrix4d invertRigidTransform(const Eigen::Matrix4d& transform)
+{
+  Eigen::Matrix4d inverse = Eigen::Matrix4d::Identity();
+  inverse.block<3, 3>(0, 0) = transform.block<3, 3>(0, 0).transpose();
+  inverse.block<3, 1>(0, 3) = -inverse.block<3, 3>(0, 0) * transform.block<3, 1>(0, 3);
+  return inverse;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #endif // SYROPOD_HIGHLEVEL_CONTROLLER_STANDARD_INCLUDES_H
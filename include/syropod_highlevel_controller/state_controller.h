@@ -22,9 +22,64 @@
 
 #include "debug_visualiser.h"
 #include "admittance_controller.h"
+#include "workspace_cache.h"
+#include "flight_recorder.h"
+#include "ik_diagnostics.h"
+#include "snapshot_buffer.h"
+#include "profiler.h"
 
 #define MAX_MANUAL_LEGS 2 ///< Maximum number of legs able to be manually manipulated simultaneously
 #define PACK_TIME 2.0     ///< Joint transition time during pack/unpack sequences (seconds @ step frequency == 1.0)
+#define FRAME_TRANSFORM_TOLERANCE 1.0e-6 ///< Change in frame transform components below which frame is unchanged
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Enum designating telemetry topics which may be published from the telemetry thread.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+enum TelemetryTopic
+{
+  LEG_STATE_TELEMETRY,           ///< Leg state messages (/shc/*LEG_ID*/state)
+  VELOCITY_TELEMETRY,            ///< Desired body velocity message (/shc/velocity)
+  POSE_TELEMETRY,                ///< Current body pose message (/shc/pose)
+  WALKSPACE_TELEMETRY,           ///< Walkspace message (/shc/walkspace)
+  ROTATION_POSE_ERROR_TELEMETRY, ///< Rotation pose error message (/shc/rotation_pose_error)
+  FRAME_TRANSFORMS_TELEMETRY,    ///< Frame transforms (/tf)
+  TELEMETRY_TOPIC_COUNT,         ///< Misc enum defining number of Telemetry Topics
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Snapshot of telemetry messages generated on the control thread for publishing from the telemetry thread.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct TelemetrySnapshot
+{
+  bool due_[TELEMETRY_TOPIC_COUNT];                                      ///< Flags denoting topics to be published
+  std::vector<syropod_highlevel_controller::LegState> leg_states_;      ///< Leg state messages for each leg
+  geometry_msgs::Twist velocity_;                                        ///< Desired body velocity message
+  geometry_msgs::Twist pose_;                                            ///< Current body pose message
+  std_msgs::Float32MultiArray walkspace_;                                ///< Walkspace message
+  std_msgs::Float32MultiArray rotation_pose_error_;                      ///< Rotation pose error message
+  std::vector<geometry_msgs::TransformStamped> frame_transforms_;        ///< Frame transforms to be broadcast
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Latest values of sensor and velocity inputs staged by the input callback thread for application at the start of
+/// each control cycle. Each input carries a count of received messages so that inputs are only applied once.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct StagedInputs
+{
+  std::vector<double> joint_positions_;          ///< Latest position (minus offset) of each joint state store slot
+  std::vector<double> joint_velocities_;         ///< Latest velocity of each joint state store slot
+  std::vector<double> joint_efforts_;            ///< Latest effort of each joint state store slot
+  std::vector<char> joint_position_received_;    ///< Flags denoting if a position was received for each slot
+  std::vector<char> joint_velocity_received_;    ///< Flags denoting if a velocity was received for each slot
+  std::vector<char> joint_effort_received_;      ///< Flags denoting if an effort was received for each slot
+  sensor_msgs::Imu imu_;                         ///< Latest imu data message
+  syropod_highlevel_controller::TipState tip_states_; ///< Latest tip state message
+  geometry_msgs::Twist velocity_;                ///< Latest desired body velocity message
+  long joint_states_count_ = 0;                  ///< Number of joint state messages received
+  long imu_count_ = 0;                           ///< Number of imu data messages received
+  long tip_states_count_ = 0;                    ///< Number of tip state messages received
+  long velocity_count_ = 0;                      ///< Number of desired body velocity messages received
+};
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// This class creates and initialises all ros publishers/subscriptions; sub-controllers: Walk Controller,
@@ -42,7 +97,9 @@ class StateController
 public:
   /// StateController class constructor. Initialises parameters, creates robot model object, sets up ros topic
   /// subscriptions and advertisments.
-  StateController(void);
+  /// @param[in] callback_queue Callback queue servicing controller subscriptions (global callback queue if NULL)
+  /// @param[in] private_namespace Namespace of the dynamic reconfigure server
+  StateController(ros::CallbackQueue* callback_queue = NULL, const std::string& private_namespace = "~");
 
   /// StateController object destructor.
   ~StateController(void);
@@ -51,10 +108,35 @@ public:
   /// @return Parameter data structure which contains parameter variables
   inline const Parameters& getParameters(void) { return params_; };
 
+  /// Accessor for the callback queue servicing controller subscriptions.
+  /// @return Pointer to the callback queue servicing controller subscriptions
+  inline ros::CallbackQueue* getCallbackQueue(void) { return callback_queue_; };
+
+  /// Modifier for intra process publishing. When enabled the combined desired joint state is published by shared
+  /// pointer so subscribers in the same process (e.g. hardware driver nodelets) receive it without serialisation.
+  /// @param[in] intra_process Bool denoting if desired joint states are published by shared pointer
+  inline void setIntraProcess(const bool& intra_process) { intra_process_ = intra_process; };
+
+  /// Accessor for control loop timing profiler.
+  /// @return Pointer to the control loop timing profiler
+  inline std::shared_ptr<Profiler> getProfiler(void) { return profiler_; };
+
   /// Accessor for system state member.
   /// @return Current state of the system
   inline SystemState getSystemState(void) { return system_state_; };
 
+  /// Accessor for robot state member.
+  /// @return Current state of the robot
+  inline RobotState getRobotState(void) { return robot_state_; };
+
+  /// Accessor for robot model object.
+  /// @return Pointer to the robot model object
+  inline std::shared_ptr<Model> getModel(void) { return model_; };
+
+  /// Accessor for walk controller object.
+  /// @return Pointer to the walk controller object
+  inline std::shared_ptr<WalkController> getWalker(void) { return walker_; };
+
   /// Returns true if all joint objects in model have been initialised with a current position.
   /// @return Flag denoting whether all joint objects in model have been initialised with a current position
   inline bool jointPositionsInitialised(void) { return joint_positions_initialised_; };
@@ -89,6 +171,10 @@ public:
   /// The transition from one state to another may require several iterations through this function before ending.
   void transitionRobotState(void);
 
+  /// Generates the workspace of each leg in the model and the walkspace of the walk controller, loading both from the
+  /// on-disk workspace cache instead if enabled and a cache file matching the current model and stance exists.
+  void generateWorkspaces(void);
+
   /// Loops whilst robot is in RUNNING state.
   /// Coordinates changes of gait, parameter adjustments, leg state toggling and the application of cruise control.
   /// Updates the walk/pose controllers tip positions and applies inverse kinematics to the leg objects.
@@ -113,12 +199,14 @@ public:
   void executePlan(void);
 
   /// Iterates through leg objects and either collates joint state information for combined publishing and/or publishes
-  /// the desired joint position on the leg member publisher object.
+  /// the desired joint position on the leg member publisher object. Joint state values are copied directly from the
+  /// model joint state store into a preallocated message.
   void publishDesiredJointState(void);
 
   /// Debugging functions
 
   /// Iterates through leg objects and collates state information for publishing on custom leg state message topic.
+  /// Values are overwritten in preallocated messages, using a single timestamp per cycle.
   /// @todo Remove ASC state messages in line with requested hardware changes to use legState message variable/s
   void publishLegState(void);
 
@@ -137,6 +225,27 @@ public:
   /// Publishes transforms linking world, base_link and walk_plane frames.
   void publishFrameTransforms(void);
 
+  /// Generates messages for each telemetry topic due this cycle (according to rate divisor parameters) into the back
+  /// buffer of the telemetry snapshot buffer and commits it for publishing by the telemetry thread. Used in place of
+  /// the individual telemetry publishing functions when the threaded_telemetry parameter is set.
+  void updateTelemetry(void);
+
+  /// Publishes control loop timing statistics at the rate defined by the timing_publish_rate parameter.
+  void publishTiming(void);
+
+  /// Applies the latest sensor and velocity inputs staged by the input callback thread (if threaded_callbacks is set)
+  /// through the associated callbacks. Called at the start of each control cycle so that inputs change only between
+  /// cycles.
+  void applyStagedInputs(void);
+
+  /// Writes the current controller state (joint positions, tip poses, step phases, admittance deltas and body pose
+  /// components) to the next record of the flight recorder ring buffer. Performs no locking or allocation.
+  void recordFlightState(void);
+
+  /// Simulates joint state feedback for headless simulation by setting the current joint states of all joints to the
+  /// desired joint states generated in this control cycle.
+  void simulateJointStates(void);
+
   /// Generates transforms for external leg stepper targets based on frame id and time.
   void generateExternalTargetTransforms(void);
 
@@ -153,6 +262,10 @@ public:
   /// @see parameters_and_states.h
   void robotStateCallback(const std_msgs::Int8 &input);
 
+  /// Callback requesting the flight recorder flush recorded controller state to file.
+  /// @param[in] input The Bool standard message provided by the subscribed ros topic "/shc/flight_recorder/flush"
+  void flightRecorderFlushCallback(const std_msgs::Bool &input);
+
   /// Callback for the input body velocity.
   /// @param[in] input The Twist geometry message provided by the subscribed ros topic "syropod_remote/desired_velocity"
   void bodyVelocityInputCallback(const geometry_msgs::Twist &input);
@@ -259,6 +372,17 @@ public:
   /// @param[in] tip_states The TipState sensor message provided by the subscribed ros topic "/tip_states"
   void tipStatesCallback(const syropod_highlevel_controller::TipState &tip_states);
 
+  /// Callbacks run on the input callback thread (if threaded_callbacks is set) which stage the latest input values
+  /// for application on the control thread via applyStagedInputs().
+  /// @param[in] joint_states The JointState sensor message provided by the subscribed ros topic "/joint_states"
+  void stageJointStatesCallback(const sensor_msgs::JointState &joint_states);
+  /// @param[in] data The Imu sensor message provided by the subscribed ros topic "/SYROPOD_TYPE/imu/data"
+  void stageImuCallback(const sensor_msgs::Imu &data);
+  /// @param[in] tip_states The TipState sensor message provided by the subscribed ros topic "/tip_states"
+  void stageTipStatesCallback(const syropod_highlevel_controller::TipState &tip_states);
+  /// @param[in] input The Twist geometry message provided by the subscribed ros topic "syropod_remote/desired_velocity"
+  void stageBodyVelocityInputCallback(const geometry_msgs::Twist &input);
+
   /// Callback which handles setting target configuration for pose controller from planner interface.
   /// @param[in] target_configuration The desired configuration that the planner requests transition to
   void targetConfigurationCallback(const sensor_msgs::JointState &target_configuration);
@@ -272,6 +396,57 @@ public:
   void targetTipPoseCallback(const syropod_highlevel_controller::TargetTipPose &msg);
 
 private:
+  /// Telemetry thread loop. Acquires the latest committed telemetry snapshot and publishes all topics flagged as due.
+  void runTelemetry(void);
+
+  /// Generates leg state messages for each leg.
+  /// @param[out] msgs Pointer to preallocated vector of leg state messages (indexed by leg id number) to overwrite
+  void generateLegStateMsgs(std::vector<syropod_highlevel_controller::LegState>* msgs);
+
+  /// Generates message of current desired linear and angular body velocity.
+  /// @param[out] msg Pointer to the message to overwrite
+  void generateVelocityMsg(geometry_msgs::Twist* msg);
+
+  /// Generates message of current pose (roll, pitch, yaw, x, y, z).
+  /// @param[out] msg Pointer to the message to overwrite
+  void generatePoseMsg(geometry_msgs::Twist* msg);
+
+  /// Generates message of current walkspace radii.
+  /// @param[out] msg Pointer to the message to overwrite
+  /// @return Flag denoting if a walkspace message was generated (i.e. robot is running)
+  bool generateWalkspaceMsg(std_msgs::Float32MultiArray* msg);
+
+  /// Generates message of imu pose rotation absement, position and velocity errors used in the PID controller.
+  /// @param[out] msg Pointer to the message to overwrite
+  void generateRotationPoseErrorMsg(std_msgs::Float32MultiArray* msg);
+
+  /// Generates transforms linking world, base_link and walk_plane frames.
+  /// @param[out] transforms Pointer to vector of transforms to overwrite
+  void generateFrameTransforms(std::vector<geometry_msgs::TransformStamped>* transforms);
+
+  /// Determines if a joint/tip frame transform is due to be published. Frames are always due if the
+  /// frame_transform_refresh_period parameter is zero, otherwise only if the transform has changed since it was last
+  /// published or the refresh period has elapsed. Records the transform as published if due.
+  /// @param[in] transform The generated frame transform
+  /// @param[in] frame_index The index of the frame within the cache of published joint/tip frame transforms
+  /// @return Flag denoting if the frame transform is due to be published
+  bool isFrameTransformDue(const geometry_msgs::TransformStamped &transform, const int &frame_index);
+
+  /// Clears the published record of the given joint/tip frame transforms such that they are due to be published on the
+  /// next frame transform cycle. Used when a telemetry snapshot containing them is dropped before being sent.
+  /// @param[in] transforms The frame transforms which were never sent
+  void invalidateFrameTransforms(const std::vector<geometry_msgs::TransformStamped> &transforms);
+
+  /// Regenerates the cached mapping of joint state message entries to joint state store slots if the message joint
+  /// name ordering has changed. Entries naming joints which do not exist in the model are omitted from the mapping.
+  /// @param[in] names The joint name ordering of the latest joint state message
+  void updateJointStateLayout(const std::vector<std::string> &names);
+
+  /// Regenerates the cached mapping of tip state message entries to legs if the message tip name ordering has
+  /// changed. Entries naming tips of legs which do not exist in the model are omitted from the mapping.
+  /// @param[in] names The tip name ordering of the latest tip state message
+  void updateTipStateLayout(const std::vector<std::string> &names);
+
   ros::Subscriber system_state_subscriber_;            ///< Subscriber for topic /syropod_remote/system_state
   ros::Subscriber robot_state_subscriber_;             ///< Subscriber for topic /syropod_remote/robot_state
   ros::Subscriber desired_velocity_subscriber_;        ///< Subscriber for topic /syropod_remote/desired_velocity
@@ -298,6 +473,8 @@ private:
   ros::Subscriber target_body_pose_subscriber_;     ///< Subscriber for topic /target_body_pose
   ros::Subscriber target_tip_pose_subscriber_;      ///< Subscriber for topic /target_tip_poses
 
+  ros::Subscriber flight_recorder_flush_subscriber_; ///< Subscriber for topic /shc/flight_recorder/flush
+
   ros::Subscriber imu_data_subscriber_;    ///< Subscriber for topic /SYROPOD_TYPE/imu/data
   ros::Subscriber joint_state_subscriber_; ///< Subscriber for topic /joint_states
   ros::Subscriber tip_state_subscriber_;   ///< Subscriber for topic /tip_states
@@ -308,11 +485,46 @@ private:
   ros::Publisher walkspace_publisher_;           ///< Publisher for topic /shc/walkspace
   ros::Publisher rotation_pose_error_publisher_; ///< Publisher for topic /shc/rotation_pose_error
   ros::Publisher plan_step_request_publisher_;   ///< Publisher for topic /shc/plan_step_request
+  ros::Publisher timing_publisher_;              ///< Publisher for topic /shc/timing
+
+  /// Preallocated messages, sized at initialisation and overwritten each cycle
+  std::vector<syropod_highlevel_controller::LegState> leg_state_msgs_; ///< Leg state messages for each leg
+  sensor_msgs::JointState desired_joint_state_msg_;                   ///< Combined desired joint state message
+  std::vector<geometry_msgs::TransformStamped> frame_transforms_;     ///< Frame transforms to be broadcast
+
+  /// Telemetry thread variables
+  std::shared_ptr<SnapshotBuffer<TelemetrySnapshot>> telemetry_buffer_; ///< Snapshot buffer read by telemetry thread
+  std::thread telemetry_thread_;                 ///< Thread publishing telemetry topics from snapshots
+  std::atomic<bool> telemetry_running_{ false }; ///< Flag denoting if the telemetry thread should continue running
+  int telemetry_rate_divisors_[TELEMETRY_TOPIC_COUNT]; ///< Divisors of control rate at which each topic is published
+  long telemetry_cycle_ = 0;                     ///< Count of control cycles since telemetry generation began
+
+  /// Input callback thread variables
+  ros::CallbackQueue input_callback_queue_;            ///< Callback queue for sensor and velocity input subscriptions
+  std::shared_ptr<ros::AsyncSpinner> input_spinner_;   ///< Spinner servicing the input callback queue
+  std::shared_ptr<SnapshotBuffer<StagedInputs>> staged_inputs_; ///< Snapshot buffer of inputs staged by input thread
+  StagedInputs input_accumulator_;                     ///< Latest inputs accumulated on the input callback thread
+  StagedInputs applied_input_counts_;                  ///< Message counts of inputs already applied (counts only)
+
+  /// Timing profiler variables
+  syropod_highlevel_controller::TimingState timing_msg_; ///< Timing state message
+  int timing_publish_divisor_ = 1;               ///< Control rate divisor for timing publishing (0 if disabled)
+  long timing_cycle_ = 0;                        ///< Count of control cycles since timing publishing began
+
+  std::shared_ptr<IKDiagnosticsReporter> ik_diagnostics_; ///< Pointer to IK diagnostics reporter (NULL if disabled)
+
+  /// Flight recorder variables
+  std::shared_ptr<FlightRecorder> flight_recorder_; ///< Pointer to flight recorder object (NULL if disabled)
+  uint64_t flight_record_cycle_ = 0;                ///< Count of control cycles recorded by the flight recorder
 
   tf2_ros::Buffer transform_buffer_;
   std::shared_ptr<tf2_ros::TransformListener> transform_listener_;
   tf2_ros::TransformBroadcaster transform_broadcaster_;
 
+  ros::CallbackQueue* callback_queue_;  ///< Callback queue servicing controller subscriptions
+  std::string private_namespace_;       ///< Namespace of the dynamic reconfigure server
+  bool intra_process_ = false;          ///< Flag denoting if desired joint states are published by shared pointer
+
   boost::recursive_mutex mutex_; ///< Mutex used in setup of dynamic reconfigure server
   dynamic_reconfigure::Server<syropod_highlevel_controller::DynamicConfig>* dynamic_reconfigure_server_;
 
@@ -320,6 +532,8 @@ private:
   std::shared_ptr<WalkController> walker_;           ///< Pointer to walk controller object
   std::shared_ptr<PoseController> poser_;            ///< Pointer to pose controller object
   std::shared_ptr<AdmittanceController> admittance_; ///< Pointer to admittance controller object
+  std::shared_ptr<WorkspaceCache> workspace_cache_;  ///< Pointer to workspace cache object
+  std::shared_ptr<Profiler> profiler_;               ///< Pointer to control loop timing profiler object
   DebugVisualiser debug_visualiser_;                 ///< Debug class object used for RVIZ visualization
   Parameters params_;                                ///< Parameter data structure for storing parameter variables
 
@@ -355,6 +569,12 @@ private:
   bool toggle_secondary_leg_state_ = false;  ///< Flags that the secondary selected leg state is toggling
   bool parameter_adjust_flag_ = false;       ///< Flags that the selected parameter is being adjusted
   bool joint_positions_initialised_ = false; ///< Flags if all joint objects have been initialised with a position
+
+  /// Cached mappings from the name ordering of the latest state messages, regenerated only if the ordering changes
+  std::vector<std::string> joint_state_layout_names_; ///< Joint name ordering of latest joint state message
+  std::vector<std::pair<int, int>> joint_state_layout_; ///< Message index and store slot of each known joint entry
+  std::vector<std::string> tip_state_layout_names_;   ///< Tip name ordering of latest tip state message
+  std::vector<std::pair<int, std::shared_ptr<Leg>>> tip_state_layout_; ///< Message index and leg of each known tip
   bool transition_state_flag_ = false;       ///< Flags that the system state is transitioning
 
   bool target_configuration_acquired_ = false; ///< Flag denoting if configuration has acquired from planner interface
@@ -362,6 +582,10 @@ private:
   bool target_body_pose_acquired_ = false;     ///< Flag denoting if body pose has been acquiredfrom planner interface
   int plan_step_ = 0;                          ///< The plan step currently being requested/executed
   std::string fixed_frame_id_;                 ///< The id of the fixed frame
+  bool odom_available_ = false;                ///< Flag denoting if odom frame was found in tf tree at last check
+  bool odom_checked_ = false;                  ///< Flag denoting if tf tree has been checked for odom frame
+  ros::Time odom_check_time_;                  ///< The time of the last check of tf tree for odom frame
+  std::vector<geometry_msgs::TransformStamped> published_frame_transforms_; ///< Last published joint/tip transforms
 
   Eigen::Vector2d linear_velocity_input_;        ///< Input for the desired linear velocity of the robot body
   double angular_velocity_input_ = 0;            ///< Input for the desired angular velocity of the robot body
@@ -14,9 +14,29 @@
 #include "pose.h"
 #include "model.h"
 
+#define BEARING_BUCKET_COUNT (360 / BEARING_STEP) ///< Number of bearing buckets in a dense limit table
+
 class DebugVisualiser;
 typedef std::map<int, double> LimitMap;
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Enum defining the rows of a dense limit table.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+enum LimitType
+{
+  WALKSPACE_LIMIT,            ///< Walkspace radius limit
+  LINEAR_SPEED_LIMIT,         ///< Maximum linear body speed limit
+  ANGULAR_SPEED_LIMIT,        ///< Maximum angular body speed limit
+  LINEAR_ACCELERATION_LIMIT,  ///< Maximum linear body acceleration limit
+  ANGULAR_ACCELERATION_LIMIT, ///< Maximum angular body acceleration limit
+  LIMIT_TYPE_COUNT,           ///< Misc enum defining number of Limit Types
+};
+
+/// Dense table of limits with a row for each limit type and a column for each BEARING_STEP bucket from 0-360 degrees
+/// (final column duplicates bearing 0 as bearing 360).
+typedef Eigen::Matrix<double, LIMIT_TYPE_COUNT, BEARING_BUCKET_COUNT + 1> LimitTable;
+typedef Eigen::Matrix<double, LIMIT_TYPE_COUNT, 1> LimitVector;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Object containing parameters which define the timing of the step cycle.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -32,6 +52,54 @@ struct StepCycle
   int stance_start_;  ///< The iteration at which the stance period starts
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Object containing the cached contribution of a single leg to the walkspace, allowing the walkspace to be regenerated
+/// incrementally for only those legs whose default tip position or workspace (or the pose of the robot body) changed.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct LegWalkspace
+{
+  bool defined_ = false;                 ///< Flag denoting if the cached contribution has been generated
+  Eigen::Vector3d default_tip_position_; ///< The default tip position from which the contribution was generated
+  Pose current_pose_;                    ///< The robot body pose from which the walkspace radii were generated
+  LimitMap overlap_limits_;              ///< Distances to overlap with adjacent leg walkspaces for each bearing
+  bool workplane_defined_ = false;       ///< Flag denoting if the interpolated workplane has been generated
+  double workplane_height_ = 0.0;        ///< The height within the leg workspace of the interpolated workplane
+  Workplane workplane_;                  ///< The interpolated workplane at the default tip position height
+  int workspace_revision_ = -1;          ///< The revision of the leg workspace from which the workplane was generated
+  LimitMap radii_;                       ///< Walkspace radii from interpolated workplane for each bearing (or empty)
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Object containing the predicted time until the end of the current (or next, if in stance) swing period of a single
+/// leg and the estimated odometry pose change over that time, generated once per walk controller cycle.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct SwingEndPrediction
+{
+  double time_to_swing_end_ = 0.0;   ///< The time until the end of the current or next swing period (sec)
+  Pose odometry_ = Pose::Identity(); ///< The estimated odometry pose change until the end of the swing period
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Object containing iteration constants and precomputed bezier basis weights for the swing and standard stance
+/// trajectories of the step cycle. Depends only on the step cycle and so is regenerated only when it changes.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct TrajectoryTable
+{
+  int swing_iterations_ = 0;    ///< The number of iterations over the entire swing period (both swing curves)
+  double swing_delta_t_ = 0.0;  ///< The time input delta of each iteration along each swing bezier curve
+  int stance_period_ = 0;       ///< The length of the standard stance period for which stance weights are generated
+  int stance_iterations_ = 0;   ///< The number of iterations over the standard stance period
+  double stance_delta_t_ = 0.0; ///< The time input delta of each iteration along the stance bezier curve
+  std::vector<std::array<double, 5>> swing_weights_;  ///< Tip position delta weights for each swing curve iteration
+  std::vector<std::array<double, 5>> stance_weights_; ///< Tip position delta weights for each stance curve iteration
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// Object containing parameters which define an externally set target tip pose.
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -59,6 +127,13 @@ public:
   /// @param[in] params A copy of the parameter data structure
   WalkController(std::shared_ptr<Model> model, const Parameters &params);
 
+  /// Walk controller copy constructor, initialises member variables from reference walk controller object. Used to
+  /// detach sequence planning from the walk controller of the control thread.
+  /// @param[in] walker The reference walk controller object to copy
+  /// @param[in] model A pointer to the robot model of the copy
+  /// @param[in] params The parameter data structure used by the copy
+  WalkController(std::shared_ptr<WalkController> walker, std::shared_ptr<Model> model, const Parameters &params);
+
   /// Accessor for pointer to parameter data structure.
   /// @return Pointer to parameter data structure
   inline const Parameters &getParameters(void) { return params_; };
@@ -67,6 +142,10 @@ public:
   /// @return Step cycle timing object
   inline StepCycle getStepCycle(void) { return step_; };
 
+  /// Accessor for swing and stance trajectory table of the current step cycle.
+  /// @return Trajectory table of precomputed iteration constants and bezier basis weights
+  inline const TrajectoryTable& getTrajectoryTable(void) { return trajectory_table_; };
+
   /// Accessor for ros cycle time period.
   /// @return ROS cycle time period
   inline double getTimeDelta(void) { return time_delta_; };
@@ -97,7 +176,7 @@ public:
 
   /// Accessor for walkspace.
   /// @return Walkspace
-  inline LimitMap getWalkspace(void) { return walkspace_; };
+  inline const LimitMap& getWalkspace(void) { return walkspace_; };
 
   /// Accessor for walk plane estimate.
   /// @return Walk plane estimate
@@ -121,31 +200,56 @@ public:
 
   /// Modifier for linear velocity limit map.
   /// @param[in] limit_map The new linear velocity limit map
-  inline void setLinearSpeedLimitMap(const LimitMap &limit_map) { max_linear_speed_ = limit_map; };
+  inline void setLinearSpeedLimitMap(const LimitMap &limit_map)
+  {
+    max_linear_speed_ = limit_map;
+    setLimitTableRow(&limit_table_, LINEAR_SPEED_LIMIT, limit_map);
+  };
 
   /// Modifier for angular velocity limit map.
   /// @param[in] limit_map The new angular velocity limit map
-  inline void setAngularSpeedLimitMap(const LimitMap &limit_map) { max_angular_speed_ = limit_map; };
+  inline void setAngularSpeedLimitMap(const LimitMap &limit_map)
+  {
+    max_angular_speed_ = limit_map;
+    setLimitTableRow(&limit_table_, ANGULAR_SPEED_LIMIT, limit_map);
+  };
 
   /// Modifier for linear acceleration limit map.
   /// @param[in] limit_map The new linear aceleration limit map
-  inline void setLinearAccelerationLimitMap(const LimitMap &limit_map) { max_linear_acceleration_ = limit_map; };
+  inline void setLinearAccelerationLimitMap(const LimitMap &limit_map)
+  {
+    max_linear_acceleration_ = limit_map;
+    setLimitTableRow(&limit_table_, LINEAR_ACCELERATION_LIMIT, limit_map);
+  };
 
   /// Modifier for angular acceleration limit map.
   /// @param[in] limit_map The new angular acceleration limit map
-  inline void setAngularAccelerationLimitMap(const LimitMap &limit_map) { max_angular_acceleration_ = limit_map; };
+  inline void setAngularAccelerationLimitMap(const LimitMap &limit_map)
+  {
+    max_angular_acceleration_ = limit_map;
+    setLimitTableRow(&limit_table_, ANGULAR_ACCELERATION_LIMIT, limit_map);
+  };
 
-  /// Sets flag to regenerate walkspace.
+  /// Sets flag to regenerate walkspace. May be called by leg steppers updated concurrently.
   inline void setRegenerateWalkspace(void) { regenerate_walkspace_ = true; };
 
+  /// Modifier for walkspace (e.g. loaded from cache). Also regenerates velocity/acceleration limits from new walkspace.
+  /// Clears cached leg contributions such that the next incremental walkspace generation is complete.
+  /// @param[in] walkspace The new walkspace
+  void setWalkspace(const LimitMap &walkspace);
+
   /// Initialises walk controller by setting desired default walking stance tip positions from parameters and creating
   /// LegStepper objects for each leg. Also populates workspace map with initial values by finding bisector line between
   /// adjacent leg tip positions.
   void init(void);
 
-  /// Generates a 2D polygon from leg workspace, representing the acceptable space to walk within.
+  /// Generates a 2D polygon from leg workspace, representing the acceptable space to walk within. The contribution of
+  /// each leg (overlap with adjacent legs and radii within its interpolated workplane) is cached such that incremental
+  /// generation only regenerates the contributions of legs affected by changes in default tip positions, leg
+  /// workspaces or body pose.
+  /// @param[in] incremental Flag denoting if cached leg contributions unaffected by changes may be reused
   /// @todo Remove debugging visualisations
-  void generateWalkspace(void);
+  void generateWalkspace(const bool &incremental = false);
 
   /// Generate maximum linear and angular speed/acceleration for each workspace radius in workspace map from a given
   /// step cycle. These calculated values will accomodate overshoot of tip outside defined workspace whilst body
@@ -185,6 +289,10 @@ public:
   /// @return Generated step cycle object
   StepCycle generateStepCycle(const bool set_step_cycle = true);
 
+  /// Generates trajectory table of swing/stance iteration constants and bezier basis weights for each iteration of
+  /// the current step cycle, such that leg steppers need not regenerate them each iteration.
+  void generateTrajectoryTable(void);
+
   /// Given an input linear velocity vector and angular velocity, this function calculates a stride bearing then
   /// an interpolation of the two limits at the bearings (defined by the input limit map) bounding the stride bearing.
   /// This is calculated for each leg and the minimum value returned.
@@ -195,6 +303,17 @@ public:
   double getLimit(const Eigen::Vector2d &linear_velocity_input, const double &angular_velocity_input,
                   const LimitMap &limit);
 
+  /// Given an input linear velocity vector and angular velocity, this function calculates a stride bearing for each
+  /// leg and evaluates every limit type of the dense walk controller limit table at once, interpolating between the
+  /// bearing buckets bounding each stride bearing. The minimum of each limit type across all legs is returned.
+  /// @param[in] linear_velocity_input The velocity input given to the Syropod defining desired linear body motion
+  /// @param[in] angular_velocity_input The velocity input given to the Syropod defining desired angular body motion
+  /// @return The smallest interpolated limit of each limit type (indexed by LimitType) from each of the Syropod legs
+  inline LimitVector getLimits(const Eigen::Vector2d &linear_velocity_input, const double &angular_velocity_input)
+  {
+    return interpolateLimits(limit_table_, linear_velocity_input, angular_velocity_input);
+  };
+
   /// Updates all legs in the walk cycle. Calculates stride vectors for all legs from robot body velocity inputs and
   /// calls trajectory update functions for each leg to update individual tip positions. Also manages the overall walk
   /// state via state machine and input velocities as well as the individual step state of each leg as they progress
@@ -237,7 +356,65 @@ public:
   /// @return The estimated odometry pose change over the desired time period
   Pose calculateOdometry(const double &time_period);
 
+  /// Updates the cache of odometry predictions from the current step phase of each leg and desired body velocities.
+  /// Generates the time to swing end of each leg and the odometry pose change over that time and over each of the
+  /// configured prediction horizons. Called once per walk controller cycle, after leg phases are iterated.
+  void updateOdometryPredictions(void);
+
+  /// Accessor for the cached prediction of the time until the end of the current (or next) swing period of a leg.
+  /// @param[in] leg_id_number The identification number of the leg
+  /// @return The predicted time until the end of the current swing period (or next if leg is in stance) (sec)
+  inline double getTimeToSwingEnd(const int &leg_id_number)
+  {
+    return swing_end_predictions_[leg_id_number].time_to_swing_end_;
+  };
+
+  /// Accessor for the cached prediction of the odometry pose change until the end of the current (or next) swing
+  /// period of a leg.
+  /// @param[in] leg_id_number The identification number of the leg
+  /// @return The estimated odometry pose change until the end of the current swing period (or next if in stance)
+  inline Pose getSwingEndOdometry(const int &leg_id_number) { return swing_end_predictions_[leg_id_number].odometry_; };
+
+  /// Accessor for the configured odometry prediction horizons.
+  /// @return The time horizons over which odometry predictions are cached (sec)
+  inline const std::vector<double>& getOdometryPredictionHorizons(void)
+  {
+    return params_.odometry_prediction_horizons.data;
+  };
+
+  /// Accessor for the cached prediction of the odometry pose change over a configured prediction horizon.
+  /// @param[in] horizon_index The index of the horizon within the configured odometry prediction horizons
+  /// @return The estimated odometry pose change over the prediction horizon
+  inline Pose getHorizonOdometry(const int &horizon_index) { return horizon_odometry_[horizon_index]; };
+
 private:
+  /// Generates the distance to the overlap with the walkspaces of adjacent legs for each bearing of a leg walkspace.
+  /// @param[in] leg A pointer to the leg
+  /// @param[out] leg_walkspace Pointer to the cached leg walkspace contribution to be populated
+  void generateOverlapLimits(std::shared_ptr<Leg> leg, LegWalkspace *leg_walkspace);
+
+  /// Generates the walkspace radius for each bearing of a leg walkspace from the interpolated workplane of the leg at
+  /// the height of its default tip position, reusing the cached interpolated workplane if the height and leg workspace
+  /// are unchanged.
+  /// @param[in] leg A pointer to the leg
+  /// @param[out] leg_walkspace Pointer to the cached leg walkspace contribution to be populated
+  void generateWalkspaceRadii(std::shared_ptr<Leg> leg, LegWalkspace *leg_walkspace);
+
+  /// Populates a row of a dense limit table from the limits of a limit map at each bearing bucket.
+  /// @param[out] table Pointer to the dense limit table to be populated
+  /// @param[in] type The limit type designating the row of the table to be populated
+  /// @param[in] limit The LimitMap object which contains limit data for a range of bearings from 0-360 degrees
+  void setLimitTableRow(LimitTable *table, const LimitType &type, const LimitMap &limit);
+
+  /// Interpolation kernel which calculates the stride bearing of each leg for the given velocity inputs and evaluates
+  /// all rows of a dense limit table at these bearings, returning the minimum of each row across all legs.
+  /// @param[in] table The dense limit table to be evaluated
+  /// @param[in] linear_velocity_input The velocity input given to the Syropod defining desired linear body motion
+  /// @param[in] angular_velocity_input The velocity input given to the Syropod defining desired angular body motion
+  /// @return The smallest interpolated limit of each row of the table from each of the Syropod legs
+  LimitVector interpolateLimits(const LimitTable &table,
+                                const Eigen::Vector2d &linear_velocity_input, const double &angular_velocity_input);
+
   std::shared_ptr<Model> model_; ///< Pointer to robot model object
   const Parameters &params_;     ///< Pointer to parameter data structure for storing parameter variables
   double time_delta_;            ///< The time period of the ros cycle
@@ -246,21 +423,26 @@ private:
   PosingState pose_state_ = POSING_COMPLETE; ///< The current state of auto posing
 
   StepCycle step_; ///< Step cycle timing object
+  TrajectoryTable trajectory_table_; ///< Precomputed trajectory constants and weights for current step cycle
 
   // Workspace generation variables
   LimitMap walkspace_;                ///< A map of interpolated radii for given bearings in degrees at default stance
+  std::vector<LegWalkspace, Eigen::aligned_allocator<LegWalkspace>> leg_walkspaces_; ///< Cached leg contributions
   Eigen::Vector3d walk_plane_;        ///< The co-efficients of an estimated planar walk surface
   Eigen::Vector3d walk_plane_normal_; ///< The normal of the estimated planar walk surface
-  bool regenerate_walkspace_ = false; ///< Flag denoting whether walkspace needs to be regenerated
+  std::atomic<bool> regenerate_walkspace_{ false }; ///< Flag denoting whether walkspace needs to be regenerated
 
   // Velocity/acceleration variables
   Eigen::Vector2d desired_linear_velocity_; ///< The desired linear velocity of the robot body
   double desired_angular_velocity_;         ///< The desired angular velocity of the robot body
   Pose odometry_ideal_;                     ///< The ideal odometry from the world frame
+  std::vector<SwingEndPrediction, Eigen::aligned_allocator<SwingEndPrediction>> swing_end_predictions_; ///< Per leg
+  std::vector<Pose, Eigen::aligned_allocator<Pose>> horizon_odometry_; ///< Odometry over each prediction horizon
   LimitMap max_linear_speed_;               ///< A map of max allowable linear body speeds for potential bearings
   LimitMap max_angular_speed_;              ///< A map of max allowable angular speeds for potential bearings
   LimitMap max_linear_acceleration_;        ///< A map of max allowable linear accelerations for potential bearings
   LimitMap max_angular_acceleration_;       ///< A map of max allowable angular accelerations for potential bearings
+  LimitTable limit_table_;                  ///< Dense table of walkspace, speed and acceleration limits per bearing
 
   // Leg coordination variables
   int legs_at_correct_phase_ = 0;            ///< A count of legs currently at the correct phase per walk cycle state
@@ -300,6 +482,10 @@ public:
   /// @return Pointer to parent leg object
   inline std::shared_ptr<Leg> getParentLeg(void) { return leg_; };
 
+  /// Accessor for pointer to walk controller object.
+  /// @return Pointer to walk controller object
+  inline std::shared_ptr<WalkController> getWalker(void) { return walker_; };
+
   /// Accessor for the current tip pose according to the walk controller.
   /// @return Current tip pose accoding to the walk controller
   inline Pose getCurrentTipPose(void) { return current_tip_pose_; };
@@ -392,6 +578,10 @@ public:
   /// @param[in] parent_leg The new parent leg pointer
   inline void setParentLeg(std::shared_ptr<Leg> parent_leg) { leg_ = parent_leg; };
 
+  /// Modifier for the pointer to the walk controller object.
+  /// @param[in] walker The new walk controller pointer
+  inline void setWalker(std::shared_ptr<WalkController> walker) { walker_ = walker; };
+
   /// Modifier for the current tip pose according to the walk controller.
   /// @param[in] current_tip_pose The new current tip pose
   inline void setCurrentTipPose(const Pose &current_tip_pose) { current_tip_pose_ = current_tip_pose; };
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_WORKER_POOL_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_WORKER_POOL_H
+
+#include "standard_includes.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class implements a persistent pool of worker threads, each pinned to its own processor core, which execute a
+/// batch of independent tasks alongside the calling thread. Threads are created once on construction so that no
+/// threads are created per control cycle. Each call to run() returns only once every task in the batch is complete,
+/// providing a deterministic join point before results are used.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class WorkerPool
+{
+public:
+  /// Constructor for worker pool. Creates worker threads and pins each to a processor core, leaving the first core
+  /// for the calling thread where possible.
+  /// @param[in] worker_count The number of worker threads created in addition to the calling thread
+  WorkerPool(const int& worker_count);
+
+  /// Destructor for worker pool. Signals all worker threads to finish and joins them.
+  ~WorkerPool(void);
+
+  /// Accessor for the number of worker threads in the pool.
+  /// @return The number of worker threads created in addition to the calling thread
+  inline int getWorkerCount(void) const { return static_cast<int>(workers_.size()); };
+
+  /// Raises worker threads to the SCHED_FIFO priority of a real time calling thread, so that the calling thread never
+  /// waits on lower priority workers, and pins each worker to its own core other than the core of the calling thread.
+  /// @param[in] core The processor core to which the real time calling thread is pinned (workers unchanged if negative)
+  /// @param[in] priority The SCHED_FIFO real time priority of the calling thread (1 -> 99)
+  /// @return Bool denoting if all workers were successfully configured
+  bool initRealTime(const int& core, const int& priority);
+
+  /// Executes a batch of tasks across the worker threads and the calling thread, blocking until all are complete.
+  /// Tasks must be independent of each other since they may be executed in any order and concurrently.
+  /// @param[in] task_count The number of tasks in the batch
+  /// @param[in] task The task function, taking the index (0 -> task_count - 1) of the task as argument
+  void run(const int& task_count, const std::function<void(const int&)>& task);
+
+private:
+  /// Main function of each worker thread. Waits for each new batch of tasks and executes tasks until none remain.
+  void work(void);
+
+  /// Executes tasks of the current batch until none remain.
+  void executeTasks(void);
+
+  std::vector<std::thread> workers_;                 ///< The persistent worker threads
+  std::mutex mutex_;                                 ///< Mutex protecting batch generation and completion state
+  std::condition_variable batch_started_;            ///< Condition signalling workers that a new batch has started
+  std::condition_variable batch_completed_;          ///< Condition signalling caller that all tasks are complete
+  const std::function<void(const int&)>* task_ = NULL; ///< Pointer to task function of the current batch
+  int task_count_ = 0;                               ///< Number of tasks in the current batch
+  std::atomic<int> next_task_{ 0 };                  ///< Index of the next unclaimed task of the current batch
+  std::atomic<int> completed_tasks_{ 0 };            ///< Number of completed tasks of the current batch
+  int active_workers_ = 0;                           ///< Number of workers currently executing tasks of the batch
+  uint64_t generation_ = 0;                          ///< Count of batches started, used to wake workers
+  bool running_ = true;                              ///< Flag denoting if worker threads should continue running
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_WORKER_POOL_H
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SYROPOD_HIGHLEVEL_CONTROLLER_WORKSPACE_CACHE_H
+#define SYROPOD_HIGHLEVEL_CONTROLLER_WORKSPACE_CACHE_H
+
+#include "standard_includes.h"
+#include "parameters_and_states.h"
+
+#include "model.h"
+#include "walk_controller.h"
+
+#define WORKSPACE_CACHE_VERSION 2        ///< Version of cache file format/generation algorithm (increment on change)
+#define WORKSPACE_CACHE_MAGIC 0x53484357 ///< Identifier written at start of each workspace cache file ("SHCW")
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// This class handles the persistent on-disk caching of the workspace of each leg of the robot model and the
+/// walkspace of the walk controller. Generated workspaces depend only on the kinematic description of the robot and
+/// the default stance, therefore these values are hashed to generate a key identifying a unique cache file (stored
+/// under the ROS home directory) which may be loaded in place of regenerating the workspaces and walkspace.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class WorkspaceCache
+{
+public:
+  /// WorkspaceCache class constructor.
+  /// @param[in] model Pointer to the robot model class object
+  /// @param[in] walker Pointer to the walk controller class object
+  /// @param[in] params Pointer to the parameter struct object
+  WorkspaceCache(std::shared_ptr<Model> model, std::shared_ptr<WalkController> walker, const Parameters& params);
+
+  /// Generates a key by hashing all parameters and model state upon which generated workspaces/walkspace depend.
+  /// @return The hexadecimal string representation of the generated key
+  std::string generateKey(void);
+
+  /// Attempts to load workspaces and walkspace from the cache file associated with the current key. On success the
+  /// workspace of each leg in the model and the walkspace (and associated limits) of the walk controller are set.
+  /// @return Bool denoting if the workspaces and walkspace were successfully loaded from cache
+  bool load(void);
+
+  /// Saves the current workspace of each leg in the model and walkspace of the walk controller to the cache file
+  /// associated with the current key.
+  /// @return Bool denoting if the workspaces and walkspace were successfully saved to cache
+  bool save(void);
+
+private:
+  /// Generates the path of the cache file associated with the input key within the ROS home directory.
+  /// @param[in] key The key identifying the cache file
+  /// @return The path of the cache file
+  std::string getCacheFilePath(const std::string& key);
+
+  std::shared_ptr<Model> model_;           ///< Pointer to robot model object
+  std::shared_ptr<WalkController> walker_; ///< Pointer to walk controller object
+  const Parameters& params_;               ///< Pointer to parameter data structure for storing parameter variables
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#endif // SYROPOD_HIGHLEVEL_CONTROLLER_WORKSPACE_CACHE_H
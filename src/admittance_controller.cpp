@@ -15,51 +15,105 @@ AdmittanceController::AdmittanceController(std::shared_ptr<Model> model, const P
   : model_(model)
   , params_(params)
 {
+  int leg_count = model_->getLegCount();
+  admittance_states_ = Eigen::Matrix<double, 2, Eigen::Dynamic>::Zero(2, leg_count);
+  tip_forces_ = Eigen::Matrix<double, 3, Eigen::Dynamic>::Zero(3, leg_count);
+  admittance_deltas_ = Eigen::Matrix<double, 3, Eigen::Dynamic>::Zero(3, leg_count);
+  transition_parameters_ = Eigen::Vector4d::Constant(UNASSIGNED_VALUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AdmittanceController::generateStateTransition(const double& mass, const double& stiffness,
+                                                   const double& damping_ratio, const double& step_time)
+{
+  // Augmented continuous-time system: d/dt[x, v, u] = [[0, 1, 0], [-k/m, -c/m, -1/m], [0, 0, 0]] * [x, v, u]
+  // REF: Chapter 4.3 of Computer-Controlled Systems: Theory and Design, K. J. Astrom & B. Wittenmark 1997
+  double virtual_damping = damping_ratio * 2 * sqrt(mass * stiffness);
+  Eigen::Matrix3d system = Eigen::Matrix3d::Zero();
+  system(0, 1) = 1.0;
+  system(1, 0) = -stiffness / mass;
+  system(1, 1) = -virtual_damping / mass;
+  system(1, 2) = -1.0 / mass;
+  system *= step_time;
+
+  // Matrix exponential via scaling and squaring of a truncated taylor series
+  double norm = system.cwiseAbs().rowwise().sum().maxCoeff();
+  int squarings = std::max(0, static_cast<int>(std::ceil(std::log2(norm / 0.5))));
+  system /= std::pow(2.0, squarings);
+  Eigen::Matrix3d exponential = Eigen::Matrix3d::Identity();
+  Eigen::Matrix3d term = Eigen::Matrix3d::Identity();
+  for (int i = 1; i <= MATRIX_EXPONENTIAL_TAYLOR_ORDER; ++i)
+  {
+    term = term * system / i;
+    exponential += term;
+  }
+  for (int i = 0; i < squarings; ++i)
+  {
+    exponential = exponential * exponential;
+  }
+
+  state_transition_ = exponential.block<2, 2>(0, 0);
+  input_transition_ = exponential.block<2, 1>(0, 2);
+  transition_parameters_ = Eigen::Vector4d(mass, stiffness, damping_ratio, step_time);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void AdmittanceController::updateAdmittance(void)
 {
-  // Get current force value on leg and run admittance calculations to get a vertical tip offset (deltaZ)
+  // Regenerate discrete-time system only when virtual system parameters change (i.e. via dynamic reconfigure)
+  double damping = params_.virtual_damping_ratio.current_value;
+  double stiffness = params_.virtual_stiffness.current_value;
+  double mass = params_.virtual_mass.current_value;
+  double step_time = params_.integrator_step_time.data;
+  if (transition_parameters_ != Eigen::Vector4d(mass, stiffness, damping, step_time))
+  {
+    generateStateTransition(mass, stiffness, damping, step_time);
+  }
+
+  // Gather admittance states and tip forces of all legs
+  int index = 0;
   LegContainer::iterator leg_it;
-  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it)
+  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it, ++index)
   {
     std::shared_ptr<Leg> leg = leg_it->second;
-    Eigen::Vector3d admittance_delta = Eigen::Vector3d::Zero();
     bool use_calculated_tip_force = params_.use_joint_effort.data;
     Eigen::Vector3d tip_force = use_calculated_tip_force ? leg->getTipForceCalculated() : leg->getTipForceMeasured();
-    tip_force *= params_.force_gain.current_value;
-    for (int i = 0; i < 3; ++i)
+    tip_forces_.col(index) = tip_force * params_.force_gain.current_value;
+    state_type* admittance_state = leg->getAdmittanceState();
+    admittance_states_(0, index) = (*admittance_state)[0];
+    admittance_states_(1, index) = (*admittance_state)[1];
+  }
+
+  // Get current force value on leg and run admittance calculations to get a vertical tip offset (deltaZ)
+  admittance_deltas_.setZero();
+  for (int i = 0; i < 3; ++i)
+  {
+    // Use vertical component of tip force vector //TODO
+    admittance_states_ = state_transition_ * admittance_states_ + input_transition_ * tip_forces_.row(i).cwiseMax(0.0);
+
+    // Deadbanding
+    for (int j = 0; j < admittance_states_.cols(); ++j)
     {
-      double force_input = std::max(tip_force[i], 0.0); // Use vertical component of tip force vector //TODO
-      double damping = params_.virtual_damping_ratio.current_value;
-      double stiffness = params_.virtual_stiffness.current_value;
-      double mass = params_.virtual_mass.current_value;
-      double step_time = params_.integrator_step_time.data;
-      state_type* admittance_state = leg->getAdmittanceState();
-      double virtual_damping = damping * 2 * sqrt(mass * stiffness);
-      boost::numeric::odeint::runge_kutta4<state_type> stepper;
-      integrate_const(stepper,
-                      [&](const state_type & x, state_type & dxdt, double t)
-                      {
-                        dxdt[0] = x[1];
-                        dxdt[1] = -force_input / mass - virtual_damping / mass * x[1] - stiffness / mass * x[0];
-                      }, 
-                      *admittance_state,
-                      0.0,
-                      step_time,
-                      step_time / 30);
-      
-      // Deadbanding
-      double delta = clamped(-(*admittance_state)[0], -0.2, 0.2);
+      double delta = clamped(-admittance_states_(0, j), -0.2, 0.2);
       double delta_direction = delta / abs(delta);
       if (abs(delta) > ADMITTANCE_DEADBAND)
       {
-        admittance_delta[i] = delta_direction * (abs(delta) - ADMITTANCE_DEADBAND) / (1 - ADMITTANCE_DEADBAND);
+        admittance_deltas_(i, j) = delta_direction * (abs(delta) - ADMITTANCE_DEADBAND) / (1 - ADMITTANCE_DEADBAND);
       }
     }
-    leg->setAdmittanceDelta(admittance_delta);
+  }
+
+  // Scatter updated admittance states and deltas back to legs
+  index = 0;
+  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it, ++index)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    state_type* admittance_state = leg->getAdmittanceState();
+    (*admittance_state)[0] = admittance_states_(0, index);
+    (*admittance_state)[1] = admittance_states_(1, index);
+    leg->setAdmittanceDelta(admittance_deltas_.col(index));
   }
 }
 
@@ -0,0 +1,173 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/state_controller.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#define DEFAULT_KINEMATICS_ITERATIONS 10000 ///< Default number of calls of each leg kinematics function benchmarked
+#define DEFAULT_WORKSPACE_ITERATIONS 3      ///< Default number of workspace/walkspace generations benchmarked
+#define DEFAULT_CONTROL_CYCLES 5000         ///< Default number of RUNNING state control cycles benchmarked
+#define STARTUP_CYCLE_LIMIT 100000          ///< Max control cycles allowed for transition to RUNNING state
+#define IK_TARGET_RADIUS 0.01               ///< Radius of circular tip target trajectory used in IK benchmark (m)
+#define FK_JOINT_PERTURBATION 1.0e-6        ///< Joint position perturbation forcing joint transform regeneration (rad)
+#define VELOCITY_INPUT_PERIOD 1000          ///< Period of scripted velocity input sequence (control cycles)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Times the given number of calls of a function.
+/// @param[in] function The function to be benchmarked, taking the iteration number as argument
+/// @param[in] iterations The number of calls to time
+/// @return The total duration of all calls (sec)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <class Function>
+double timeIterations(Function function, const int& iterations)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i)
+  {
+    function(i);
+  }
+  std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+  return duration.count();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Prints a row of the benchmark results table.
+/// @param[in] name The name of the benchmarked function
+/// @param[in] scope The scope of each call (e.g. leg name and DOF or whole model)
+/// @param[in] iterations The number of calls timed
+/// @param[in] duration The total duration of all calls (sec)
+/// @param[in] leg_count The number of legs processed by each call, used to report per leg throughput
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void reportResult(const std::string& name, const std::string& scope,
+                  const int& iterations, const double& duration, const int& leg_count = 1)
+{
+  double mean = duration / iterations;
+  std::cout << std::left << std::setw(36) << name << std::setw(20) << scope << std::right << std::fixed
+            << std::setw(10) << iterations
+            << std::setw(14) << std::setprecision(3) << mean * 1.0e6
+            << std::setw(14) << std::setprecision(1) << 1.0 / mean
+            << std::setw(16) << std::setprecision(1) << leg_count / mean << std::endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Benchmark executable. Builds the robot model and controllers from parameters loaded onto the parameter server
+/// (see launch/benchmark.launch) and micro-benchmarks the kinematics, workspace generation and walking pipelines
+/// without requiring joint states or user input. Iteration counts may be set via the private parameters
+/// ~kinematics_iterations, ~workspace_iterations and ~control_cycles.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+  ros::init(argc, argv, "shc_benchmark");
+  ros::NodeHandle private_n("~");
+
+  int kinematics_iterations;
+  int workspace_iterations;
+  int control_cycles;
+  private_n.param("kinematics_iterations", kinematics_iterations, DEFAULT_KINEMATICS_ITERATIONS);
+  private_n.param("workspace_iterations", workspace_iterations, DEFAULT_WORKSPACE_ITERATIONS);
+  private_n.param("control_cycles", control_cycles, DEFAULT_CONTROL_CYCLES);
+
+  StateController state;
+  state.init();
+  state.initModel(true);
+
+  std::shared_ptr<Model> model = state.getModel();
+  std::shared_ptr<WalkController> walker = state.getWalker();
+  int leg_count = model->getLegCount();
+  int joint_count = model->getJointStateStore()->getJointCount();
+
+  // Transition to RUNNING state as requested by user input
+  std_msgs::Int8 robot_state_msg;
+  robot_state_msg.data = RUNNING;
+  int startup_cycles = 0;
+  while (state.getRobotState() != RUNNING && startup_cycles < STARTUP_CYCLE_LIMIT && ros::ok())
+  {
+    state.robotStateCallback(robot_state_msg);
+    state.loop();
+    startup_cycles++;
+  }
+  if (state.getRobotState() != RUNNING)
+  {
+    ROS_FATAL("\nBenchmark failed to transition Syropod to RUNNING state within %d control cycles.\n",
+              STARTUP_CYCLE_LIMIT);
+    return 1;
+  }
+
+  std::cout << "\nBenchmarking " << state.getParameters().syropod_type.data << " model: "
+            << leg_count << " legs, " << joint_count << " joints\n\n";
+  std::cout << std::left << std::setw(36) << "function" << std::setw(20) << "scope" << std::right
+            << std::setw(10) << "calls" << std::setw(14) << "mean (usec)" << std::setw(14) << "calls/sec"
+            << std::setw(16) << "legs/sec" << std::endl;
+
+  // Benchmark forward kinematics (perturbing joint positions to force joint transform regeneration)
+  LegContainer::iterator leg_it;
+  JointContainer::iterator joint_it;
+  for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    std::string scope = leg->getIDName() + " (" + numberToString(leg->getJointCount()) + " DOF)";
+    double duration = timeIterations([&](const int& i)
+    {
+      double perturbation = (i % 2 == 0 ? FK_JOINT_PERTURBATION : -FK_JOINT_PERTURBATION);
+      for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+      {
+        joint_it->second->desired_position_ += perturbation;
+      }
+      leg->applyFK();
+    }, kinematics_iterations);
+    reportResult("Leg::applyFK", scope, kinematics_iterations, duration);
+  }
+
+  // Benchmark inverse kinematics tracking a small circular tip trajectory about the current tip pose
+  for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    std::string scope = leg->getIDName() + " (" + numberToString(leg->getJointCount()) + " DOF)";
+    Pose origin_tip_pose = leg->getCurrentTipPose();
+    double duration = timeIterations([&](const int& i)
+    {
+      double angle = 2.0 * M_PI * i / VELOCITY_INPUT_PERIOD;
+      Pose target_tip_pose = origin_tip_pose;
+      target_tip_pose.position_ += IK_TARGET_RADIUS * Eigen::Vector3d(cos(angle) - 1.0, sin(angle), 0.0);
+      leg->setDesiredTipPose(target_tip_pose, false);
+      leg->applyIK(true);
+    }, kinematics_iterations);
+    reportResult("Leg::applyIK", scope, kinematics_iterations, duration);
+
+    // Restore leg to original tip pose
+    leg->setDesiredTipPose(origin_tip_pose, false);
+    leg->applyIK(true);
+  }
+
+  // Benchmark workspace and walkspace generation
+  double duration = timeIterations([&](const int&) { model->generateWorkspaces(); }, workspace_iterations);
+  reportResult("Model::generateWorkspaces", "model", workspace_iterations, duration, leg_count);
+  duration = timeIterations([&](const int&) { walker->generateWalkspace(); }, workspace_iterations);
+  reportResult("WalkController::generateWalkspace", "model", workspace_iterations, duration, leg_count);
+
+  // Benchmark full control cycles in RUNNING state over scripted velocity inputs
+  geometry_msgs::Twist velocity_input;
+  duration = timeIterations([&](const int& i)
+  {
+    double phase = 2.0 * M_PI * i / VELOCITY_INPUT_PERIOD;
+    velocity_input.linear.x = sin(phase);
+    velocity_input.linear.y = 0.5 * sin(2.0 * phase);
+    velocity_input.angular.z = 0.5 * cos(phase);
+    state.bodyVelocityInputCallback(velocity_input);
+    state.loop();
+  }, control_cycles);
+  reportResult("StateController::loop", "RUNNING", control_cycles, duration, leg_count);
+
+  std::cout << std::endl;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
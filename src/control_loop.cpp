@@ -0,0 +1,240 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/control_loop.h"
+#include "syropod_highlevel_controller/real_time.h"
+
+#define ACQUISTION_TIME 10       ///< Max time controller will wait to acquire intitial joint states (seconds)
+#define SIMULATION_START_TIME 1.0 ///< Initial value of simulated clock in headless simulation (seconds)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int runControlLoop(StateController& state, const std::atomic<bool>& running)
+{
+  const Parameters& params = state.getParameters();
+  ros::CallbackQueue* callback_queue = state.getCallbackQueue();
+
+  bool set_logger_level_result = false;
+
+  if (params.console_verbosity.data == std::string("debug"))
+  {
+    set_logger_level_result = ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Debug);
+  }
+  else if (params.console_verbosity.data == "info")
+  {
+    set_logger_level_result = ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Info);
+  }
+  else if (params.console_verbosity.data == "warning")
+  {
+    set_logger_level_result = ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Warn);
+  }
+  else if (params.console_verbosity.data == "error")
+  {
+    set_logger_level_result = ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Error);
+  }
+  else if (params.console_verbosity.data == "fatal")
+  {
+    set_logger_level_result = ros::console::set_logger_level(ROSCONSOLE_DEFAULT_NAME, ros::console::levels::Fatal);
+  }
+
+  if (set_logger_level_result)
+  {
+    ros::console::notifyLoggerLevelsChanged();
+  }
+
+  // Set ros rate from params
+  ros::Rate r(roundToInt(1.0 / params.time_delta.data));
+
+  // Headless simulation steps the controller with a simulated clock, starting immediately using default joint positions
+  bool headless = params.headless_simulation.data;
+  ros::Time simulation_time(SIMULATION_START_TIME);
+  ros::WallTime simulation_start_time = ros::WallTime::now();
+  if (headless)
+  {
+    ros::Time::setNow(simulation_time);
+    std_msgs::Int8 system_state_msg;
+    system_state_msg.data = OPERATIONAL;
+    state.systemStateCallback(system_state_msg);
+    ROS_INFO("\nController started in headless simulation.\n");
+  }
+
+  // Wait specified time to aquire all published joint positions via callback
+  int spin = headless ? 0 : static_cast<int>(ACQUISTION_TIME / params.time_delta.data); // Spin cycles from time
+  while (spin-- && running)
+  {
+    ROS_INFO_THROTTLE(THROTTLE_PERIOD, "\nAcquiring robot state . . .\n");
+    // End wait if joints are intitialised or debugging in rviz (joint states will never initialise)
+    if (state.jointPositionsInitialised())
+    {
+      spin = 0;
+    }
+    callback_queue->callAvailable();
+    state.applyStagedInputs();
+    r.sleep();
+  }
+
+  // Set start message
+  std::string start_message;
+  bool use_default_joint_positions;
+  if (state.jointPositionsInitialised() && !headless)
+  {
+    start_message = "\nPress 'Logitech' button to start controller . . .\n";
+    use_default_joint_positions = false;
+  }
+  else
+  {
+    start_message = "\nPress 'Logitech' button to run controller initialising unknown positions to defaults . . .\n";
+    use_default_joint_positions = true;
+  }
+
+  // Loop waiting for start button press
+  while (state.getSystemState() == SUSPENDED && ros::ok() && running)
+  {
+    if (use_default_joint_positions)
+    {
+      ROS_WARN_THROTTLE(THROTTLE_PERIOD, "\nFailed to initialise joint position values!\n");
+    }
+    ROS_INFO_THROTTLE(THROTTLE_PERIOD, "%s", start_message.c_str());
+    callback_queue->callAvailable();
+    state.applyStagedInputs();
+    r.sleep();
+  }
+
+  // Shut down before start
+  if (!ros::ok() || !running)
+  {
+    return 0;
+  }
+
+  if (!headless)
+  {
+    ROS_INFO("\nController started. Press START/BACK buttons to transition state of robot.\n");
+  }
+
+  state.init(); // Must be initialised before initialising model with current joint state
+  state.initModel(use_default_joint_positions);
+
+  // Configure control thread for real time execution once controller memory is allocated
+  bool real_time = params.real_time_mode.data && !headless;
+  if (real_time)
+  {
+    initRealTime(params.real_time_core.data, params.real_time_priority.data);
+
+    // Control thread waits on leg update workers each cycle so workers must share its real time priority
+    std::shared_ptr<WorkerPool> worker_pool = state.getModel()->getWorkerPool();
+    if (worker_pool != NULL)
+    {
+      worker_pool->initRealTime(params.real_time_core.data, params.real_time_priority.data);
+    }
+  }
+
+  tf2_ros::Buffer transform_buffer_;
+  tf2_ros::TransformListener transform_listener(transform_buffer_);
+
+  // Main loop
+  std::shared_ptr<Profiler> profiler = state.getProfiler();
+  std_msgs::Int8 robot_state_msg;
+  robot_state_msg.data = RUNNING;
+  geometry_msgs::Twist velocity_msg;
+  if (headless && params.simulation_velocity.data.size() == 3)
+  {
+    velocity_msg.linear.x = params.simulation_velocity.data[0];
+    velocity_msg.linear.y = params.simulation_velocity.data[1];
+    velocity_msg.angular.z = params.simulation_velocity.data[2];
+  }
+  bool apply_simulation_velocity =
+      velocity_msg.linear.x != 0.0 || velocity_msg.linear.y != 0.0 || velocity_msg.angular.z != 0.0;
+  RealTimeRate real_time_rate(params.time_delta.data);
+  while (ros::ok() && running)
+  {
+    // Request transition to RUNNING state and apply scripted velocity input as if from user
+    if (headless)
+    {
+      if (state.getRobotState() != RUNNING)
+      {
+        state.robotStateCallback(robot_state_msg);
+      }
+      else if (apply_simulation_velocity)
+      {
+        state.bodyVelocityInputCallback(velocity_msg);
+      }
+    }
+
+    if (state.getSystemState() != SUSPENDED)
+    {
+      ScopedTimer timer(profiler.get(), CONTROL_CYCLE_TIMING);
+      state.loop();
+      if (params.threaded_telemetry.data)
+      {
+        state.updateTelemetry();
+      }
+      else
+      {
+        state.publishLegState();
+        state.publishVelocity();
+        state.publishPose();
+        state.publishWalkspace();
+        state.publishRotationPoseError();
+        state.publishFrameTransforms();
+      }
+
+      if (params.debug_rviz.data)
+      {
+        state.RVIZDebugging();
+      }
+
+      state.publishDesiredJointState();
+      state.publishTiming();
+
+      if (headless)
+      {
+        state.simulateJointStates();
+      }
+    }
+    else
+    {
+      ROS_INFO_THROTTLE(THROTTLE_PERIOD, "\nController suspended. Press Logitech button to resume . . .\n");
+    }
+
+    callback_queue->callAvailable();
+
+    // Advance simulated clock in lockstep with control loop rather than sleeping
+    if (headless)
+    {
+      simulation_time += ros::Duration(params.time_delta.data);
+      ros::Time::setNow(simulation_time);
+      double simulated_duration = simulation_time.toSec() - SIMULATION_START_TIME;
+      if (params.simulation_duration.data > 0.0 && simulated_duration >= params.simulation_duration.data)
+      {
+        double wall_duration = (ros::WallTime::now() - simulation_start_time).toSec();
+        ROS_INFO("\nHeadless simulation complete. Simulated %.1fs in %.1fs (%.1fx real time).\n",
+                 simulated_duration, wall_duration, simulated_duration / wall_duration);
+        break;
+      }
+    }
+    // Sleep until absolute deadline in real time mode, recording wake up jitter
+    else if (real_time)
+    {
+      double jitter = real_time_rate.sleep();
+      if (profiler->isEnabled())
+      {
+        profiler->addSample(WAKEUP_JITTER_TIMING, jitter);
+      }
+    }
+    else
+    {
+      r.sleep();
+    }
+  }
+
+  profiler->dump();
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -28,19 +28,85 @@ DebugVisualiser::DebugVisualiser(void)
   tip_rotation_publisher_ = n.advertise<visualization_msgs::Marker>("/shc/debug/tip_rotation", 1000);
   gravity_publisher_ = n.advertise<visualization_msgs::Marker>("/shc/debug/gravity", 1000);
   terrain_publisher_ = n.advertise<visualization_msgs::Marker>("/shc/debug/terrain", 1000);
+
+  layer_publishers_[ROBOT_MODEL_LAYER] = &robot_model_publisher_;
+  layer_publishers_[GRAVITY_LAYER] = &gravity_publisher_;
+  layer_publishers_[WALK_PLANE_LAYER] = &walk_plane_publisher_;
+  layer_publishers_[TERRAIN_LAYER] = &terrain_publisher_;
+  layer_publishers_[TIP_TRAJECTORY_LAYER] = &tip_trajectory_publisher_;
+  layer_publishers_[JOINT_TORQUE_LAYER] = &joint_torque_publisher_;
+  layer_publishers_[DEFAULT_TIP_POSITION_LAYER] = &default_tip_position_publisher_;
+  layer_publishers_[TARGET_TIP_POSITION_LAYER] = &target_tip_position_publisher_;
+  layer_publishers_[WORKSPACE_LAYER] = &workspace_publisher_;
+  layer_publishers_[WALKSPACE_LAYER] = &walkspace_publisher_;
+  layer_publishers_[BEZIER_CURVE_LAYER] = &bezier_curve_publisher_;
+  layer_publishers_[STRIDE_LAYER] = &stride_publisher_;
+  layer_publishers_[TIP_FORCE_LAYER] = &tip_force_publisher_;
+  std::fill(rate_divisors_, rate_divisors_ + DEBUG_LAYER_COUNT, 1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void DebugVisualiser::generateRobotModel(std::shared_ptr<Model> model)
+void DebugVisualiser::setRateDivisors(const std::map<std::string, int>& rate_divisors)
+{
+  const std::string layer_names[DEBUG_LAYER_COUNT] =
+      {"robot_model", "gravity", "walk_plane", "terrain", "tip_trajectories", "joint_torque", "default_tip_positions",
+       "target_tip_positions", "workspace", "walkspace", "bezier_curves", "stride", "tip_force"};
+  for (int i = 0; i < DEBUG_LAYER_COUNT; ++i)
+  {
+    int divisor = 1;
+    if (rate_divisors.count(layer_names[i]))
+    {
+      divisor = std::max(1, rate_divisors.at(layer_names[i]));
+    }
+    rate_divisors_[i] = divisor;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DebugVisualiser::advanceCycle(std::shared_ptr<Model> model)
 {
+  cycle_++;
+
   // Estimate of robot body length used in scaling markers
   if (marker_scale_ == 0)
   {
     marker_scale_ = model->getLegByIDNumber(0)->getJointByIDNumber(1)->getPoseRobotFrame().position_.norm() * 2.0;
   }
-  
-  visualization_msgs::Marker leg_line_list;
+
+  // Republish static markers to newly connected subscribers (e.g. on restart of rviz)
+  uint32_t workspace_subscriber_count = workspace_publisher_.getNumSubscribers();
+  uint32_t walkspace_subscriber_count = walkspace_publisher_.getNumSubscribers();
+  std::map<int, StaticMarkerState>::iterator state_it;
+  for (state_it = static_marker_states_.begin(); state_it != static_marker_states_.end(); ++state_it)
+  {
+    if (workspace_subscriber_count > workspace_subscriber_count_)
+    {
+      state_it->second.workspace_published_ = false;
+    }
+    if (walkspace_subscriber_count > walkspace_subscriber_count_)
+    {
+      state_it->second.walkspace_published_ = false;
+    }
+  }
+  workspace_subscriber_count_ = workspace_subscriber_count;
+  walkspace_subscriber_count_ = walkspace_subscriber_count;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool DebugVisualiser::isLayerDue(const DebugLayer& layer)
+{
+  return (cycle_ % rate_divisors_[layer] == 0) && layer_publishers_[layer]->getNumSubscribers() > 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void DebugVisualiser::generateRobotModel(std::shared_ptr<Model> model)
+{
+  visualization_msgs::Marker& leg_line_list = robot_model_marker_;
+  leg_line_list.points.clear();
   leg_line_list.header.frame_id = "/base_link";
   leg_line_list.header.stamp = ros::Time(0);
   leg_line_list.ns = "robot_model";
@@ -168,7 +234,8 @@ void DebugVisualiser::generateWalkPlane(const Eigen::Vector3d& walk_plane, const
 
 void DebugVisualiser::generateTipTrajectory(std::shared_ptr<Leg> leg)
 {
-  visualization_msgs::Marker tip_position_marker;
+  visualization_msgs::Marker& tip_position_marker = tip_trajectory_marker_;
+  tip_position_marker.points.clear();
   tip_position_marker.header.frame_id = "/base_link";
   tip_position_marker.header.stamp = ros::Time::now();
   tip_position_marker.ns = "tip_trajectory_markers";
@@ -235,7 +302,8 @@ void DebugVisualiser::generateTerrainEstimate(std::shared_ptr<Model> model)
 
 void DebugVisualiser::generateBezierCurves(std::shared_ptr<Leg> leg)
 {
-  visualization_msgs::Marker swing_1_nodes;
+  visualization_msgs::Marker& swing_1_nodes = bezier_swing_1_marker_;
+  swing_1_nodes.points.clear();
   swing_1_nodes.header.frame_id = "/walk_plane";
   swing_1_nodes.header.stamp = ros::Time::now();
   swing_1_nodes.ns = "primary_swing_control_nodes";
@@ -249,7 +317,8 @@ void DebugVisualiser::generateBezierCurves(std::shared_ptr<Leg> leg)
   swing_1_nodes.color.a = 0.5;
   swing_1_nodes.pose = Pose::Identity().toPoseMessage();
 
-  visualization_msgs::Marker swing_2_nodes;
+  visualization_msgs::Marker& swing_2_nodes = bezier_swing_2_marker_;
+  swing_2_nodes.points.clear();
   swing_2_nodes.header.frame_id = "/walk_plane";
   swing_2_nodes.header.stamp = ros::Time::now();
   swing_2_nodes.ns = "secondary_swing_control_nodes";
@@ -263,7 +332,8 @@ void DebugVisualiser::generateBezierCurves(std::shared_ptr<Leg> leg)
   swing_2_nodes.color.a = 0.5;
   swing_2_nodes.pose = Pose::Identity().toPoseMessage();
 
-  visualization_msgs::Marker stance_nodes;
+  visualization_msgs::Marker& stance_nodes = bezier_stance_marker_;
+  stance_nodes.points.clear();
   stance_nodes.header.frame_id = "/walk_plane";
   stance_nodes.header.stamp = ros::Time::now();
   stance_nodes.ns = "stance_control_nodes";
@@ -367,8 +437,24 @@ void DebugVisualiser::generateTargetTipPositions(std::shared_ptr<Leg> leg)
 void DebugVisualiser::generateWalkspace(std::shared_ptr<Leg> leg, const LimitMap& walkspace)
 {
   std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+  Eigen::Vector3d walkspace_origin = leg_stepper->getDefaultTipPose().position_;
+  Eigen::Vector3d walk_plane_normal = leg_stepper->getWalkPlaneNormal();
+
+  // Republish only if walkspace has changed since last published
+  StaticMarkerState& state = static_marker_states_[leg->getIDNumber()];
+  if (state.walkspace_published_ && state.walkspace_ == walkspace &&
+      (state.walkspace_origin_ - walkspace_origin).norm() < STATIC_MARKER_TOLERANCE &&
+      (state.walk_plane_normal_ - walk_plane_normal).norm() < STATIC_MARKER_TOLERANCE)
+  {
+    return;
+  }
+  state.walkspace_ = walkspace;
+  state.walkspace_origin_ = walkspace_origin;
+  state.walk_plane_normal_ = walk_plane_normal;
+  state.walkspace_published_ = true;
   
-  visualization_msgs::Marker walkspace_marker;
+  visualization_msgs::Marker& walkspace_marker = walkspace_marker_;
+  walkspace_marker.points.clear();
   walkspace_marker.header.frame_id = "/walk_plane";
   walkspace_marker.header.stamp = ros::Time::now();
   walkspace_marker.ns = "walkspace_markers";
@@ -379,17 +465,14 @@ void DebugVisualiser::generateWalkspace(std::shared_ptr<Leg> leg, const LimitMap
   walkspace_marker.color.g = 1;
   walkspace_marker.color.b = 1;
   walkspace_marker.color.a = 1;
-  Pose pose(Eigen::Vector3d::Zero(), Eigen::Quaterniond::FromTwoVectors(Eigen::Vector3d::UnitZ(),
-                                                                        leg_stepper->getWalkPlaneNormal()));
+  Pose pose(Eigen::Vector3d::Zero(), Eigen::Quaterniond::FromTwoVectors(Eigen::Vector3d::UnitZ(), walk_plane_normal));
   walkspace_marker.pose = pose.toPoseMessage();
   geometry_msgs::Point origin_point;
-  Eigen::Vector3d walkspace_origin = leg_stepper->getDefaultTipPose().position_;
-  walkspace_origin = pose.inverseTransformVector(walkspace_origin);
-  origin_point.x = walkspace_origin[0];
-  origin_point.y = walkspace_origin[1];
-  origin_point.z = walkspace_origin[2];
+  Eigen::Vector3d walkspace_plane_origin = pose.inverseTransformVector(walkspace_origin);
+  origin_point.x = walkspace_plane_origin[0];
+  origin_point.y = walkspace_plane_origin[1];
+  origin_point.z = walkspace_plane_origin[2];
   
-  geometry_msgs::Point first_point;
   LimitMap::const_iterator it;
   for (it = walkspace.begin(); it != walkspace.end(); ++it)
   {
@@ -399,10 +482,6 @@ void DebugVisualiser::generateWalkspace(std::shared_ptr<Leg> leg, const LimitMap
       point.x = origin_point.x + it->second * cos(degreesToRadians(it->first));
       point.y = origin_point.y + it->second * sin(degreesToRadians(it->first));
       point.z = origin_point.z;
-      if (it->first == 0)
-      {
-        first_point = point;
-      }
       walkspace_marker.points.push_back(point);
     }
   }
@@ -413,13 +492,26 @@ void DebugVisualiser::generateWalkspace(std::shared_ptr<Leg> leg, const LimitMap
 
 void DebugVisualiser::generateWorkspace(std::shared_ptr<Leg> leg, const double& body_clearance)
 {
-  Workspace workspace = leg->getWorkspace();
+  const Workspace& workspace = leg->getWorkspace();
   std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+  Eigen::Vector3d identity_tip_position =
+    leg_stepper->getIdentityTipPose().position_ - Eigen::Vector3d::UnitZ() * body_clearance;
+
+  // Republish only if workspace has changed since last published
+  StaticMarkerState& state = static_marker_states_[leg->getIDNumber()];
+  if (state.workspace_published_ && state.workspace_ == workspace &&
+      (state.workspace_origin_ - identity_tip_position).norm() < STATIC_MARKER_TOLERANCE)
+  {
+    return;
+  }
+  state.workspace_ = workspace;
+  state.workspace_origin_ = identity_tip_position;
+  state.workspace_published_ = true;
   
-  visualization_msgs::MarkerArray workspace_cage_marker_array;
   std::map<int, visualization_msgs::Marker> workspace_cage_markers;
+  workspace_marker_array_.markers.clear();
+  workspace_cage_marker_array_.markers.clear();
   
-  visualization_msgs::MarkerArray workspace_marker_array;
   visualization_msgs::Marker workspace_marker;
   workspace_marker.header.frame_id = "/base_link";
   workspace_marker.header.stamp = ros::Time(0);
@@ -436,11 +528,9 @@ void DebugVisualiser::generateWorkspace(std::shared_ptr<Leg> leg, const double&
   for (workspace_it = workspace.begin(); workspace_it != workspace.end(); ++workspace_it, ++workspace_id)
   {
     double plane_height = workspace_it->first;
-    Workplane workplane = workspace_it->second;
+    const Workplane& workplane = workspace_it->second;
     workspace_marker.id = workspace_id;
     geometry_msgs::Point origin_point;
-    Eigen::Vector3d identity_tip_position = leg_stepper->getIdentityTipPose().position_ - 
-    Eigen::Vector3d::UnitZ() * body_clearance;
     Eigen::Vector3d workplane_origin = identity_tip_position + Eigen::Vector3d::UnitZ() * plane_height;
     origin_point.x = workplane_origin[0];
     origin_point.y = workplane_origin[1];
@@ -471,6 +561,7 @@ void DebugVisualiser::generateWorkspace(std::shared_ptr<Leg> leg, const double&
           visualization_msgs::Marker workspace_cage_marker = workspace_marker;
           workspace_cage_marker.ns = leg->getIDName() + "_workspace_markers";
           workspace_cage_marker.id = bearing;
+          workspace_cage_marker.points.clear();
           workspace_cage_markers.insert(std::map<int, visualization_msgs::Marker>::value_type(bearing,
           workspace_cage_marker));
         }
@@ -479,19 +570,19 @@ void DebugVisualiser::generateWorkspace(std::shared_ptr<Leg> leg, const double&
     }
     
     workspace_marker.points.push_back(first_point);
-    workspace_marker_array.markers.push_back(workspace_marker);
+    workspace_marker_array_.markers.push_back(workspace_marker);
     workspace_marker.points.clear();
-    
-    // Publish workspace cage markers
-    std::map<int, visualization_msgs::Marker>::iterator cage_it;
-    for (cage_it = workspace_cage_markers.begin(); cage_it != workspace_cage_markers.end(); ++cage_it)
-    {
-      workspace_cage_marker_array.markers.push_back(cage_it->second);
-    }
   }
   
-  workspace_publisher_.publish(workspace_marker_array);
-  workspace_publisher_.publish(workspace_cage_marker_array);
+  // Publish workspace cage markers once all workplanes are connected
+  std::map<int, visualization_msgs::Marker>::iterator cage_it;
+  for (cage_it = workspace_cage_markers.begin(); cage_it != workspace_cage_markers.end(); ++cage_it)
+  {
+    workspace_cage_marker_array_.markers.push_back(cage_it->second);
+  }
+  
+  workspace_publisher_.publish(workspace_marker_array_);
+  workspace_publisher_.publish(workspace_cage_marker_array_);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -587,7 +678,7 @@ void DebugVisualiser::generateJointTorques(std::shared_ptr<Leg> leg)
   for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
   {
     std::shared_ptr<Joint> joint = joint_it->second;
-    visualization_msgs::Marker joint_torque;
+    visualization_msgs::Marker& joint_torque = joint_torque_marker_;
     joint_torque.header.frame_id = "/base_link";
     joint_torque.header.stamp = ros::Time::now();
     joint_torque.ns = "joint_torque_markers";
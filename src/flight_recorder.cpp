@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/flight_recorder.h"
+
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/mman.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FlightRecorder::FlightRecorder(std::shared_ptr<Model> model, const int& capacity, const std::string& file_prefix)
+  : records_(std::max(1, capacity))
+  , flush_records_(std::max(1, capacity))
+  , file_prefix_(file_prefix)
+{
+  // Describe recorded legs (records of legs beyond the maximum are not written)
+  memset(&header_, 0, sizeof(header_));
+  header_.magic_ = FLIGHT_RECORDER_MAGIC;
+  header_.version_ = FLIGHT_RECORDER_VERSION;
+  header_.record_size_ = sizeof(FlightRecord);
+  header_.leg_count_ = std::min(model->getLegCount(), FLIGHT_RECORDER_MAX_LEGS);
+  LegContainer::iterator leg_it;
+  for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    if (leg->getIDNumber() < FLIGHT_RECORDER_MAX_LEGS)
+    {
+      header_.joint_counts_[leg->getIDNumber()] = std::min(leg->getJointCount(), MAX_LEG_JOINTS);
+      strncpy(header_.leg_names_[leg->getIDNumber()], leg->getIDName().c_str(), FLIGHT_RECORDER_NAME_LENGTH - 1);
+    }
+  }
+  flush_thread_ = std::thread(&FlightRecorder::run, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+FlightRecorder::~FlightRecorder(void)
+{
+  running_ = false;
+  if (flush_thread_.joinable())
+  {
+    flush_thread_.join();
+  }
+  flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void FlightRecorder::run(void)
+{
+  while (running_)
+  {
+    std::this_thread::sleep_for(std::chrono::duration<double>(FLIGHT_RECORDER_POLL_PERIOD));
+    if (flush_requested_.exchange(false))
+    {
+      flush();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool FlightRecorder::flush(void)
+{
+  std::lock_guard<std::mutex> lock(flush_mutex_);
+
+  // Copy records held by ring buffer, oldest first
+  uint64_t capacity = records_.size();
+  uint64_t head = head_.load(std::memory_order_acquire);
+  uint64_t first = (head > capacity ? head - capacity : 0);
+  for (uint64_t i = first; i < head; ++i)
+  {
+    flush_records_[i - first] = records_[i % capacity];
+  }
+
+  // Discard records which the control thread may have overwritten during the copy (i.e. the oldest records)
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t overwrite_head = head_.load(std::memory_order_relaxed) + 1;
+  uint64_t first_valid = std::max(first, overwrite_head > capacity ? overwrite_head - capacity : 0);
+  if (first_valid >= head)
+  {
+    ROS_WARN("\n[SHC] No flight records available to flush.\n");
+    return false;
+  }
+  uint64_t record_count = head - first_valid;
+  const FlightRecord* valid_records = &flush_records_[first_valid - first];
+
+  // Write records to temporary memory mapped file
+  std::string directory = getROSHomePath() + "/shc/flight_recorder/";
+  std::string file_path = directory + file_prefix_ + "_" + numberToString(ros::WallTime::now().sec) + "_" +
+                          numberToString(flush_count_++) + ".bin";
+  std::string temporary_file_path = file_path + ".tmp";
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  int file = open(temporary_file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  size_t file_size = sizeof(FlightRecorderHeader) + record_count * sizeof(FlightRecord);
+  if (error || file < 0 || ftruncate(file, file_size) != 0)
+  {
+    ROS_WARN("\n[SHC] Unable to write flight record file %s.\n", file_path.c_str());
+    if (file >= 0)
+    {
+      close(file);
+    }
+    return false;
+  }
+  void* data = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+  bool written = (data != MAP_FAILED);
+  if (written)
+  {
+    FlightRecorderHeader header = header_;
+    header.record_count_ = record_count;
+    char* destination = static_cast<char*>(data);
+    memcpy(destination, &header, sizeof(header));
+    memcpy(destination + sizeof(header), valid_records, record_count * sizeof(FlightRecord));
+    written = (msync(data, file_size, MS_SYNC) == 0);
+    munmap(data, file_size);
+  }
+  close(file);
+
+  // Move completed file into place so partially written files are never read
+  std::filesystem::rename(temporary_file_path, file_path, error);
+  if (!written || error)
+  {
+    ROS_WARN("\n[SHC] Unable to write flight record file %s.\n", file_path.c_str());
+    return false;
+  }
+  ROS_INFO("\n[SHC] Flushed %lu flight records to %s.\n", static_cast<unsigned long>(record_count), file_path.c_str());
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
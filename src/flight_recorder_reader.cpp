@@ -0,0 +1,148 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/flight_recorder.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Writes the CSV column names of a pose record.
+/// @param[in] stream The output stream
+/// @param[in] name The name of the recorded pose
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void writePoseHeader(std::ofstream& stream, const std::string& name)
+{
+  stream << "," << name << "_x," << name << "_y," << name << "_z";
+  stream << "," << name << "_qw," << name << "_qx," << name << "_qy," << name << "_qz";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Writes the CSV values of a pose record.
+/// @param[in] stream The output stream
+/// @param[in] record The pose record
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void writePose(std::ofstream& stream, const PoseRecord& record)
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    stream << "," << record.position_[i];
+  }
+  for (int i = 0; i < 4; ++i)
+  {
+    stream << "," << record.rotation_[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Flight recorder reader executable. Converts a flight record file flushed by the flight recorder into CSV, with one
+/// row per recorded control cycle.
+/// Usage: flight_recorder_reader <flight record file> [output CSV file (default: <flight record file>.csv)]
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Usage: " << argv[0] << " <flight record file> [output CSV file]" << std::endl;
+    return 1;
+  }
+  std::string input_path = argv[1];
+  std::string output_path = (argc > 2 ? argv[2] : input_path + ".csv");
+
+  // Read and validate header
+  std::ifstream input(input_path, std::ios::binary);
+  FlightRecorderHeader header;
+  if (!input || !input.read(reinterpret_cast<char*>(&header), sizeof(header)))
+  {
+    std::cerr << "Unable to read flight record file " << input_path << std::endl;
+    return 1;
+  }
+  bool valid_joint_counts = true;
+  for (uint32_t i = 0; i < FLIGHT_RECORDER_MAX_LEGS && i < header.leg_count_; ++i)
+  {
+    valid_joint_counts = valid_joint_counts && header.joint_counts_[i] <= uint32_t(MAX_LEG_JOINTS);
+  }
+  if (header.magic_ != FLIGHT_RECORDER_MAGIC || header.version_ != FLIGHT_RECORDER_VERSION ||
+      header.record_size_ != sizeof(FlightRecord) || header.leg_count_ > FLIGHT_RECORDER_MAX_LEGS ||
+      !valid_joint_counts)
+  {
+    std::cerr << "File " << input_path << " is not a compatible flight record file (version "
+              << FLIGHT_RECORDER_VERSION << ")" << std::endl;
+    return 1;
+  }
+
+  std::ofstream output(output_path);
+  if (!output)
+  {
+    std::cerr << "Unable to write CSV file " << output_path << std::endl;
+    return 1;
+  }
+
+  // Write column names
+  output << "cycle,time,robot_state,walk_state";
+  for (int i = 0; i < FLIGHT_RECORD_POSE_COUNT; ++i)
+  {
+    writePoseHeader(output, getFlightRecordPoseName(static_cast<FlightRecordPose>(i)));
+  }
+  for (uint32_t i = 0; i < header.leg_count_; ++i)
+  {
+    std::string leg_name(header.leg_names_[i], strnlen(header.leg_names_[i], FLIGHT_RECORDER_NAME_LENGTH));
+    for (uint32_t j = 0; j < header.joint_counts_[i]; ++j)
+    {
+      output << "," << leg_name << "_joint_" << j + 1 << "_desired_position";
+      output << "," << leg_name << "_joint_" << j + 1 << "_current_position";
+    }
+    writePoseHeader(output, leg_name + "_desired_tip_pose");
+    writePoseHeader(output, leg_name + "_current_tip_pose");
+    output << "," << leg_name << "_admittance_delta_x," << leg_name << "_admittance_delta_y,"
+           << leg_name << "_admittance_delta_z";
+    output << "," << leg_name << "_phase," << leg_name << "_step_state," << leg_name << "_leg_state";
+  }
+  output << "\n";
+
+  // Write each record
+  output << std::setprecision(9);
+  FlightRecord record;
+  uint64_t record_count = 0;
+  while (record_count < header.record_count_ && input.read(reinterpret_cast<char*>(&record), sizeof(record)))
+  {
+    output << record.cycle_ << "," << record.time_ << "," << record.robot_state_ << "," << record.walk_state_;
+    for (int i = 0; i < FLIGHT_RECORD_POSE_COUNT; ++i)
+    {
+      writePose(output, record.poses_[i]);
+    }
+    for (uint32_t i = 0; i < header.leg_count_; ++i)
+    {
+      const LegRecord& leg_record = record.legs_[i];
+      for (uint32_t j = 0; j < header.joint_counts_[i]; ++j)
+      {
+        output << "," << leg_record.desired_joint_positions_[j] << "," << leg_record.current_joint_positions_[j];
+      }
+      writePose(output, leg_record.desired_tip_pose_);
+      writePose(output, leg_record.current_tip_pose_);
+      for (int j = 0; j < 3; ++j)
+      {
+        output << "," << leg_record.admittance_delta_[j];
+      }
+      output << "," << leg_record.phase_ << "," << leg_record.step_state_ << "," << leg_record.leg_state_;
+    }
+    output << "\n";
+    record_count++;
+  }
+
+  if (record_count < header.record_count_)
+  {
+    std::cerr << "Flight record file " << input_path << " truncated: read " << record_count << " of "
+              << header.record_count_ << " records" << std::endl;
+  }
+  std::cout << "Wrote " << record_count << " records to " << output_path << std::endl;
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
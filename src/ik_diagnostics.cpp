@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/ik_diagnostics.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+IKDiagnosticsReporter::IKDiagnosticsReporter(std::shared_ptr<Model> model, const double& report_period,
+                                             const bool& log_warnings, const std::string& hardware_id)
+  : model_(model)
+  , report_period_(report_period)
+  , log_warnings_(log_warnings)
+{
+  report_divisor_ = std::max(1, roundToInt(report_period / model_->getTimeDelta()));
+  report_period_ = report_divisor_ * model_->getTimeDelta();
+
+  // Preallocate snapshots
+  int joint_count = model_->getJointStateStore()->getJointCount();
+  int leg_count = model_->getLegCount();
+  IKDiagnosticsSnapshot snapshot;
+  snapshot.joints_.assign(joint_count, JointDiagnostics());
+  snapshot.legs_.assign(leg_count, LegDiagnostics());
+  snapshot_buffer_ = std::make_shared<SnapshotBuffer<IKDiagnosticsSnapshot>>(snapshot);
+
+  // Generate names of each joint and leg and a diagnostics status for each leg
+  const std::string axis_labels[3] = { "x", "y", "z" };
+  joint_names_.assign(joint_count, std::string());
+  leg_names_.assign(leg_count, std::string());
+  leg_joint_offsets_.assign(leg_count, 0);
+  leg_joint_counts_.assign(leg_count, 0);
+  diagnostics_msg_.status.assign(leg_count, diagnostic_msgs::DiagnosticStatus());
+  LegContainer::iterator leg_it;
+  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    int leg_id = leg->getIDNumber();
+    leg_names_[leg_id] = leg->getIDName();
+    leg_joint_offsets_[leg_id] = leg->getJointStateOffset();
+    leg_joint_counts_[leg_id] = leg->getJointCount();
+
+    diagnostic_msgs::DiagnosticStatus& status = diagnostics_msg_.status[leg_id];
+    status.name = "shc: " + leg->getIDName() + " kinematics";
+    status.hardware_id = hardware_id;
+    int index = leg->getJointStateOffset();
+    JointContainer::iterator joint_it;
+    for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+    {
+      std::string joint_name = joint_it->second->id_name_;
+      joint_names_[index++] = joint_name;
+      diagnostic_msgs::KeyValue value;
+      value.key = joint_name + " velocity clamps";
+      status.values.push_back(value);
+      value.key = joint_name + " max velocity excess (rad/s)";
+      status.values.push_back(value);
+      value.key = joint_name + " position clamps";
+      status.values.push_back(value);
+      value.key = joint_name + " max position excess (rad)";
+      status.values.push_back(value);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      diagnostic_msgs::KeyValue value;
+      value.key = "tip " + axis_labels[i] + " deviations";
+      status.values.push_back(value);
+      value.key = "tip " + axis_labels[i] + " max deviation (m)";
+      status.values.push_back(value);
+    }
+  }
+
+  ros::NodeHandle n;
+  diagnostics_publisher_ = n.advertise<diagnostic_msgs::DiagnosticArray>("/diagnostics", 1);
+  report_thread_ = std::thread(&IKDiagnosticsReporter::run, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+IKDiagnosticsReporter::~IKDiagnosticsReporter(void)
+{
+  running_ = false;
+  if (report_thread_.joinable())
+  {
+    report_thread_.join();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void IKDiagnosticsReporter::update(void)
+{
+  if (++cycle_ % report_divisor_ != 0)
+  {
+    return;
+  }
+
+  // Copy fixed size event records into preallocated snapshot and reset for next reporting period
+  IKDiagnosticsSnapshot& snapshot = snapshot_buffer_->getBack();
+  const std::vector<JointDiagnostics>& joint_diagnostics = model_->getJointStateStore()->diagnostics_;
+  std::copy(joint_diagnostics.begin(), joint_diagnostics.end(), snapshot.joints_.begin());
+  LegContainer::iterator leg_it;
+  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    snapshot.legs_[leg->getIDNumber()] = leg->getDiagnostics();
+    leg->resetDiagnostics();
+  }
+  snapshot.period_ = report_period_;
+  snapshot_buffer_->commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void IKDiagnosticsReporter::run(void)
+{
+  while (running_)
+  {
+    std::this_thread::sleep_for(std::chrono::duration<double>(IK_DIAGNOSTICS_POLL_PERIOD));
+    if (snapshot_buffer_->update())
+    {
+      report(snapshot_buffer_->getFront());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void IKDiagnosticsReporter::report(const IKDiagnosticsSnapshot& snapshot)
+{
+  const std::string axis_labels[3] = { "x", "y", "z" };
+  std::string events;
+  for (uint32_t leg_id = 0; leg_id < leg_names_.size(); ++leg_id)
+  {
+    diagnostic_msgs::DiagnosticStatus& status = diagnostics_msg_.status[leg_id];
+    uint32_t clamp_count = 0;
+    uint32_t deviation_count = 0;
+    int value_index = 0;
+    for (int i = 0; i < leg_joint_counts_[leg_id]; ++i)
+    {
+      int index = leg_joint_offsets_[leg_id] + i;
+      const JointDiagnostics& joint = snapshot.joints_[index];
+      status.values[value_index++].value = numberToString(joint.velocity_clamp_count_);
+      status.values[value_index++].value = numberToString(joint.max_velocity_excess_);
+      status.values[value_index++].value = numberToString(joint.position_clamp_count_);
+      status.values[value_index++].value = numberToString(joint.max_position_excess_);
+      clamp_count += joint.velocity_clamp_count_ + joint.position_clamp_count_;
+      if (joint.velocity_clamp_count_ > 0)
+      {
+        events += stringFormat("\n\tType: Velocity\tJoint: %s\tCycles: %u\tMax excess: %f rad/s",
+                               joint_names_[index].c_str(), joint.velocity_clamp_count_, joint.max_velocity_excess_);
+      }
+      if (joint.position_clamp_count_ > 0)
+      {
+        events += stringFormat("\n\tType: Position\tJoint: %s\tCycles: %u\tMax excess: %f rad",
+                               joint_names_[index].c_str(), joint.position_clamp_count_, joint.max_position_excess_);
+      }
+    }
+
+    const LegDiagnostics& leg = snapshot.legs_[leg_id];
+    for (int i = 0; i < 3; ++i)
+    {
+      status.values[value_index++].value = numberToString(leg.deviation_counts_[i]);
+      status.values[value_index++].value = numberToString(leg.max_deviations_[i]);
+      deviation_count += leg.deviation_counts_[i];
+      if (leg.deviation_counts_[i] > 0)
+      {
+        events += stringFormat("\n\tType: IK deviation\tLeg: %s\tAxis: %s\tCycles: %u\tMax deviation: %f m",
+                               leg_names_[leg_id].c_str(), axis_labels[i].c_str(),
+                               leg.deviation_counts_[i], leg.max_deviations_[i]);
+      }
+    }
+
+    if (clamp_count == 0 && deviation_count == 0)
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::OK;
+      status.message = "No clamping or IK deviation events";
+    }
+    else
+    {
+      status.level = diagnostic_msgs::DiagnosticStatus::WARN;
+      status.message = stringFormat("%u clamping and %u IK deviation events in %.1fs",
+                                    clamp_count, deviation_count, snapshot.period_);
+    }
+  }
+
+  diagnostics_msg_.header.stamp = ros::Time::now();
+  diagnostics_publisher_.publish(diagnostics_msg_);
+
+  if (log_warnings_ && !events.empty())
+  {
+    ROS_WARN("\nIK Clamping/Deviation Event/s over last %.1fs:%s\n", snapshot.period_, events.c_str());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
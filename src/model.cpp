@@ -13,6 +13,69 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+JointStateStore::JointStateStore(const int &joint_count)
+    : desired_positions_(joint_count, 0.0)
+    , desired_velocities_(joint_count, 0.0)
+    , desired_efforts_(joint_count, 0.0)
+    , prev_desired_positions_(joint_count, 0.0)
+    , prev_desired_velocities_(joint_count, 0.0)
+    , prev_desired_efforts_(joint_count, 0.0)
+    , current_positions_(joint_count, UNASSIGNED_VALUE)
+    , current_velocities_(joint_count, 0.0)
+    , current_efforts_(joint_count, 0.0)
+    , default_positions_(joint_count, UNASSIGNED_VALUE)
+    , default_velocities_(joint_count, 0.0)
+    , default_efforts_(joint_count, 0.0)
+    , min_positions_(joint_count, 0.0)
+    , max_positions_(joint_count, 0.0)
+    , offsets_(joint_count, 0.0)
+    , max_angular_speeds_(joint_count, 0.0)
+    , diagnostics_(joint_count)
+    , joint_count_(joint_count)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkspaceGrid::generate(const Workspace &workspace)
+{
+  radii_.clear();
+  if (workspace.empty())
+  {
+    layer_count_ = 0;
+    return;
+  }
+
+  min_height_ = workspace.begin()->first;
+  max_height_ = workspace.rbegin()->first;
+  layer_count_ = (workspace.size() == 1) ? 2 : WORKSPACE_GRID_LAYERS;
+  layer_spacing_ = (workspace.size() == 1) ? 1.0 : (max_height_ - min_height_) / (layer_count_ - 1);
+  radii_.resize(layer_count_ * WORKSPACE_GRID_BEARINGS, 0.0);
+
+  // Resample each uniformly spaced layer from bounding existing workplanes within workspace
+  for (int layer = 0; layer < layer_count_; ++layer)
+  {
+    double height = (layer == layer_count_ - 1) ? max_height_ : min_height_ + layer * layer_spacing_;
+    Workspace::const_iterator upper_bound_it = workspace.lower_bound(height);
+    if (upper_bound_it == workspace.end())
+    {
+      --upper_bound_it;
+    }
+    Workspace::const_iterator lower_bound_it = (upper_bound_it == workspace.begin()) ? upper_bound_it
+                                                                                      : prev(upper_bound_it);
+    double height_range = upper_bound_it->first - lower_bound_it->first;
+    double i = (height_range > 0.0) ? (height - lower_bound_it->first) / height_range : 0.0;
+    for (int column = 0; column < WORKSPACE_GRID_BEARINGS; ++column)
+    {
+      int bearing = column * BEARING_STEP;
+      double radius = interpolate(lower_bound_it->second.at(bearing), upper_bound_it->second.at(bearing), i);
+      radii_[layer * WORKSPACE_GRID_BEARINGS + column] = radius;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 Model::Model(const Parameters &params, std::shared_ptr<DebugVisualiser> debug_visualiser)
     : params_(params)
     , debug_visualiser_(debug_visualiser)
@@ -24,12 +87,27 @@ Model::Model(const Parameters &params, std::shared_ptr<DebugVisualiser> debug_vi
   imu_data_.orientation = UNDEFINED_ROTATION;
   imu_data_.linear_acceleration = Eigen::Vector3d::Zero();
   imu_data_.angular_velocity = Eigen::Vector3d::Zero();
+
+  // Allocate contiguous state storage for the joints of all legs
+  int joint_count = 0;
+  for (int i = 0; i < leg_count_; ++i)
+  {
+    joint_count += params_.leg_DOF.data.at(params_.leg_id.data.at(i));
+  }
+  joint_state_store_ = std::make_shared<JointStateStore>(joint_count);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Model::Model(std::shared_ptr<Model> model)
-    : params_(model->params_)
+    : Model(model, model->params_)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Model::Model(std::shared_ptr<Model> model, const Parameters &params)
+    : params_(params)
     , debug_visualiser_(model->debug_visualiser_)
     , leg_count_(model->leg_count_)
     , time_delta_(model->time_delta_)
@@ -37,6 +115,7 @@ Model::Model(std::shared_ptr<Model> model)
     , default_pose_(model->default_pose_)
     , imu_data_(model->imu_data_)
 {
+  joint_state_store_ = std::make_shared<JointStateStore>(*model->joint_state_store_);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +137,14 @@ void Model::generate(std::shared_ptr<Model> model)
       leg->generate();
     }
     leg_container_.insert(LegContainer::value_type(i, leg));
+
+    // Index leg and joints by identification name for lookup from message names
+    leg_name_index_[leg->getIDName()] = leg;
+    JointContainer::iterator joint_it;
+    for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+    {
+      joint_name_index_[joint_it->second->id_name_] = joint_it->second->getStateIndex();
+    }
   }
 }
 
@@ -91,16 +178,16 @@ bool Model::legsBearingLoad(void)
 
 std::shared_ptr<Leg> Model::getLegByIDName(const std::string &leg_id_name)
 {
-  LegContainer::iterator leg_it;
-  for (leg_it = leg_container_.begin(); leg_it != leg_container_.end(); ++leg_it)
-  {
-    std::shared_ptr<Leg> leg = leg_it->second;
-    if (leg->getIDName() == leg_id_name)
-    {
-      return leg;
-    }
-  }
-  return NULL;
+  std::unordered_map<std::string, std::shared_ptr<Leg>>::iterator it = leg_name_index_.find(leg_id_name);
+  return (it != leg_name_index_.end() ? it->second : NULL);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int Model::getJointStateIndex(const std::string &joint_id_name)
+{
+  std::unordered_map<std::string, int>::iterator it = joint_name_index_.find(joint_id_name);
+  return (it != joint_name_index_.end() ? it->second : -1);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -125,16 +212,65 @@ void Model::generateWorkspaces(void)
   search_model->generate(shared_from_this());
   search_model->initLegs(true);
 
+  // Debug visualisation publishes and spins from within the search so must be run serially
+  bool display_debug_visualisation = params_.debug_workspace_calc.data && params_.debug_rviz.data;
+  bool parallel = params_.parallel_workspace_generation.data && !display_debug_visualisation;
+
   // Run workspace generation for each leg in model
-  LegContainer::iterator leg_it;
-  for (leg_it = search_model->getLegContainer()->begin(); leg_it != search_model->getLegContainer()->end(); ++leg_it)
+  if (parallel)
+  {
+    // Each search leg only modifies its own joints/links/tip so legs may be searched concurrently
+    std::vector<std::shared_ptr<Leg>> search_legs;
+    LegContainer::iterator leg_it;
+    for (leg_it = search_model->getLegContainer()->begin(); leg_it != search_model->getLegContainer()->end(); ++leg_it)
+    {
+      search_legs.push_back(leg_it->second);
+    }
+
+    int worker_count = std::max(1, std::min(leg_count_, static_cast<int>(std::thread::hardware_concurrency())));
+    std::vector<Workspace> workspaces(search_legs.size());
+    std::atomic<int> next_leg(0);
+    std::atomic<int> completed_legs(0);
+    std::vector<std::future<void>> workers;
+    ROS_INFO("\n[SHC] Generating workspace (0%%) . . .\n");
+    for (int i = 0; i < worker_count; ++i)
+    {
+      workers.push_back(std::async(std::launch::async, [&]()
+      {
+        int index;
+        while ((index = next_leg++) < static_cast<int>(search_legs.size()))
+        {
+          workspaces[index] = search_legs[index]->generateWorkspace();
+          ROS_INFO("\n[SHC] Generating workspace (%d%%) . . .\n", roundToInt(100.0 * ++completed_legs / leg_count_));
+        }
+      }));
+    }
+
+    // Wait for all searches to complete (rethrows any exception raised within a search)
+    for (std::future<void> &worker : workers)
+    {
+      worker.get();
+    }
+
+    for (uint i = 0; i < search_legs.size(); ++i)
+    {
+      std::shared_ptr<Leg> leg = leg_container_.at(search_legs[i]->getIDNumber());
+      leg->setWorkspace(workspaces[i]);
+    }
+  }
+  else
   {
-    std::shared_ptr<Leg> search_leg = leg_it->second;
-    ROS_INFO("\n[SHC] Generating workspace (%d%%) . . .\n", roundToInt(100.0 * search_leg->getIDNumber() / leg_count_));
-    std::shared_ptr<Leg> leg = leg_container_.at(search_leg->getIDNumber());
-    leg->setWorkspace(search_leg->generateWorkspace());
+    LegContainer::iterator leg_it;
+    for (leg_it = search_model->getLegContainer()->begin(); leg_it != search_model->getLegContainer()->end(); ++leg_it)
+    {
+      std::shared_ptr<Leg> search_leg = leg_it->second;
+      ROS_INFO("\n[SHC] Generating workspace (%d%%) . . .\n",
+               roundToInt(100.0 * search_leg->getIDNumber() / leg_count_));
+      std::shared_ptr<Leg> leg = leg_container_.at(search_leg->getIDNumber());
+      leg->setWorkspace(search_leg->generateWorkspace());
+    }
+    ROS_INFO("\n[SHC] Generating workspace (100%%) . . .\n");
   }
-  ROS_INFO("\n[SHC] Generating workspace (100%%) . . .\n");
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -142,12 +278,25 @@ void Model::generateWorkspaces(void)
 void Model::updateModel(void)
 {
   // Model uses posed tip positions, adds deltaZ from admittance controller and applies inverse kinematics on each leg
-  LegContainer::iterator leg_it;
-  for (leg_it = leg_container_.begin(); leg_it != leg_container_.end(); ++leg_it)
+  if (worker_pool_ != NULL)
   {
-    std::shared_ptr<Leg> leg = leg_it->second;
-    leg->setDesiredTipPose();
-    leg->applyIK();
+    // Each leg only modifies its own joints/links/tip so legs may be solved concurrently
+    worker_pool_->run(leg_count_, [&](const int &leg_id_num)
+    {
+      std::shared_ptr<Leg> leg = leg_container_.at(leg_id_num);
+      leg->setDesiredTipPose();
+      leg->applyIK();
+    });
+  }
+  else
+  {
+    LegContainer::iterator leg_it;
+    for (leg_it = leg_container_.begin(); leg_it != leg_container_.end(); ++leg_it)
+    {
+      std::shared_ptr<Leg> leg = leg_it->second;
+      leg->setDesiredTipPose();
+      leg->applyIK();
+    }
   }
 }
 
@@ -185,12 +334,21 @@ Leg::Leg(std::shared_ptr<Model> model, const int &id_number, const Parameters &p
   tip_torque_measured_ = Eigen::Vector3d::Zero();
   step_plane_pose_ = Pose::Undefined();
   group_ = (id_number % 2); // Even/odd groups
+  initKinematicSolvers();
+
+  // Joints of each leg occupy consecutive slices of the parent model joint state store (ordered by leg id)
+  joint_state_store_ = model_->getJointStateStore();
+  joint_state_offset_ = 0;
+  for (int i = 0; i < id_number_; ++i)
+  {
+    joint_state_offset_ += params_.leg_DOF.data.at(params_.leg_id.data.at(i));
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Leg::Leg(std::shared_ptr<Leg> leg, std::shared_ptr<Model> model)
-    : params_(leg->params_)
+    : params_(model == NULL ? leg->params_ : model->getParameters())
     , id_number_(leg->id_number_)
     , id_name_(leg->id_name_)
     , joint_count_(leg->joint_count_)
@@ -198,6 +356,18 @@ Leg::Leg(std::shared_ptr<Leg> leg, std::shared_ptr<Model> model)
     , admittance_state_(leg->admittance_state_)
 {
   model_ = (model == NULL ? leg->model_ : model);
+
+  // Legs copied into a new model share its joint state store, standalone copies own a private store
+  if (model != NULL)
+  {
+    joint_state_store_ = model->getJointStateStore();
+    joint_state_offset_ = leg->joint_state_offset_;
+  }
+  else
+  {
+    joint_state_store_ = std::make_shared<JointStateStore>(joint_count_);
+    joint_state_offset_ = 0;
+  }
   leg_state_publisher_ = leg->leg_state_publisher_;
   asc_leg_state_publisher_ = leg->asc_leg_state_publisher_;
   admittance_delta_ = leg->admittance_delta_;
@@ -214,6 +384,8 @@ Leg::Leg(std::shared_ptr<Leg> leg, std::shared_ptr<Model> model)
   tip_torque_calculated_ = leg->tip_torque_calculated_;
   tip_torque_measured_ = leg->tip_torque_calculated_;
   step_plane_pose_ = leg->step_plane_pose_;
+  ik_solver_ = leg->ik_solver_;
+  tip_force_solver_ = leg->tip_force_solver_;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -249,6 +421,8 @@ void Leg::generate(std::shared_ptr<Leg> leg)
       std::shared_ptr<Joint> new_joint = joint_container_.find(old_joint->id_number_)->second;
       new_joint->current_transform_ = old_joint->current_transform_;
       new_joint->identity_transform_ = old_joint->identity_transform_;
+      new_joint->transform_position_ = old_joint->transform_position_;
+      new_joint->updateOriginTransform();
       new_joint->desired_position_publisher_ = old_joint->desired_position_publisher_;
       new_joint->desired_position_ = old_joint->desired_position_;
       new_joint->desired_velocity_ = old_joint->desired_velocity_;
@@ -270,6 +444,8 @@ void Leg::generate(std::shared_ptr<Leg> leg)
     // Copy tip variables
     tip_->identity_transform_ = leg->tip_->identity_transform_;
     tip_->current_transform_ = leg->tip_->current_transform_;
+    tip_->transform_position_ = leg->tip_->transform_position_;
+    tip_->updateOriginTransform();
 
     // Copy LegStepper
     leg_stepper_ = std::allocate_shared<LegStepper>(Eigen::aligned_allocator<LegStepper>(), leg->getLegStepper());
@@ -279,6 +455,8 @@ void Leg::generate(std::shared_ptr<Leg> leg)
     leg_poser_ = std::allocate_shared<LegPoser>(Eigen::aligned_allocator<LegPoser>(), leg->getLegPoser());
     leg_poser_->setParentLeg(shared_from_this());
   }
+
+  initAnalyticIK();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -312,6 +490,7 @@ Workspace Leg::generateWorkspace(void)
   bool display_debug_visualisation = debug && params_.debug_rviz.data;
   bool workspace_generation_complete = false;
   bool simple_workspace = !params_.rough_terrain_mode.data;
+  bool bisection_search = params_.workspace_generation_method.data == "bisection";
 
   // Publish static transforms for visualisation purposes
   if (display_debug_visualisation)
@@ -413,22 +592,38 @@ Workspace Leg::generateWorkspace(void)
       }
     }
 
+    // Search along current search line for kinematic workspace limit in a single iteration via bisection
+    bool tracking_to_workplane_origin = found_lower_limit && found_upper_limit && search_bearing == 0;
+    if (bisection_search && !tracking_to_workplane_origin)
+    {
+      searchWorkspaceLimit(origin_tip_position, target_tip_position);
+      distance_from_origin = Eigen::Vector3d(current_tip_pose_.position_ - identity_tip_position).norm();
+      within_limits = false;
+
+      // Display debugging messages
+      ROS_DEBUG_COND(debug && search_bearing != 0,
+                     "LEG: %s\tSEARCH: %f:%d\tDISTANCE: %f",
+                     id_name_.c_str(), search_height, search_bearing, distance_from_origin);
+    }
     // Move tip position linearly along search bearing in search of kinematic workspace limit
-    double i = double(iteration) / number_iterations;                                                 // Interpolation control variable
-    Eigen::Vector3d desired_tip_position = origin_tip_position * (1.0 - i) + target_tip_position * i; // Interpolate
-    // Quaterniond desired_tip_rotation = leg_stepper->getIdentityTipPose().rotation_;
-    setDesiredTipPose(Pose(desired_tip_position, UNDEFINED_ROTATION));
-    double ik_result = applyIK(true);
-    distance_from_origin = Eigen::Vector3d(current_tip_pose_.position_ - identity_tip_position).norm();
-
-    // Check if leg is still within limits
-    within_limits = within_limits && ik_result != 0.0;
-
-    // Display debugging messages
-    ROS_DEBUG_COND(debug && search_bearing != 0,
-                   "LEG: %s\tSEARCH: %f:%d:%d\tDISTANCE: %f\tIK_RESULT: %f\tWITHIN LIMITS: %s",
-                   id_name_.c_str(), search_height, search_bearing,
-                   iteration, distance_from_origin, ik_result, within_limits ? "TRUE" : "FALSE");
+    else
+    {
+      double i = double(iteration) / number_iterations;                                                 // Interpolation control variable
+      Eigen::Vector3d desired_tip_position = origin_tip_position * (1.0 - i) + target_tip_position * i; // Interpolate
+      // Quaterniond desired_tip_rotation = leg_stepper->getIdentityTipPose().rotation_;
+      setDesiredTipPose(Pose(desired_tip_position, UNDEFINED_ROTATION));
+      double ik_result = applyIK(true);
+      distance_from_origin = Eigen::Vector3d(current_tip_pose_.position_ - identity_tip_position).norm();
+
+      // Check if leg is still within limits
+      within_limits = within_limits && ik_result != 0.0;
+
+      // Display debugging messages
+      ROS_DEBUG_COND(debug && search_bearing != 0,
+                     "LEG: %s\tSEARCH: %f:%d:%d\tDISTANCE: %f\tIK_RESULT: %f\tWITHIN LIMITS: %s",
+                     id_name_.c_str(), search_height, search_bearing,
+                     iteration, distance_from_origin, ik_result, within_limits ? "TRUE" : "FALSE");
+    }
 
     // Search not complete -> iterate along current search bearing
     if (within_limits && iteration < number_iterations)
@@ -498,7 +693,7 @@ Workspace Leg::generateWorkspace(void)
       std::shared_ptr<DebugVisualiser> debug = model_->getDebugVisualiser();
       debug->generateRobotModel(model_);
       debug->generateWorkspace(shared_from_this(), params_.body_clearance.data);
-      ros::Rate r(100);
+      ros::WallRate r(100);
       ros::spinOnce();
       r.sleep();
     }
@@ -511,40 +706,129 @@ Workspace Leg::generateWorkspace(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Workplane Leg::getWorkplane(const double &height)
+double Leg::searchWorkspaceLimit(const Eigen::Vector3d &origin_tip_position, const Eigen::Vector3d &target_tip_position)
 {
-  bool within_workspace = (height >= workspace_.begin()->first && height <= workspace_.rbegin()->first);
-  if (!within_workspace)
+  double search_distance = Eigen::Vector3d(target_tip_position - origin_tip_position).norm();
+  if (search_distance == 0.0)
   {
-    ROS_WARN("\n[SHC] Requested workplane does not exist within workspace.\n");
-    Workplane undefined;
-    return undefined;
+    return 0.0;
+  }
+  Eigen::Vector3d search_direction = (target_tip_position - origin_tip_position) / search_distance;
+
+  // Save joint configuration of furthest reachable tip position so each test begins from a known valid state
+  std::vector<double> valid_joint_positions;
+  JointContainer::iterator joint_it;
+  for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it)
+  {
+    valid_joint_positions.push_back(joint_it->second->desired_position_);
+  }
+
+  // Stride coarsely along search line until test position is unreachable
+  double lower_limit = 0.0;
+  double upper_limit = search_distance;
+  bool limit_found = false;
+  while (lower_limit < search_distance)
+  {
+    double test_distance = std::min(lower_limit + SEARCH_STRIDE, search_distance);
+    if (solveTipPosition(origin_tip_position + search_direction * test_distance))
+    {
+      lower_limit = test_distance;
+      int i = 0;
+      for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
+      {
+        valid_joint_positions[i] = joint_it->second->desired_position_;
+      }
+    }
+    else
+    {
+      upper_limit = test_distance;
+      limit_found = true;
+      break;
+    }
+  }
+
+  // Refine limit between furthest reachable and first unreachable test positions via bisection
+  while (limit_found && upper_limit - lower_limit > IK_TOLERANCE)
+  {
+    int i = 0;
+    for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
+    {
+      std::shared_ptr<Joint> joint = joint_it->second;
+      joint->desired_position_ = valid_joint_positions[i];
+      joint->prev_desired_position_ = joint->desired_position_;
+      joint->desired_velocity_ = 0.0;
+    }
+    applyFK();
+
+    double test_distance = (lower_limit + upper_limit) / 2.0;
+    if (solveTipPosition(origin_tip_position + search_direction * test_distance))
+    {
+      lower_limit = test_distance;
+      i = 0;
+      for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
+      {
+        valid_joint_positions[i] = joint_it->second->desired_position_;
+      }
+    }
+    else
+    {
+      upper_limit = test_distance;
+    }
+  }
+
+  // Leave leg at furthest reachable tip position
+  int i = 0;
+  for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
+  {
+    std::shared_ptr<Joint> joint = joint_it->second;
+    joint->desired_position_ = valid_joint_positions[i];
+    joint->prev_desired_position_ = joint->desired_position_;
+    joint->desired_velocity_ = 0.0;
+  }
+  applyFK();
+
+  return lower_limit;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Leg::solveTipPosition(const Eigen::Vector3d &tip_position)
+{
+  setDesiredTipPose(Pose(tip_position, UNDEFINED_ROTATION));
+  double previous_error = UNASSIGNED_VALUE;
+  for (int i = 0; i < MAX_SEARCH_IK_ITERATIONS; ++i)
+  {
+    double ik_result = applyIK(true);
+    double error = Eigen::Vector3d(current_tip_pose_.position_ - tip_position).norm();
+    if (ik_result != 0.0)
+    {
+      return true;
+    }
+    // Solution no longer converging (e.g. joint clamped at limit)
+    else if (error >= previous_error)
+    {
+      return false;
+    }
+    previous_error = error;
   }
-  else if (workspace_.size() == 1)
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Workplane Leg::getWorkplane(const double &height)
+{
+  Workplane workplane;
+  if (!workspace_grid_.isWithinHeight(height))
   {
-    return workspace_.at(0.0);
+    ROS_WARN("\n[SHC] Requested workplane does not exist within workspace.\n");
+    return workplane;
   }
 
-  // Get bounding existing workplanes within workspace
-  ROS_ASSERT(workspace_.size() > 1);
-  Workspace::iterator upper_bound_it = workspace_.upper_bound(height);
-  Workspace::iterator lower_bound_it = prev(upper_bound_it);
-  double upper_workplane_height = setPrecision(upper_bound_it->first, 3);
-  double lower_workplane_height = setPrecision(lower_bound_it->first, 3);
-  Workplane upper_workplane = upper_bound_it->second;
-  Workplane lower_workplane = lower_bound_it->second;
-
-  // Calculate interpolation value of target workplane height between existing workspace planes
-  double i = (height - lower_workplane_height) / (upper_workplane_height - lower_workplane_height);
-
-  // Generate workplane radii
-  Workplane workplane = upper_workplane;
-  Workplane::iterator workplane_it;
-  for (workplane_it = workplane.begin(); workplane_it != workplane.end(); ++workplane_it)
+  // Generate workplane radii from dense workspace grid
+  for (int bearing = 0; bearing <= 360; bearing += BEARING_STEP)
   {
-    int bearing = workplane_it->first;
-    double radius = lower_workplane.at(bearing) * (1.0 - i) + upper_workplane.at(bearing) * i;
-    workplane[bearing] = within_workspace ? radius : 0.0;
+    workplane.insert(Workplane::value_type(bearing, workspace_grid_.getRadius(height, bearing)));
   }
   return workplane;
 }
@@ -553,25 +837,16 @@ Workplane Leg::getWorkplane(const double &height)
 
 Eigen::Vector3d Leg::makeReachable(const Eigen::Vector3d &reference_tip_position)
 {
-  // Get workplane containing test tip position
+  // Transform test tip position into workspace frame
   Pose pose = model_->getCurrentPose();
   Eigen::Vector3d test_tip_position = pose.inverseTransformVector(reference_tip_position);
   Eigen::Vector3d identity_tip_position = leg_stepper_->getIdentityTipPose().position_;
   Eigen::Vector3d identity_to_test = test_tip_position - identity_tip_position;
   double distance_to_test = Eigen::Vector2d(identity_to_test[0], identity_to_test[1]).norm();
-  LimitMap workplane = getWorkplane(test_tip_position[2]);
 
-  // Find distance to workplane limit along bearing to test tip position
+  // Find distance to workspace limit along bearing to test tip position
   double raw_bearing = atan2(test_tip_position[1], test_tip_position[0]);
-  int bearing = mod(roundToInt(radiansToDegrees(raw_bearing)), 360);
-  int upper_bound = workplane.lower_bound(bearing)->first;
-  int lower_bound = mod(upper_bound - BEARING_STEP, 360);
-  bearing += (bearing < lower_bound) ? 360 : 0;
-  upper_bound += (upper_bound < lower_bound) ? 360 : 0;
-  double interpolation_progress = (bearing - lower_bound) / (upper_bound - lower_bound);
-  double distance_to_limit = interpolate(workplane.at(lower_bound),
-                                         workplane.at(mod(upper_bound, 360)),
-                                         interpolation_progress);
+  double distance_to_limit = workspace_grid_.getRadius(test_tip_position[2], radiansToDegrees(raw_bearing));
 
   // If test tip position is beyond limit, calculate new position along same workplane bearing within limits
   if (distance_to_test > distance_to_limit)
@@ -608,12 +883,19 @@ void Leg::generateDesiredJointStateMsg(sensor_msgs::JointState *joint_state_msg)
   JointContainer::iterator joint_it;
   for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it)
   {
-    std::shared_ptr<Joint> joint = joint_it->second;
-    joint_state_msg->name.push_back(joint->id_name_);
-    joint_state_msg->position.push_back(joint->desired_position_);
-    joint_state_msg->velocity.push_back(joint->desired_velocity_);
-    joint_state_msg->effort.push_back(joint->desired_effort_);
+    joint_state_msg->name.push_back(joint_it->second->id_name_);
   }
+
+  // Copy contiguous joint state slices of this leg directly from joint state store
+  const JointStateStore &store = *joint_state_store_;
+  const int begin = joint_state_offset_;
+  const int end = joint_state_offset_ + joint_count_;
+  joint_state_msg->position.insert(joint_state_msg->position.end(),
+                                   store.desired_positions_.begin() + begin, store.desired_positions_.begin() + end);
+  joint_state_msg->velocity.insert(joint_state_msg->velocity.end(),
+                                   store.desired_velocities_.begin() + begin, store.desired_velocities_.begin() + end);
+  joint_state_msg->effort.insert(joint_state_msg->effort.end(),
+                                 store.desired_efforts_.begin() + begin, store.desired_efforts_.begin() + end);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -664,19 +946,21 @@ void Leg::setDesiredTipPose(const Pose &tip_pose, bool apply_delta)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void Leg::calculateTipForce(void)
+template <int N>
+void Leg::calculateTipForceFixed(void)
 {
-  std::shared_ptr<Joint> first_joint = joint_container_.begin()->second;
+  const std::shared_ptr<Joint> &first_joint = joint_container_.begin()->second;
 
-  Eigen::Vector3d pe = tip_->getTransformFromJoint(first_joint->id_number_).block<3, 1>(0, 3);
+  const Eigen::Matrix4d &base_inverse = first_joint->origin_transform_inverse_;
+  Eigen::Vector3d pe = (base_inverse * tip_->origin_transform_).block<3, 1>(0, 3);
   Eigen::Vector3d z0(0, 0, 1);
   Eigen::Vector3d p0(0, 0, 0);
 
-  Eigen::MatrixXd jacobian(6, joint_count_);
-  jacobian.block<3, 1>(0, 0) = z0.cross(pe - p0); // Linear velocity
-  jacobian.block<3, 1>(3, 0) = z0;                // Angular velocity
+  Eigen::Matrix<double, 6, N> jacobian;
+  jacobian.template block<3, 1>(0, 0) = z0.cross(pe - p0); // Linear velocity
+  jacobian.template block<3, 1>(3, 0) = z0;                // Angular velocity
 
-  Eigen::VectorXd joint_torques(joint_count_);
+  Eigen::Matrix<double, N, 1> joint_torques;
   joint_torques[0] = first_joint->current_effort_;
 
   // Skip first joint dh parameters since it is a fixed transformation
@@ -684,21 +968,19 @@ void Leg::calculateTipForce(void)
   JointContainer::iterator joint_it;
   for (joint_it = ++joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
   {
-    std::shared_ptr<Joint> joint = joint_it->second;
-    Eigen::Matrix4d t = joint->getTransformFromJoint(first_joint->id_number_);
-    jacobian.block<3, 1>(0, i) = t.block<3, 1>(0, 2).cross(pe - t.block<3, 1>(0, 3)); // Linear velocity
-    jacobian.block<3, 1>(3, i) = t.block<3, 1>(0, 2);                                 // Angular velocity
+    const std::shared_ptr<Joint> &joint = joint_it->second;
+    Eigen::Matrix4d t = base_inverse * joint->origin_transform_;
+    jacobian.template block<3, 1>(0, i) = t.block<3, 1>(0, 2).cross(pe - t.block<3, 1>(0, 3)); // Linear velocity
+    jacobian.template block<3, 1>(3, i) = t.block<3, 1>(0, 2);                                 // Angular velocity
     joint_torques[i] = joint->current_effort_;
   }
 
-  // Transpose and invert jacobian
-  Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(joint_count_, joint_count_);
-  Eigen::MatrixXd transformation =
-      jacobian * ((jacobian.transpose() * jacobian + sqr(DLS_COEFFICIENT) * identity).inverse());
-
-  Eigen::VectorXd raw_tip_force_leg_frame = transformation * joint_torques;
+  // Transpose and invert jacobian (solving damped system rather than explicitly inverting)
+  Eigen::Matrix<double, N, N> damped_system =
+      jacobian.transpose() * jacobian + sqr(DLS_COEFFICIENT) * Eigen::Matrix<double, N, N>::Identity();
+  Eigen::Matrix<double, 6, 1> raw_tip_force_leg_frame = jacobian * damped_system.ldlt().solve(joint_torques);
   Eigen::Quaterniond rotation = (first_joint->getPoseJointFrame()).rotation_;
-  Eigen::VectorXd raw_tip_force = rotation._transformVector(raw_tip_force_leg_frame.block<3, 1>(0, 0));
+  Eigen::Vector3d raw_tip_force = rotation._transformVector(raw_tip_force_leg_frame.block<3, 1>(0, 0));
 
   // Low pass filter and force gain applied to calculated raw tip force
   double s = 0.15; // Smoothing Factor
@@ -723,48 +1005,49 @@ void Leg::touchdownDetection(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-Eigen::VectorXd Leg::solveIK(const Eigen::MatrixXd &delta, const bool &solve_rotation)
+template <int N>
+JointVector Leg::solveIKFixed(const TipDelta &delta, const bool &solve_rotation)
 {
   // Calculate Jacobian from DH matrices along kinematic chain. Ref:
   // robotics.stackexchange.com/questions/2760/computing-inverse-kinematic-with-jacobian-matrices-for-6-dof-manipulator
-  std::shared_ptr<Joint> first_joint = joint_container_.begin()->second;
-  Eigen::Vector3d pe = tip_->getTransformFromJoint(first_joint->id_number_).block<3, 1>(0, 3);
+  const std::shared_ptr<Joint> &first_joint = joint_container_.begin()->second;
+  const Eigen::Matrix4d &base_inverse = first_joint->origin_transform_inverse_;
+  Eigen::Vector3d pe = (base_inverse * tip_->origin_transform_).block<3, 1>(0, 3);
   Eigen::Vector3d z0(0, 0, 1);
   Eigen::Vector3d p0(0, 0, 0);
 
-  Eigen::MatrixXd jacobian(6, joint_count_);
-  jacobian.block<3, 1>(0, 0) = z0.cross(pe - p0);                             // Linear velocity
-  jacobian.block<3, 1>(3, 0) = solve_rotation ? z0 : Eigen::Vector3d::Zero(); // Angular velocity
+  Eigen::Matrix<double, 6, N> j;
+  j.template block<3, 1>(0, 0) = z0.cross(pe - p0);                             // Linear velocity
+  j.template block<3, 1>(3, 0) = solve_rotation ? z0 : Eigen::Vector3d::Zero(); // Angular velocity
 
   JointContainer::iterator joint_it;
   int i = 1; // Skip first joint dh parameters since it is a fixed transformation
   for (joint_it = ++joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
   {
-    std::shared_ptr<Joint> joint = joint_it->second;
-    Eigen::Matrix4d t = joint->getTransformFromJoint(first_joint->id_number_);
-    jacobian.block<3, 1>(0, i) = t.block<3, 1>(0, 2).cross(pe - t.block<3, 1>(0, 3));             // Linear velocity
-    jacobian.block<3, 1>(3, i) = solve_rotation ? t.block<3, 1>(0, 2) : Eigen::Vector3d(0, 0, 0); // Angular velocity
+    const std::shared_ptr<Joint> &joint = joint_it->second;
+    Eigen::Matrix4d t = base_inverse * joint->origin_transform_;
+    j.template block<3, 1>(0, i) = t.block<3, 1>(0, 2).cross(pe - t.block<3, 1>(0, 3));             // Linear velocity
+    j.template block<3, 1>(3, i) = solve_rotation ? t.block<3, 1>(0, 2) : Eigen::Vector3d(0, 0, 0); // Angular velocity
   }
 
-  Eigen::MatrixXd identity = Eigen::MatrixXd::Identity(6, 6);
-  Eigen::MatrixXd jacobian_inverse(joint_count_, 6);
-  Eigen::MatrixXd j = jacobian;
-
   // Calculate jacobian inverse using damped least squares method
   // REF: Chapter 5 of Introduction to Inverse Kinematics... , Samuel R. Buss 2009
-  jacobian_inverse = j.transpose() * ((j * j.transpose() + sqr(DLS_COEFFICIENT) * identity).inverse()); //DLS Method
+  // Uses equivalent form J^T(JJ^T + k^2I)^-1 = (J^TJ + k^2I)^-1J^T, solving the (NxN) damped system via LDLT
+  Eigen::Matrix<double, N, N> identity = Eigen::Matrix<double, N, N>::Identity();
+  Eigen::Matrix<double, N, N> damped_system = j.transpose() * j + sqr(DLS_COEFFICIENT) * identity;
+  Eigen::Matrix<double, N, 6> jacobian_inverse = damped_system.ldlt().solve(j.transpose()); //DLS Method
 
   // Generate joint limit cost function and gradient
   // REF: Chapter 2.4 of Autonomous Robots - Kinematics, Path Planning and Control, Farbod. Fahimi 2008
   i = 0;
   double position_limit_cost = 0.0;
   double velocity_limit_cost = 0.0;
-  Eigen::VectorXd position_cost_gradient = Eigen::VectorXd::Zero(joint_count_);
-  Eigen::VectorXd velocity_cost_gradient = Eigen::VectorXd::Zero(joint_count_);
-  Eigen::VectorXd combined_cost_gradient = Eigen::VectorXd::Zero(joint_count_);
+  Eigen::Matrix<double, N, 1> position_cost_gradient = Eigen::Matrix<double, N, 1>::Zero();
+  Eigen::Matrix<double, N, 1> velocity_cost_gradient = Eigen::Matrix<double, N, 1>::Zero();
+  Eigen::Matrix<double, N, 1> combined_cost_gradient = Eigen::Matrix<double, N, 1>::Zero();
   for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++i)
   {
-    std::shared_ptr<Joint> joint = joint_it->second;
+    const std::shared_ptr<Joint> &joint = joint_it->second;
 
     // POSITION LIMITS
     double joint_position_range = joint->max_position_ - joint->min_position_;
@@ -790,67 +1073,233 @@ Eigen::VectorXd Leg::solveIK(const Eigen::MatrixXd &delta, const bool &solve_rot
   combined_cost_gradient = interpolate(position_cost_gradient, velocity_cost_gradient, 0.75);
 
   // Calculate joint position change
-  identity = Eigen::MatrixXd::Identity(joint_count_, joint_count_);
-  return jacobian_inverse * delta + (identity - jacobian_inverse * j) * combined_cost_gradient;
+  Eigen::Matrix<double, N, 1> joint_position_delta =
+      jacobian_inverse * delta + (identity - jacobian_inverse * j) * combined_cost_gradient;
+  return joint_position_delta;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Leg::initKinematicSolvers(void)
+{
+  switch (joint_count_)
+  {
+    case 1:
+      ik_solver_ = &Leg::solveIKFixed<1>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<1>;
+      break;
+    case 2:
+      ik_solver_ = &Leg::solveIKFixed<2>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<2>;
+      break;
+    case 3:
+      ik_solver_ = &Leg::solveIKFixed<3>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<3>;
+      break;
+    case 4:
+      ik_solver_ = &Leg::solveIKFixed<4>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<4>;
+      break;
+    case 5:
+      ik_solver_ = &Leg::solveIKFixed<5>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<5>;
+      break;
+    case 6:
+      ik_solver_ = &Leg::solveIKFixed<6>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<6>;
+      break;
+    default:
+      ROS_FATAL("\nModel initialisation error for leg %s: %d joints requested (max %d).\n",
+                id_name_.c_str(), joint_count_, MAX_LEG_JOINTS);
+      ros::shutdown();
+      ik_solver_ = &Leg::solveIKFixed<MAX_LEG_JOINTS>;
+      tip_force_solver_ = &Leg::calculateTipForceFixed<MAX_LEG_JOINTS>;
+      break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Leg::initAnalyticIK(void)
+{
+  analytic_ik_ = false;
+  if (!params_.analytic_IK.data || joint_count_ != 3)
+  {
+    return;
+  }
+
+  // Femur and tibia joint axes must be parallel and coxa joint axis must not be parallel to them
+  const std::shared_ptr<Link> &coxa_link = link_container_.at(1);
+  const std::shared_ptr<Link> &femur_link = link_container_.at(2);
+  const std::shared_ptr<Link> &tibia_link = link_container_.at(3);
+  analytic_ik_ = abs(femur_link->dh_parameter_alpha_) < ANALYTIC_IK_DH_TOLERANCE &&
+                 abs(sin(coxa_link->dh_parameter_alpha_)) > ANALYTIC_IK_DH_TOLERANCE &&
+                 femur_link->dh_parameter_r_ > ANALYTIC_IK_DH_TOLERANCE &&
+                 tibia_link->dh_parameter_r_ > ANALYTIC_IK_DH_TOLERANCE;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Leg::solveIKAnalytic(const Eigen::Vector3d &target_tip_position, JointVector *joint_position_delta)
+{
+  // Tip position in first joint frame: Rz(q1 + theta1) * (r1 + x, y * cos(alpha1) - h * sin(alpha1),
+  // d1 + y * sin(alpha1) + h * cos(alpha1)) where (x, y) is the tip position within the femur/tibia plane and h the
+  // offset of that plane along the femur joint axis.
+  const std::shared_ptr<Link> &coxa_link = link_container_.at(1);
+  const std::shared_ptr<Link> &femur_link = link_container_.at(2);
+  const std::shared_ptr<Link> &tibia_link = link_container_.at(3);
+  double r1 = coxa_link->dh_parameter_r_;
+  double r2 = femur_link->dh_parameter_r_;
+  double r3 = tibia_link->dh_parameter_r_;
+  double h = femur_link->dh_parameter_d_ + tibia_link->dh_parameter_d_;
+  double sin_alpha = sin(coxa_link->dh_parameter_alpha_);
+  double cos_alpha = cos(coxa_link->dh_parameter_alpha_);
+
+  // Solve tip position within femur/tibia plane (y from height, x from horizontal distance to coxa joint axis)
+  const Eigen::Vector3d &p = target_tip_position;
+  double y = (p[2] - coxa_link->dh_parameter_d_ - h * cos_alpha) / sin_alpha;
+  double v = y * cos_alpha - h * sin_alpha;
+  double horizontal_distance_sqr = sqr(p[0]) + sqr(p[1]) - sqr(v);
+  if (horizontal_distance_sqr < 0.0)
+  {
+    return false;
+  }
+
+  // Evaluate each reach (tip in front of/behind coxa axis) and elbow configuration, selecting the closest solution
+  // with all joints within limits (or the closest solution overall if no solution is within limits)
+  JointContainer::iterator joint_it = joint_container_.begin();
+  double current_position[3];
+  double min_position[3];
+  double max_position[3];
+  for (int i = 0; i < 3; ++i, ++joint_it)
+  {
+    current_position[i] = joint_it->second->desired_position_;
+    min_position[i] = joint_it->second->min_position_;
+    max_position[i] = joint_it->second->max_position_;
+  }
+  bool solved = false;
+  bool best_within_limits = false;
+  double min_delta_norm = UNASSIGNED_VALUE;
+  Eigen::Vector3d best_delta;
+  for (int reach = 1; reach >= -1; reach -= 2)
+  {
+    double u = reach * sqrt(horizontal_distance_sqr);
+    double x = u - r1;
+    double cos_phi_3 = (sqr(x) + sqr(y) - sqr(r2) - sqr(r3)) / (2.0 * r2 * r3);
+    if (abs(cos_phi_3) > 1.0)
+    {
+      continue;
+    }
+    for (int elbow = 1; elbow >= -1; elbow -= 2)
+    {
+      double phi_1 = atan2(p[1], p[0]) - atan2(v, u);
+      double phi_3 = elbow * acos(cos_phi_3);
+      double phi_2 = atan2(y, x) - atan2(r3 * sin(phi_3), r2 + r3 * cos(phi_3));
+      double phi[3] = { phi_1, phi_2, phi_3 };
+      const double theta[3] = { coxa_link->dh_parameter_theta_,
+                                femur_link->dh_parameter_theta_,
+                                tibia_link->dh_parameter_theta_ };
+      Eigen::Vector3d delta;
+      bool within_limits = true;
+      for (int i = 0; i < 3; ++i)
+      {
+        double raw_delta = phi[i] - theta[i] - current_position[i];
+        delta[i] = atan2(sin(raw_delta), cos(raw_delta)); // Wrap to nearest equivalent joint position
+        double position = current_position[i] + delta[i];
+        within_limits = within_limits && position >= min_position[i] && position <= max_position[i];
+      }
+      bool preferred = (within_limits && !best_within_limits) ||
+                       (within_limits == best_within_limits && delta.norm() < min_delta_norm);
+      if (preferred)
+      {
+        min_delta_norm = delta.norm();
+        best_delta = delta;
+        best_within_limits = within_limits;
+        solved = true;
+      }
+    }
+  }
+
+  if (solved)
+  {
+    *joint_position_delta = best_delta;
+  }
+  return solved;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-double Leg::updateJointPositions(const Eigen::VectorXd &delta, const bool &simulation)
+void Leg::resetDiagnostics(void)
 {
+  diagnostics_ = LegDiagnostics();
+  JointStateStore &store = *joint_state_store_;
+  std::fill(store.diagnostics_.begin() + joint_state_offset_,
+            store.diagnostics_.begin() + joint_state_offset_ + joint_count_, JointDiagnostics());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+double Leg::updateJointPositions(const JointVector &delta, const bool &simulation)
+{
+  // Views of the contiguous joint state slices of this leg within joint state store
+  JointStateStore &store = *joint_state_store_;
+  double *desired_position = store.desired_positions_.data() + joint_state_offset_;
+  double *desired_velocity = store.desired_velocities_.data() + joint_state_offset_;
+  double *prev_desired_position = store.prev_desired_positions_.data() + joint_state_offset_;
+  const double *min_position = store.min_positions_.data() + joint_state_offset_;
+  const double *max_position = store.max_positions_.data() + joint_state_offset_;
+  const double *max_angular_speed = store.max_angular_speeds_.data() + joint_state_offset_;
+  const double time_delta = model_->getTimeDelta();
+
+  JointDiagnostics *diagnostics = store.diagnostics_.data() + joint_state_offset_;
+
   int index = 0;
-  std::string clamping_events;
   double min_limit_proximity = 1.0;
   JointContainer::iterator joint_it;
   for (joint_it = joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it, ++index)
   {
-    std::shared_ptr<Joint> joint = joint_it->second;
-    joint->desired_velocity_ = delta[index] / model_->getTimeDelta();
-    ROS_ASSERT(joint->desired_velocity_ < UNASSIGNED_VALUE);
+    desired_velocity[index] = delta[index] / time_delta;
+    ROS_ASSERT(desired_velocity[index] < UNASSIGNED_VALUE);
 
     // Clamp joint velocities within limits
     if (params_.clamp_joint_velocities.data && !simulation)
     {
-      if (abs(joint->desired_velocity_) > joint->max_angular_speed_)
+      if (abs(desired_velocity[index]) > max_angular_speed[index])
       {
-        double max_velocity = joint->max_angular_speed_;
-        clamping_events += stringFormat("\n\tType: Velocity\tJoint: %s\tDesired: %f rad/s\tLimited to: %f rad/s",
-                                        joint->id_name_.c_str(), abs(joint->desired_velocity_), max_velocity);
-        joint->desired_velocity_ = clamped(joint->desired_velocity_, -max_velocity, max_velocity);
+        double max_velocity = max_angular_speed[index];
+        diagnostics[index].velocity_clamp_count_++;
+        diagnostics[index].max_velocity_excess_ =
+          std::max(diagnostics[index].max_velocity_excess_, abs(desired_velocity[index]) - max_velocity);
+        desired_velocity[index] = clamped(desired_velocity[index], -max_velocity, max_velocity);
       }
     }
 
-    joint->prev_desired_position_ = joint->desired_position_;
-    joint->desired_position_ = joint->prev_desired_position_ + joint->desired_velocity_ * model_->getTimeDelta();
+    prev_desired_position[index] = desired_position[index];
+    desired_position[index] = prev_desired_position[index] + desired_velocity[index] * time_delta;
 
     // Clamp joint position within limits
     if (params_.clamp_joint_positions.data)
     {
-      if (joint->desired_position_ < joint->min_position_)
-      {
-        clamping_events += stringFormat("\n\tType: Position\tJoint: %s\tDesired: %f rad\tLimited to: %f rad",
-                                        joint->id_name_.c_str(), joint->desired_position_, joint->min_position_);
-        joint->desired_position_ = joint->min_position_;
-      }
-      else if (joint->desired_position_ > joint->max_position_)
+      double position_excess = std::max(min_position[index] - desired_position[index],
+                                        desired_position[index] - max_position[index]);
+      if (position_excess > 0.0)
       {
-        clamping_events += stringFormat("\n\tType: Position\tJoint: %s\tDesired: %f rad\tLimited to: %f rad",
-                                        joint->id_name_.c_str(), joint->desired_position_, joint->max_position_);
-        joint->desired_position_ = joint->max_position_;
+        if (!simulation)
+        {
+          diagnostics[index].position_clamp_count_++;
+          diagnostics[index].max_position_excess_ = std::max(diagnostics[index].max_position_excess_, position_excess);
+        }
+        desired_position[index] = clamped(desired_position[index], min_position[index], max_position[index]);
       }
     }
 
     // Calculates the proximity of the joint closest to one of it's limits. Used for preventing exceeding workspace.
     // (1.0 = furthest possible from limit, 0.0 = equal to limit)
-    double min_diff = abs(joint->min_position_ - joint->desired_position_);
-    double max_diff = abs(joint->max_position_ - joint->desired_position_);
-    double half_joint_range = (joint->max_position_ - joint->min_position_) / 2.0;
+    double min_diff = abs(min_position[index] - desired_position[index]);
+    double max_diff = abs(max_position[index] - desired_position[index]);
+    double half_joint_range = (max_position[index] - min_position[index]) / 2.0;
     double limit_proximity = half_joint_range != 0 ? std::min(min_diff, max_diff) / half_joint_range : 1.0;
     min_limit_proximity = std::min(limit_proximity, min_limit_proximity);
-
-    // Report clamping events
-    ROS_WARN_COND(!clamping_events.empty() && !params_.ignore_IK_warnings.data && !simulation,
-                  "\nIK Clamping Event/s:%s\n", clamping_events.c_str());
   }
 
   return min_limit_proximity;
@@ -867,17 +1316,22 @@ double Leg::applyIK(const bool &simulation)
   Eigen::Vector3d position_delta = leg_frame_desired_tip_pose.position_ - leg_frame_current_tip_pose.position_;
   ROS_ASSERT(position_delta.norm() < UNASSIGNED_VALUE);
 
-  Eigen::MatrixXd delta = Eigen::Matrix<double, 6, 1>::Zero();
+  TipDelta delta = TipDelta::Zero();
   delta(0) = position_delta[0];
   delta(1) = position_delta[1];
   delta(2) = position_delta[2];
 
-  // Calculate change in joint positions for change in tip position
-  Eigen::VectorXd joint_position_delta(joint_count_);
-  joint_position_delta = solveIK(delta, false);
+  // Calculate change in joint positions for change in tip position (in closed form for compatible 3 DOF legs)
+  bool rotation_constrained = !desired_tip_pose_.rotation_.isApprox(UNDEFINED_ROTATION);
+  JointVector joint_position_delta;
+  bool analytic_solution = analytic_ik_ && !rotation_constrained &&
+                           solveIKAnalytic(leg_frame_desired_tip_pose.position_, &joint_position_delta);
+  if (!analytic_solution)
+  {
+    joint_position_delta = solveIK(delta, false);
+  }
 
   // Update change in joint positions for change in tip rotation to desired tip rotation if defined
-  bool rotation_constrained = !desired_tip_pose_.rotation_.isApprox(UNDEFINED_ROTATION);
   if (rotation_constrained)
   {
     // Update model
@@ -892,7 +1346,7 @@ double Leg::applyIK(const bool &simulation)
     Eigen::Quaterniond difference = Eigen::Quaterniond::FromTwoVectors(current_tip_direction, desired_tip_direction);
     Eigen::AngleAxisd axis_rotation(difference.normalized());
     Eigen::Vector3d rotation_delta = axis_rotation.axis() * axis_rotation.angle();
-    delta = Eigen::Matrix<double, 6, 1>::Zero();
+    delta = TipDelta::Zero();
     delta(3) = rotation_delta[0];
     delta(4) = rotation_delta[1];
     delta(5) = rotation_delta[2];
@@ -911,20 +1365,18 @@ double Leg::applyIK(const bool &simulation)
                  desired_tip_pose_.position_[0], desired_tip_pose_.position_[1], desired_tip_pose_.position_[2],
                  current_tip_pose_.position_[0], current_tip_pose_.position_[1], current_tip_pose_.position_[2]);
 
-  // Display warning messages for associated inverse kinematic deviations
-  std::string axis_label[3] = {"x", "y", "z"};
+  // Record inverse kinematic deviations for throttled reporting by diagnostics reporter
+  Eigen::Vector3d position_error = current_tip_pose_.position_ - desired_tip_pose_.position_;
   for (int i = 0; i < 3; ++i)
   {
-    Eigen::Vector3d position_error = current_tip_pose_.position_ - desired_tip_pose_.position_;
     if (abs(position_error[i]) > IK_TOLERANCE)
     {
       ik_success = 0.0;
-      ROS_WARN_COND(!simulation && !params_.ignore_IK_warnings.data,
-                    "\nInverse kinematics deviation! Calculated tip %s position of leg %s (%s: %f)"
-                    " differs from desired tip position (%s: %f)\n",
-                    axis_label[i].c_str(), id_name_.c_str(),
-                    axis_label[i].c_str(), current_tip_pose_.position_[i],
-                    axis_label[i].c_str(), desired_tip_pose_.position_[i]);
+      if (!simulation)
+      {
+        diagnostics_.deviation_counts_[i]++;
+        diagnostics_.max_deviations_[i] = std::max(diagnostics_.max_deviations_[i], abs(position_error[i]));
+      }
     }
   }
 
@@ -945,31 +1397,52 @@ double Leg::applyIK(const bool &simulation)
 Pose Leg::applyFK(const bool &set_current, const bool &use_actual)
 {
   // Update joint transforms - skip first joint since it's transform is constant
+  // Transforms are only regenerated for joints whose position has changed and cached origin transforms are only
+  // updated from the first changed joint onwards along the kinematic chain.
+  bool chain_updated = false;
   JointContainer::iterator joint_it;
   for (joint_it = ++joint_container_.begin(); joint_it != joint_container_.end(); ++joint_it)
   {
-    std::shared_ptr<Joint> joint = joint_it->second;
-    const std::shared_ptr<Link> reference_link = joint->reference_link_;
+    const std::shared_ptr<Joint> &joint = joint_it->second;
+    const std::shared_ptr<Link> &reference_link = joint->reference_link_;
     double joint_angle = reference_link->actuating_joint_->desired_position_;
     if (use_actual)
     {
       joint_angle = reference_link->actuating_joint_->current_position_;
     }
-    joint->current_transform_ = createDHMatrix(reference_link->dh_parameter_d_,
-                                               reference_link->dh_parameter_theta_ + joint_angle,
-                                               reference_link->dh_parameter_r_,
-                                               reference_link->dh_parameter_alpha_);
+    if (joint_angle != joint->transform_position_)
+    {
+      joint->current_transform_ = createDHMatrix(reference_link->dh_parameter_d_,
+                                                 reference_link->dh_parameter_theta_ + joint_angle,
+                                                 reference_link->dh_parameter_r_,
+                                                 reference_link->dh_parameter_alpha_);
+      joint->transform_position_ = joint_angle;
+      chain_updated = true;
+    }
+    if (chain_updated)
+    {
+      joint->updateOriginTransform();
+    }
   }
-  const std::shared_ptr<Link> reference_link = tip_->reference_link_;
+  const std::shared_ptr<Link> &reference_link = tip_->reference_link_;
   double joint_angle = reference_link->actuating_joint_->desired_position_;
   if (use_actual)
   {
     joint_angle = reference_link->actuating_joint_->current_position_;
   }
-  tip_->current_transform_ = createDHMatrix(reference_link->dh_parameter_d_,
-                                            reference_link->dh_parameter_theta_ + joint_angle,
-                                            reference_link->dh_parameter_r_,
-                                            reference_link->dh_parameter_alpha_);
+  if (joint_angle != tip_->transform_position_)
+  {
+    tip_->current_transform_ = createDHMatrix(reference_link->dh_parameter_d_,
+                                              reference_link->dh_parameter_theta_ + joint_angle,
+                                              reference_link->dh_parameter_r_,
+                                              reference_link->dh_parameter_alpha_);
+    tip_->transform_position_ = joint_angle;
+    chain_updated = true;
+  }
+  if (chain_updated)
+  {
+    tip_->updateOriginTransform();
+  }
 
   // Get world frame position of tip
   Pose tip_pose = tip_->getPoseRobotFrame();
@@ -989,6 +1462,29 @@ Pose Leg::applyFK(const bool &set_current, const bool &use_actual)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+Pose Leg::calculateActualTipPose(void)
+{
+  // First joint transform is constant
+  JointContainer::iterator joint_it = joint_container_.begin();
+  Eigen::Matrix4d transform = joint_it->second->origin_transform_;
+  for (++joint_it; joint_it != joint_container_.end(); ++joint_it)
+  {
+    const std::shared_ptr<Link> &reference_link = joint_it->second->reference_link_;
+    transform *= createDHMatrix(reference_link->dh_parameter_d_,
+                                reference_link->dh_parameter_theta_ + reference_link->actuating_joint_->current_position_,
+                                reference_link->dh_parameter_r_,
+                                reference_link->dh_parameter_alpha_);
+  }
+  const std::shared_ptr<Link> &reference_link = tip_->reference_link_;
+  transform *= createDHMatrix(reference_link->dh_parameter_d_,
+                              reference_link->dh_parameter_theta_ + reference_link->actuating_joint_->current_position_,
+                              reference_link->dh_parameter_r_,
+                              reference_link->dh_parameter_alpha_);
+  return Pose::Identity().transform(transform);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 Link::Link(std::shared_ptr<Leg> leg, std::shared_ptr<Joint> actuating_joint,
            const int &id_number, const Parameters &params)
     : parent_leg_(leg)
@@ -1025,20 +1521,40 @@ Link::Link(std::shared_ptr<Link> link)
 
 Joint::Joint(std::shared_ptr<Leg> leg, std::shared_ptr<Link> reference_link,
              const int &id_number, const Parameters &params)
-    : parent_leg_(leg)
+    : state_store_(leg->getJointStateStore())
+    , state_index_(leg->getJointStateOffset() + id_number - 1)
+    , parent_leg_(leg)
     , reference_link_(reference_link)
     , id_number_(id_number)
     , id_name_(leg->getIDName() + "_" + params.joint_id.data[id_number_ - 1] + "_joint")
-    , min_position_(params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data.at("min"))
-    , max_position_(params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data.at("max"))
-    , offset_(params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data.at("offset"))
+    , min_position_(state_store_->min_positions_[state_index_])
+    , max_position_(state_store_->max_positions_[state_index_])
+    , offset_(state_store_->offsets_[state_index_])
     , unpacked_position_(params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data.at("unpacked"))
-    , max_angular_speed_(params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data.at("max_vel"))
+    , max_angular_speed_(state_store_->max_angular_speeds_[state_index_])
+    , desired_position_(state_store_->desired_positions_[state_index_])
+    , desired_velocity_(state_store_->desired_velocities_[state_index_])
+    , desired_effort_(state_store_->desired_efforts_[state_index_])
+    , prev_desired_position_(state_store_->prev_desired_positions_[state_index_])
+    , prev_desired_velocity_(state_store_->prev_desired_velocities_[state_index_])
+    , prev_desired_effort_(state_store_->prev_desired_efforts_[state_index_])
+    , current_position_(state_store_->current_positions_[state_index_])
+    , current_velocity_(state_store_->current_velocities_[state_index_])
+    , current_effort_(state_store_->current_efforts_[state_index_])
+    , default_position_(state_store_->default_positions_[state_index_])
+    , default_velocity_(state_store_->default_velocities_[state_index_])
+    , default_effort_(state_store_->default_efforts_[state_index_])
 {
+  // Populate joint limits within joint state store
+  std::map<std::string, double> joint_parameters = params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data;
+  state_store_->min_positions_[state_index_] = joint_parameters.at("min");
+  state_store_->max_positions_[state_index_] = joint_parameters.at("max");
+  state_store_->offsets_[state_index_] = joint_parameters.at("offset");
+  state_store_->max_angular_speeds_[state_index_] = joint_parameters.at("max_vel");
+
   default_position_ = clamped(0.0, min_position_, max_position_);
 
   // Populate packed configuration/s joint position/s
-  std::map<std::string, double> joint_parameters = params.joint_parameters[leg->getIDNumber()][id_number_ - 1].data;
   bool get_next_packed_position = true;
   std::string packed_position_key = "packed";
   int i = 0;
@@ -1064,6 +1580,7 @@ Joint::Joint(std::shared_ptr<Leg> leg, std::shared_ptr<Link> reference_link,
                                          reference_link_->dh_parameter_r_,
                                          reference_link_->dh_parameter_alpha_);
     current_transform_ = identity_transform_;
+    updateOriginTransform();
   }
   else
   {
@@ -1075,19 +1592,41 @@ Joint::Joint(std::shared_ptr<Leg> leg, std::shared_ptr<Link> reference_link,
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Joint::Joint(std::shared_ptr<Joint> joint)
-    : parent_leg_(joint->parent_leg_)
+    : state_store_(std::make_shared<JointStateStore>(1))
+    , state_index_(0)
+    , parent_leg_(joint->parent_leg_)
     , reference_link_(joint->reference_link_)
     , id_number_(joint->id_number_)
     , id_name_(joint->id_name_)
-    , min_position_(joint->min_position_)
-    , max_position_(joint->max_position_)
-    , offset_(joint->offset_)
+    , min_position_(state_store_->min_positions_[state_index_])
+    , max_position_(state_store_->max_positions_[state_index_])
+    , offset_(state_store_->offsets_[state_index_])
     , packed_positions_(joint->packed_positions_)
     , unpacked_position_(joint->unpacked_position_)
-    , max_angular_speed_(joint->max_angular_speed_)
+    , max_angular_speed_(state_store_->max_angular_speeds_[state_index_])
+    , desired_position_(state_store_->desired_positions_[state_index_])
+    , desired_velocity_(state_store_->desired_velocities_[state_index_])
+    , desired_effort_(state_store_->desired_efforts_[state_index_])
+    , prev_desired_position_(state_store_->prev_desired_positions_[state_index_])
+    , prev_desired_velocity_(state_store_->prev_desired_velocities_[state_index_])
+    , prev_desired_effort_(state_store_->prev_desired_efforts_[state_index_])
+    , current_position_(state_store_->current_positions_[state_index_])
+    , current_velocity_(state_store_->current_velocities_[state_index_])
+    , current_effort_(state_store_->current_efforts_[state_index_])
+    , default_position_(state_store_->default_positions_[state_index_])
+    , default_velocity_(state_store_->default_velocities_[state_index_])
+    , default_effort_(state_store_->default_efforts_[state_index_])
 {
+  state_store_->min_positions_[state_index_] = joint->min_position_;
+  state_store_->max_positions_[state_index_] = joint->max_position_;
+  state_store_->offsets_[state_index_] = joint->offset_;
+  state_store_->max_angular_speeds_[state_index_] = joint->max_angular_speed_;
+
   current_transform_ = joint->current_transform_;
   identity_transform_ = joint->identity_transform_;
+  origin_transform_ = joint->origin_transform_;
+  origin_transform_inverse_ = joint->origin_transform_inverse_;
+  transform_position_ = joint->transform_position_;
 
   desired_position_publisher_ = joint->desired_position_publisher_;
 
@@ -1110,8 +1649,33 @@ Joint::Joint(std::shared_ptr<Joint> joint)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Joint::Joint(void)
-    : parent_leg_(NULL), reference_link_(NULL), id_number_(0), id_name_("origin")
+    : state_store_(std::make_shared<JointStateStore>(1))
+    , state_index_(0)
+    , parent_leg_(NULL)
+    , reference_link_(NULL)
+    , id_number_(0)
+    , id_name_("origin")
+    , min_position_(state_store_->min_positions_[state_index_])
+    , max_position_(state_store_->max_positions_[state_index_])
+    , offset_(state_store_->offsets_[state_index_])
+    , max_angular_speed_(state_store_->max_angular_speeds_[state_index_])
+    , desired_position_(state_store_->desired_positions_[state_index_])
+    , desired_velocity_(state_store_->desired_velocities_[state_index_])
+    , desired_effort_(state_store_->desired_efforts_[state_index_])
+    , prev_desired_position_(state_store_->prev_desired_positions_[state_index_])
+    , prev_desired_velocity_(state_store_->prev_desired_velocities_[state_index_])
+    , prev_desired_effort_(state_store_->prev_desired_efforts_[state_index_])
+    , current_position_(state_store_->current_positions_[state_index_])
+    , current_velocity_(state_store_->current_velocities_[state_index_])
+    , current_effort_(state_store_->current_efforts_[state_index_])
+    , default_position_(state_store_->default_positions_[state_index_])
+    , default_velocity_(state_store_->default_velocities_[state_index_])
+    , default_effort_(state_store_->default_efforts_[state_index_])
 {
+  current_transform_ = Eigen::Matrix4d::Identity();
+  identity_transform_ = Eigen::Matrix4d::Identity();
+  origin_transform_ = Eigen::Matrix4d::Identity();
+  origin_transform_inverse_ = Eigen::Matrix4d::Identity();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1124,6 +1688,7 @@ Tip::Tip(std::shared_ptr<Leg> leg, std::shared_ptr<Link> reference_link)
                                        reference_link_->dh_parameter_r_,
                                        reference_link_->dh_parameter_alpha_);
   current_transform_ = identity_transform_;
+  updateOriginTransform();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1133,6 +1698,9 @@ Tip::Tip(std::shared_ptr<Tip> tip)
 {
   identity_transform_ = tip->identity_transform_;
   current_transform_ = tip->current_transform_;
+  origin_transform_ = tip->origin_transform_;
+  origin_transform_inverse_ = tip->origin_transform_inverse_;
+  transform_position_ = tip->transform_position_;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
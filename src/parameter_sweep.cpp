@@ -0,0 +1,320 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/state_controller.h"
+
+#include <fstream>
+#include <iomanip>
+
+#define DEFAULT_SWEEP_DURATION 30.0        ///< Default simulated walking time evaluated for each variant (sec)
+#define DEFAULT_SWEEP_OUTPUT "parameter_sweep_results.csv" ///< Default file path of sweep results table
+#define STARTUP_CYCLE_LIMIT 100000         ///< Max control cycles allowed for direct start up of each variant
+
+/// Struct containing the results of evaluating a single parameter variant in simulation.
+struct SweepResult
+{
+  std::vector<double> values_;             ///< The swept parameter values defining the variant
+  bool started_ = false;                   ///< Flag denoting if the variant reached its walking stance
+  int cycles_ = 0;                         ///< Number of simulated walking control cycles
+  int ik_deviation_count_ = 0;             ///< Number of leg IK solutions deviating from desired tip position
+  double min_limit_proximity_ = 1.0;       ///< Minimum joint limit proximity (0.0 = at limit, 1.0 = furthest away)
+  double max_linear_speed_ = 0.0;          ///< Max linear body speed in the forward direction from walk limits (m/s)
+  double max_angular_speed_ = 0.0;         ///< Max angular body speed from walk limits (rad/s)
+  Pose odometry_ = Pose::Identity();       ///< Ideal odometry accumulated over the simulated walk
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+typedef std::vector<SweepResult, Eigen::aligned_allocator<SweepResult>> SweepResultVector;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Sets the value of a sweepable parameter. Adjustable parameters are clamped within their allowed range as they are
+/// for dynamic reconfiguration.
+/// @param[in] name The name of the parameter (as defined on the parameter server)
+/// @param[in] value The new value of the parameter
+/// @param[out] params Pointer to the parameter data structure to modify
+/// @return Bool denoting if the parameter name is sweepable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool setSweepParameter(const std::string& name, const double& value, Parameters* params)
+{
+  AdjustableParameter* adjustable = NULL;
+  if (name == "step_frequency")
+  {
+    adjustable = &params->step_frequency;
+  }
+  else if (name == "swing_height")
+  {
+    adjustable = &params->swing_height;
+  }
+  else if (name == "swing_width")
+  {
+    adjustable = &params->swing_width;
+  }
+  else if (name == "step_depth")
+  {
+    adjustable = &params->step_depth;
+  }
+  else if (name == "stance_span_modifier")
+  {
+    adjustable = &params->stance_span_modifier;
+  }
+  else if (name == "body_clearance")
+  {
+    params->body_clearance.data = value;
+    return true;
+  }
+  else if (name == "auto_posing")
+  {
+    params->auto_posing.data = (value != 0.0);
+    return true;
+  }
+  else if (name == "pose_frequency")
+  {
+    params->pose_frequency.data = value;
+    return true;
+  }
+  else
+  {
+    return false;
+  }
+  adjustable->current_value = clamped(value, adjustable->min_value, adjustable->max_value);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Evaluates a parameter variant by building an isolated robot model, walk controller and pose controller, executing a
+/// direct start up and walking in lockstep simulation with a constant velocity input. Desired joint states are fed
+/// back as current joint states each cycle.
+/// @param[in] params The parameter data structure of the variant (must outlive evaluation)
+/// @param[in] velocity_input The body velocity input [linear_x, linear_y, angular_z] applied whilst walking
+/// @param[in] duration The simulated walking time (sec)
+/// @param[in,out] result Pointer to the result object to populate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void evaluateVariant(const Parameters& params, const Eigen::Vector3d& velocity_input,
+                     const double& duration, SweepResult* result)
+{
+  std::shared_ptr<DebugVisualiser> debug_visualiser =
+      std::allocate_shared<DebugVisualiser>(Eigen::aligned_allocator<DebugVisualiser>());
+  std::shared_ptr<Model> model =
+      std::allocate_shared<Model>(Eigen::aligned_allocator<Model>(), params, debug_visualiser);
+  model->generate();
+  model->initLegs(true);
+  std::shared_ptr<WalkController> walker =
+      std::allocate_shared<WalkController>(Eigen::aligned_allocator<WalkController>(), model, params);
+  walker->init();
+  std::shared_ptr<PoseController> poser =
+      std::allocate_shared<PoseController>(Eigen::aligned_allocator<PoseController>(), model, params);
+  poser->init();
+
+  // Direct start up to default stance
+  int startup_cycles = 0;
+  while (poser->directStartup() != PROGRESS_COMPLETE && startup_cycles < STARTUP_CYCLE_LIMIT)
+  {
+    startup_cycles++;
+  }
+  if (startup_cycles == STARTUP_CYCLE_LIMIT)
+  {
+    return;
+  }
+  result->started_ = true;
+  model->updateDefaultConfiguration();
+  model->generateWorkspaces();
+  walker->generateWalkspace();
+
+  // Max reachable body speeds from walk controller limits
+  result->max_linear_speed_ = walker->getLimits(Eigen::Vector2d::UnitX(), 0.0)[LINEAR_SPEED_LIMIT];
+  result->max_angular_speed_ = walker->getLimits(Eigen::Vector2d::Zero(), 1.0)[ANGULAR_SPEED_LIMIT];
+
+  // Walk in lockstep simulation, scaling velocity input as for user input
+  std::shared_ptr<JointStateStore> store = model->getJointStateStore();
+  Eigen::Vector2d linear_velocity_input =
+      Eigen::Vector2d(velocity_input[0], velocity_input[1]) * params.body_velocity_scaler.data;
+  double angular_velocity_input = velocity_input[2] * params.body_velocity_scaler.data;
+  int cycles = roundToInt(duration / params.time_delta.data);
+  for (int i = 0; i < cycles; ++i)
+  {
+    poser->updateCurrentPose(RUNNING);
+    walker->setPoseState(poser->getAutoPoseState());
+    walker->updateWalk(linear_velocity_input, angular_velocity_input);
+    poser->updateStance();
+
+    // Equivalent to Model::updateModel, retaining the IK result of each leg for scoring
+    LegContainer::iterator leg_it;
+    for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+    {
+      std::shared_ptr<Leg> leg = leg_it->second;
+      leg->setDesiredTipPose();
+      double ik_result = leg->applyIK();
+      if (ik_result == 0.0)
+      {
+        result->ik_deviation_count_++;
+      }
+      else
+      {
+        result->min_limit_proximity_ = std::min(result->min_limit_proximity_, ik_result);
+      }
+    }
+
+    std::copy(store->desired_positions_.begin(), store->desired_positions_.end(), store->current_positions_.begin());
+    std::copy(store->desired_velocities_.begin(), store->desired_velocities_.end(),
+              store->current_velocities_.begin());
+    result->cycles_++;
+  }
+  result->odometry_ = walker->getOdometryIdeal();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Writes the results of all evaluated parameter variants as a CSV table.
+/// @param[in] file_path The file path of the results table
+/// @param[in] names The names of the swept parameters
+/// @param[in] results The results of each evaluated parameter variant
+/// @return Bool denoting if the results table was successfully written
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool writeResults(const std::string& file_path, const std::vector<std::string>& names,
+                  const SweepResultVector& results)
+{
+  std::ofstream file(file_path.c_str());
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  for (uint i = 0; i < names.size(); ++i)
+  {
+    file << names[i] << ",";
+  }
+  file << "started,cycles,ik_deviation_count,min_limit_proximity,max_linear_speed,max_angular_speed,"
+       << "odometry_x,odometry_y,odometry_yaw\n";
+  file << std::fixed << std::setprecision(6);
+  for (uint i = 0; i < results.size(); ++i)
+  {
+    const SweepResult& result = results[i];
+    for (uint j = 0; j < result.values_.size(); ++j)
+    {
+      file << result.values_[j] << ",";
+    }
+    Eigen::Vector3d euler_angles = quaternionToEulerAngles(result.odometry_.rotation_);
+    file << int(result.started_) << "," << result.cycles_ << "," << result.ik_deviation_count_ << ","
+         << result.min_limit_proximity_ << "," << result.max_linear_speed_ << "," << result.max_angular_speed_ << ","
+         << result.odometry_.position_[0] << "," << result.odometry_.position_[1] << "," << euler_angles[2] << "\n";
+  }
+  return file.good();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Parameter sweep executable. Acquires base parameters from the parameter server (see launch/parameter_sweep.launch)
+/// and evaluates every combination of the swept parameter values concurrently, each in an isolated lockstep
+/// simulation, writing a results table of scores for each variant. The sweep is defined by private parameters:
+/// ~parameters (list of swept parameter names), ~values/<name> (list of values for each swept parameter), ~threads,
+/// ~duration (simulated walking time per variant), ~velocity ([linear_x, linear_y, angular_z]) and ~output.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int main(int argc, char* argv[])
+{
+  ros::init(argc, argv, "shc_parameter_sweep");
+  ros::NodeHandle private_n("~");
+
+  // Acquire base parameters
+  StateController state;
+  Parameters base_params = state.getParameters();
+  base_params.adjustable_map.clear(); // Refers to parameters of state controller
+  base_params.debug_rviz.data = false;
+  base_params.ignore_IK_warnings.data = true;
+
+  // Acquire sweep definition
+  std::vector<std::string> names;
+  private_n.getParam("parameters", names);
+  std::vector<std::vector<double>> values(names.size());
+  for (uint i = 0; i < names.size(); ++i)
+  {
+    Parameters test_params = base_params;
+    if (!private_n.getParam("values/" + names[i], values[i]) || values[i].empty() ||
+        !setSweepParameter(names[i], 0.0, &test_params))
+    {
+      ROS_FATAL("\nInvalid sweep definition for parameter '%s'. Sweepable parameters are: step_frequency, "
+                "swing_height, swing_width, step_depth, stance_span_modifier, body_clearance, auto_posing and "
+                "pose_frequency.\n", names[i].c_str());
+      return 1;
+    }
+  }
+
+  int thread_count;
+  double duration;
+  std::vector<double> velocity;
+  std::string output;
+  private_n.param("threads", thread_count, int(std::max(1u, std::thread::hardware_concurrency())));
+  private_n.param("duration", duration, DEFAULT_SWEEP_DURATION);
+  private_n.param("velocity", velocity, std::vector<double>({ 1.0, 0.0, 0.0 }));
+  private_n.param("output", output, std::string(DEFAULT_SWEEP_OUTPUT));
+  if (velocity.size() != 3)
+  {
+    ROS_FATAL("\nSweep velocity must be defined as [linear_x, linear_y, angular_z].\n");
+    return 1;
+  }
+  Eigen::Vector3d velocity_input(velocity[0], velocity[1], velocity[2]);
+
+  // Generate all combinations of swept parameter values
+  std::vector<Parameters> variant_params;
+  SweepResultVector results;
+  std::vector<uint> value_index(names.size(), 0);
+  bool variants_complete = false;
+  while (!variants_complete)
+  {
+    Parameters params = base_params;
+    SweepResult result;
+    for (uint i = 0; i < names.size(); ++i)
+    {
+      setSweepParameter(names[i], values[i][value_index[i]], &params);
+      result.values_.push_back(values[i][value_index[i]]);
+    }
+    variant_params.push_back(params);
+    results.push_back(result);
+
+    // Increment value indices as a mixed radix counter
+    variants_complete = true;
+    for (uint i = 0; i < names.size() && variants_complete; ++i)
+    {
+      value_index[i] = (value_index[i] + 1) % values[i].size();
+      variants_complete = (value_index[i] == 0);
+    }
+  }
+
+  // Evaluate variants concurrently, each worker taking the next unevaluated variant
+  int variant_count = int(results.size());
+  thread_count = clamped(thread_count, 1, variant_count);
+  ROS_INFO("\nEvaluating %d parameter variants using %d threads . . .\n", variant_count, thread_count);
+  std::atomic<int> next_variant(0);
+  std::atomic<int> completed_variants(0);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < thread_count; ++i)
+  {
+    workers.push_back(std::thread([&]()
+    {
+      int variant;
+      while ((variant = next_variant++) < variant_count && ros::ok())
+      {
+        evaluateVariant(variant_params[variant], velocity_input, duration, &results[variant]);
+        ROS_INFO("\nEvaluated parameter variant %d/%d.\n", ++completed_variants, variant_count);
+      }
+    }));
+  }
+  for (uint i = 0; i < workers.size(); ++i)
+  {
+    workers[i].join();
+  }
+
+  if (!writeResults(output, names, results))
+  {
+    ROS_ERROR("\nFailed to write parameter sweep results to '%s'.\n", output.c_str());
+    return 1;
+  }
+  ROS_INFO("\nParameter sweep results written to '%s'.\n", output.c_str());
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
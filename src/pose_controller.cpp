@@ -8,6 +8,9 @@
 
 #include "syropod_highlevel_controller/pose_controller.h"
 #include "syropod_highlevel_controller/walk_controller.h"
+#include "syropod_highlevel_controller/real_time.h"
+
+#include <iomanip>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -27,6 +30,14 @@ PoseController::PoseController(std::shared_ptr<Model> model, const Parameters& p
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+PoseController::PoseController(std::shared_ptr<Model> model, std::shared_ptr<const Parameters> params)
+  : PoseController(model, *params)
+{
+  owned_params_ = params;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void PoseController::init(void)
 {
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
@@ -149,15 +160,34 @@ int PoseController::executeSequence(const SequenceSelection& sequence)
   // Initialise/Reset any saved transition sequence
   if (reset_transition_sequence_ && sequence == START_UP)
   {
+    // Use sequence planned in simulation for current stance if available (waiting for any in progress planning)
+    bool planned_sequence = false;
+    if (params_.plan_transition_sequence.data && !sequence_planner_)
+    {
+      planSequence();
+      if (sequence_planning_.valid())
+      {
+        return -1;
+      }
+      planned_sequence = loadPlannedSequence();
+    }
+
     reset_transition_sequence_ = false;
-    first_sequence_execution_ = true;
+    first_sequence_execution_ = !planned_sequence;
     transition_step_ = 0;
     for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
     {
       std::shared_ptr<Leg> leg = leg_it_->second;
       std::shared_ptr<LegPoser> leg_poser = leg->getLegPoser();
-      leg_poser->resetTransitionSequence();
-      leg_poser->addTransitionPose(leg->getCurrentTipPose()); // Initial transition position
+      if (!planned_sequence)
+      {
+        leg_poser->resetTransitionSequence();
+        leg_poser->addTransitionPose(leg->getCurrentTipPose()); // Initial transition position
+      }
+      else
+      {
+        ROS_DEBUG_COND(debug, "\nLeg %s using planned transition sequence.\n", leg->getIDName().c_str());
+      }
     }
   }
 
@@ -434,8 +464,8 @@ int PoseController::executeSequence(const SequenceSelection& sequence)
     transition_step_target = transition_step_;
   }
 
-  // Check for excessive transition steps
-  if (transition_step_ > TRANSITION_STEP_THRESHOLD)
+  // Check for excessive transition steps (sequence planner reports failure instead)
+  if (transition_step_ > TRANSITION_STEP_THRESHOLD && !sequence_planner_)
   {
     ROS_FATAL("\nUnable to execute sequence, shutting down controller.\n");
     ros::shutdown();
@@ -460,6 +490,171 @@ int PoseController::executeSequence(const SequenceSelection& sequence)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+const std::string& PoseController::generateSequenceKey(void)
+{
+  // Generated sequence depends on initial and target tip positions and body pose (rounded to mm precision)
+  std::vector<double> &stance = sequence_stance_;
+  stance.clear();
+  Eigen::Vector3d body_position = setPrecision(model_->getCurrentPose().position_, 3);
+  Eigen::Vector3d body_rotation = setPrecision(quaternionToEulerAngles(model_->getCurrentPose().rotation_), 3);
+  stance.insert(stance.end(), body_position.data(), body_position.data() + 3);
+  stance.insert(stance.end(), body_rotation.data(), body_rotation.data() + 3);
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  {
+    std::shared_ptr<Leg> leg = leg_it_->second;
+    Eigen::Vector3d tip_position = setPrecision(leg->getCurrentTipPose().position_, 3);
+    Eigen::Vector3d default_tip_position = setPrecision(leg->getLegStepper()->getDefaultTipPose().position_, 3);
+    stance.insert(stance.end(), tip_position.data(), tip_position.data() + 3);
+    stance.insert(stance.end(), default_tip_position.data(), default_tip_position.data() + 3);
+  }
+
+  // Rebuild key only if stance has changed since last generated
+  if (!sequence_key_.empty() && stance == sequence_key_stance_)
+  {
+    return sequence_key_;
+  }
+  sequence_key_stance_ = stance;
+
+  std::ostringstream key;
+  key << std::fixed << std::setprecision(3);
+  key << body_position.transpose() << ":";
+  key << body_rotation.transpose() << ":";
+  int index = 6;
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  {
+    key << leg_it_->second->getIDName() << ":";
+    key << Eigen::Map<const Eigen::Vector3d>(&stance[index]).transpose() << ":";
+    key << Eigen::Map<const Eigen::Vector3d>(&stance[index + 3]).transpose() << ":";
+    index += 6;
+  }
+  sequence_key_ = key.str();
+  return sequence_key_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PoseController::planSequence(void)
+{
+  // Collect results of completed sequence planning
+  if (sequence_planning_.valid())
+  {
+    if (sequence_planning_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      return;
+    }
+    if (sequence_planning_.get())
+    {
+      TransitionSequence transition_sequence;
+      transition_sequence.transition_step_count_ = sequence_planning_poser_->transition_step_count_;
+      std::shared_ptr<Model> planning_model = sequence_planning_poser_->model_;
+      for (leg_it_ = planning_model->getLegContainer()->begin();
+           leg_it_ != planning_model->getLegContainer()->end(); ++leg_it_)
+      {
+        std::shared_ptr<Leg> leg = leg_it_->second;
+        transition_sequence.transition_poses_[leg->getIDNumber()] = leg->getLegPoser()->getTransitionSequence();
+      }
+      planned_sequence_key_ = sequence_planning_key_;
+      planned_sequence_ = transition_sequence;
+      ROS_INFO("\n[SHC] Transition sequence planned (%d transition steps).\n",
+               transition_sequence.transition_step_count_);
+    }
+    else
+    {
+      failed_sequence_key_ = sequence_planning_key_;
+      ROS_WARN("\n[SHC] Unable to plan transition sequence, sequence will be generated during execution.\n");
+    }
+    sequence_planning_poser_ = NULL;
+  }
+
+  // Plan sequence for current stance configuration if not previously planned
+  if (!reset_transition_sequence_)
+  {
+    return;
+  }
+  const std::string &key = generateSequenceKey();
+  if (key == planned_sequence_key_ || key == failed_sequence_key_)
+  {
+    return;
+  }
+
+  // Create copy of model and pose controller (created on this thread so the original model is not accessed by planner)
+  // using a copy of parameters owned by the planner, since the original parameters may be modified whilst planning
+  std::shared_ptr<const Parameters> planning_params = std::make_shared<const Parameters>(params_);
+  std::shared_ptr<Model> planning_model =
+    std::allocate_shared<Model>(Eigen::aligned_allocator<Model>(), model_, *planning_params);
+  planning_model->generate(model_);
+
+  // Detach planning leg steppers from the walk controller of the control thread via a copy using planner parameters
+  std::shared_ptr<WalkController> walker = model_->getLegByIDNumber(0)->getLegStepper()->getWalker();
+  std::shared_ptr<WalkController> planning_walker =
+    std::allocate_shared<WalkController>(Eigen::aligned_allocator<WalkController>(), walker, planning_model,
+                                         *planning_params);
+  for (leg_it_ = planning_model->getLegContainer()->begin();
+       leg_it_ != planning_model->getLegContainer()->end(); ++leg_it_)
+  {
+    leg_it_->second->getLegStepper()->setWalker(planning_walker);
+  }
+
+  sequence_planning_poser_ =
+    std::allocate_shared<PoseController>(Eigen::aligned_allocator<PoseController>(), planning_model, planning_params);
+  sequence_planning_poser_->init();
+  sequence_planning_poser_->sequence_planner_ = true;
+  sequence_planning_poser_->manual_pose_ = manual_pose_;
+  sequence_planning_poser_->walk_plane_pose_ = walk_plane_pose_;
+  sequence_planning_poser_->origin_walk_plane_pose_ = origin_walk_plane_pose_;
+  sequence_planning_key_ = key;
+  std::shared_ptr<PoseController> planning_poser = sequence_planning_poser_;
+  sequence_planning_ = std::async(std::launch::async, [planning_poser]()
+  {
+    resetRealTime(); // Planning must never delay a real time control thread
+    return planning_poser->generateSequence();
+  });
+  ROS_INFO("\n[SHC] Planning transition sequence . . .\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PoseController::generateSequence(void)
+{
+  // Mirror control loop of state controller (posing update followed by sequence execution) until sequence complete
+  while (transition_step_ <= TRANSITION_STEP_THRESHOLD && ros::ok())
+  {
+    updateCurrentPose(READY);
+    if (executeSequence(START_UP) == PROGRESS_COMPLETE)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool PoseController::loadPlannedSequence(void)
+{
+  if (planned_sequence_key_.empty() || generateSequenceKey() != planned_sequence_key_)
+  {
+    return false;
+  }
+
+  const TransitionSequence &transition_sequence = planned_sequence_;
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  {
+    std::shared_ptr<Leg> leg = leg_it_->second;
+    std::shared_ptr<LegPoser> leg_poser = leg->getLegPoser();
+    leg_poser->resetTransitionSequence();
+    const TransitionPoses &transition_poses = transition_sequence.transition_poses_.at(leg->getIDNumber());
+    for (const Pose &transition_pose : transition_poses)
+    {
+      leg_poser->addTransitionPose(transition_pose);
+    }
+  }
+  transition_step_count_ = transition_sequence.transition_step_count_;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 int PoseController::directStartup(void) // Simultaneous leg coordination
 {
   int progress = 0; // Percentage progress (0%->100%)
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/profiler.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void TimingStatistics::addSample(const double& duration)
+{
+  min_ = (count_ == 0) ? duration : std::min(min_, duration);
+  max_ = (count_ == 0) ? duration : std::max(max_, duration);
+  sum_ += duration;
+  count_++;
+
+  int bucket = 0;
+  if (duration > TIMING_HISTOGRAM_MINIMUM)
+  {
+    bucket = int(TIMING_BUCKETS_PER_DECADE * log10(duration / TIMING_HISTOGRAM_MINIMUM));
+    bucket = clamped(bucket, 0, TIMING_HISTOGRAM_BUCKET_COUNT - 1);
+  }
+  histogram_[bucket]++;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+double TimingStatistics::getPercentile(const double& percentile) const
+{
+  if (count_ == 0)
+  {
+    return 0.0;
+  }
+
+  uint64_t target_count = uint64_t(ceil(percentile * count_));
+  uint64_t cumulative_count = 0;
+  for (int i = 0; i < TIMING_HISTOGRAM_BUCKET_COUNT; ++i)
+  {
+    cumulative_count += histogram_[i];
+    if (cumulative_count >= target_count)
+    {
+      // Upper bound of bucket, limited by actual maximum sample
+      double upper_bound = TIMING_HISTOGRAM_MINIMUM * pow(10.0, double(i + 1) / TIMING_BUCKETS_PER_DECADE);
+      return std::min(upper_bound, max_);
+    }
+  }
+  return max_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Profiler::Profiler(const bool& enabled, const double& period)
+  : enabled_(enabled)
+  , period_(period)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::addSample(const TimingStage& stage, const double& duration)
+{
+  statistics_[stage].addSample(duration);
+  if (stage == CONTROL_CYCLE_TIMING && duration > period_)
+  {
+    overrun_count_++;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::generateTimingMsg(syropod_highlevel_controller::TimingState* msg) const
+{
+  msg->header.stamp = ros::Time::now();
+  msg->stage_names.clear();
+  msg->sample_counts.clear();
+  msg->min_durations.clear();
+  msg->mean_durations.clear();
+  msg->percentile_durations.clear();
+  msg->max_durations.clear();
+  for (int i = 0; i < TIMING_STAGE_COUNT; ++i)
+  {
+    const TimingStatistics& statistics = statistics_[i];
+    if (statistics.count_ > 0)
+    {
+      msg->stage_names.push_back(getStageName(static_cast<TimingStage>(i)));
+      msg->sample_counts.push_back(statistics.count_);
+      msg->min_durations.push_back(statistics.min_);
+      msg->mean_durations.push_back(statistics.getMean());
+      msg->percentile_durations.push_back(statistics.getPercentile(TIMING_PERCENTILE));
+      msg->max_durations.push_back(statistics.max_);
+    }
+  }
+  msg->percentile = TIMING_PERCENTILE;
+  msg->period = period_;
+  msg->overrun_count = overrun_count_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Profiler::dump(void) const
+{
+  if (!enabled_)
+  {
+    return;
+  }
+
+  std::ostringstream oss;
+  oss << "\nControl loop timing summary (usec):\n";
+  oss << std::left << std::setw(32) << "stage" << std::right
+      << std::setw(12) << "count" << std::setw(12) << "min" << std::setw(12) << "mean"
+      << std::setw(12) << "p" + std::to_string(int(TIMING_PERCENTILE * 100)) << std::setw(12) << "max" << "\n";
+  oss << std::fixed << std::setprecision(1);
+  for (int i = 0; i < TIMING_STAGE_COUNT; ++i)
+  {
+    const TimingStatistics& statistics = statistics_[i];
+    if (statistics.count_ > 0)
+    {
+      oss << std::left << std::setw(32) << getStageName(static_cast<TimingStage>(i)) << std::right
+          << std::setw(12) << statistics.count_
+          << std::setw(12) << statistics.min_ * 1.0e6
+          << std::setw(12) << statistics.getMean() * 1.0e6
+          << std::setw(12) << statistics.getPercentile(TIMING_PERCENTILE) * 1.0e6
+          << std::setw(12) << statistics.max_ * 1.0e6 << "\n";
+    }
+  }
+  oss << "Control cycles exceeding period of " << period_ * 1.0e6 << "usec: " << overrun_count_
+      << "/" << statistics_[CONTROL_CYCLE_TIMING].count_ << "\n";
+  ROS_INFO("%s", oss.str().c_str());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string Profiler::getStageName(const TimingStage& stage)
+{
+  switch (stage)
+  {
+    case (CONTROL_CYCLE_TIMING):
+      return "control_cycle";
+    case (CONTROL_LOOP_TIMING):
+      return "control_loop";
+    case (UPDATE_CURRENT_POSE_TIMING):
+      return "update_current_pose";
+    case (UPDATE_ADMITTANCE_TIMING):
+      return "update_admittance";
+    case (UPDATE_WALK_TIMING):
+      return "update_walk";
+    case (UPDATE_STANCE_TIMING):
+      return "update_stance";
+    case (UPDATE_MODEL_TIMING):
+      return "update_model";
+    case (PUBLISH_LEG_STATE_TIMING):
+      return "publish_leg_state";
+    case (PUBLISH_VELOCITY_TIMING):
+      return "publish_velocity";
+    case (PUBLISH_POSE_TIMING):
+      return "publish_pose";
+    case (PUBLISH_WALKSPACE_TIMING):
+      return "publish_walkspace";
+    case (PUBLISH_ROTATION_POSE_ERROR_TIMING):
+      return "publish_rotation_pose_error";
+    case (PUBLISH_FRAME_TRANSFORMS_TIMING):
+      return "publish_frame_transforms";
+    case (UPDATE_TELEMETRY_TIMING):
+      return "update_telemetry";
+    case (RVIZ_DEBUGGING_TIMING):
+      return "rviz_debugging";
+    case (PUBLISH_DESIRED_JOINT_STATE_TIMING):
+      return "publish_desired_joint_state";
+    case (WAKEUP_JITTER_TIMING):
+      return "wakeup_jitter";
+    default:
+      return "unknown";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
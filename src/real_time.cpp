@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/real_time.h"
+
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#define NSEC_PER_SEC 1000000000LL ///< Number of nanoseconds per second
+
+/// Reads the monotonic clock.
+/// @return The current time of the monotonic clock (nsec)
+inline int64_t getMonotonicTime(void)
+{
+  struct timespec time;
+  clock_gettime(CLOCK_MONOTONIC, &time);
+  return int64_t(time.tv_sec) * NSEC_PER_SEC + time.tv_nsec;
+}
+
+/// Touches each page of a stack allocated buffer so that stack pages are faulted in before real time execution.
+void prefaultStack(void)
+{
+  volatile unsigned char stack[REAL_TIME_STACK_PREFAULT_SIZE];
+  long page_size = sysconf(_SC_PAGESIZE);
+  for (long i = 0; i < REAL_TIME_STACK_PREFAULT_SIZE; i += page_size)
+  {
+    stack[i] = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool initRealTime(const int& core, const int& priority)
+{
+  bool success = true;
+
+  // Lock current and future pages and prevent freed heap memory returning to the system (or being mmap allocated)
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+  {
+    ROS_WARN("\n[SHC] Real time mode unable to lock memory (%s).\n", strerror(errno));
+    success = false;
+  }
+  else
+  {
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+
+    // Prefault heap and stack so that later allocations and deep calls do not page fault
+    long page_size = sysconf(_SC_PAGESIZE);
+    unsigned char* heap = static_cast<unsigned char*>(malloc(REAL_TIME_HEAP_PREFAULT_SIZE));
+    if (heap != NULL)
+    {
+      for (long i = 0; i < REAL_TIME_HEAP_PREFAULT_SIZE; i += page_size)
+      {
+        heap[i] = 0;
+      }
+      free(heap);
+    }
+    prefaultStack();
+  }
+
+  // Pin control thread to requested core
+  if (core >= 0)
+  {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(core, &cpu_set);
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+    if (result != 0)
+    {
+      ROS_WARN("\n[SHC] Real time mode unable to pin control thread to core %d (%s).\n", core, strerror(result));
+      success = false;
+    }
+  }
+
+  // Raise control thread to real time scheduling priority
+  struct sched_param scheduling_parameters;
+  scheduling_parameters.sched_priority = clamped(priority, sched_get_priority_min(SCHED_FIFO),
+                                                 sched_get_priority_max(SCHED_FIFO));
+  int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &scheduling_parameters);
+  if (result != 0)
+  {
+    ROS_WARN("\n[SHC] Real time mode unable to set SCHED_FIFO priority %d (%s).\n",
+             scheduling_parameters.sched_priority, strerror(result));
+    success = false;
+  }
+
+  if (success)
+  {
+    ROS_INFO("\n[SHC] Real time mode enabled (core %d, SCHED_FIFO priority %d).\n",
+             core, scheduling_parameters.sched_priority);
+  }
+  return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void resetRealTime(void)
+{
+  struct sched_param scheduling_parameters;
+  scheduling_parameters.sched_priority = 0;
+  int result = pthread_setschedparam(pthread_self(), SCHED_OTHER, &scheduling_parameters);
+  if (result != 0)
+  {
+    ROS_WARN("\n[SHC] Unable to reset helper thread to SCHED_OTHER scheduling (%s).\n", strerror(result));
+  }
+
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  int core_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int core = 0; core < core_count; ++core)
+  {
+    CPU_SET(core, &cpu_set);
+  }
+  result = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+  if (result != 0)
+  {
+    ROS_WARN("\n[SHC] Unable to unpin helper thread from real time core (%s).\n", strerror(result));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+RealTimeRate::RealTimeRate(const double& period)
+  : period_(std::max(int64_t(1), int64_t(period * NSEC_PER_SEC)))
+{
+  deadline_ = getMonotonicTime() + period_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+double RealTimeRate::sleep(void)
+{
+  // Reset deadline if overrun by more than a period rather than executing missed cycles back to back
+  int64_t now = getMonotonicTime();
+  if (now > deadline_ + period_)
+  {
+    deadline_ = now;
+  }
+
+  struct timespec deadline;
+  deadline.tv_sec = deadline_ / NSEC_PER_SEC;
+  deadline.tv_nsec = deadline_ % NSEC_PER_SEC;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR)
+  {
+  }
+
+  double jitter = double(std::max(int64_t(0), getMonotonicTime() - deadline_)) / double(NSEC_PER_SEC);
+  deadline_ += period_;
+  return jitter;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -8,22 +8,69 @@
 
 #include "syropod_highlevel_controller/state_controller.h"
 
+#include <boost/make_shared.hpp>
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-StateController::StateController(void)
+StateController::StateController(ros::CallbackQueue* callback_queue, const std::string& private_namespace)
+  : callback_queue_(callback_queue != NULL ? callback_queue : ros::getGlobalCallbackQueue())
+  , private_namespace_(private_namespace)
 {
   ros::NodeHandle n;
+  n.setCallbackQueue(callback_queue_);
 
   // Get parameters from parameter server and initialises parameter map
   initParameters();
 
+  // Create control loop timing profiler
+  profiler_ = std::allocate_shared<Profiler>(Eigen::aligned_allocator<Profiler>(),
+                                             params_.timing_profiler.data, params_.time_delta.data);
+  // Timing publishing disabled (zero divisor) for non positive publish rates
+  double timing_publish_rate = params_.timing_publish_rate.data;
+  timing_publish_divisor_ = 0;
+  if (timing_publish_rate > 0.0)
+  {
+    double divisor = 1.0 / (timing_publish_rate * params_.time_delta.data);
+    timing_publish_divisor_ = std::max(1, roundToInt(std::min(divisor, double(INT_MAX - 1))));
+  }
+
   // Create robot model
   std::shared_ptr<DebugVisualiser> debug_visualiser_ptr =
       std::allocate_shared<DebugVisualiser>(Eigen::aligned_allocator<DebugVisualiser>(), debug_visualiser_);
   model_ = std::allocate_shared<Model>(Eigen::aligned_allocator<Model>(), params_, debug_visualiser_ptr);
   model_->generate();
 
+  // Create persistent pool of worker threads for concurrent per leg IK and leg stepper updates
+  if (params_.parallel_leg_updates.data)
+  {
+    int worker_count = params_.leg_worker_threads.data;
+    if (worker_count <= 0)
+    {
+      int core_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+      worker_count = std::min(model_->getLegCount(), core_count) - 1;
+    }
+    model_->setWorkerPool(std::make_shared<WorkerPool>(worker_count));
+  }
+
+  // Create flight recorder and preallocate its ring buffer of per cycle records
+  if (params_.flight_recorder.data)
+  {
+    flight_recorder_ =
+      std::make_shared<FlightRecorder>(model_, params_.flight_recorder_length.data, params_.syropod_type.data);
+    flight_recorder_flush_subscriber_ = n.subscribe("/shc/flight_recorder/flush", 1,
+                                                    &StateController::flightRecorderFlushCallback, this);
+  }
+
+  // Create reporter of joint clamping and inverse kinematics deviation events
+  if (params_.IK_diagnostics_period.data > 0.0)
+  {
+    ik_diagnostics_ = std::make_shared<IKDiagnosticsReporter>(model_, params_.IK_diagnostics_period.data,
+                                                              !params_.ignore_IK_warnings.data,
+                                                              params_.syropod_type.data);
+  }
+
   debug_visualiser_.setTimeDelta(params_.time_delta.data);
+  debug_visualiser_.setRateDivisors(params_.debug_rviz_rate_divisors.data);
   transform_listener_ =
       std::allocate_shared<tf2_ros::TransformListener>(Eigen::aligned_allocator<tf2_ros::TransformListener>(),
                                                        transform_buffer_);
@@ -33,8 +80,11 @@ StateController::StateController(void)
                                          &StateController::systemStateCallback, this);
   robot_state_subscriber_ = n.subscribe("syropod_remote/robot_state", 1,
                                         &StateController::robotStateCallback, this);
-  desired_velocity_subscriber_ = n.subscribe("syropod_remote/desired_velocity", 1,
-                                             &StateController::bodyVelocityInputCallback, this);
+  if (!params_.threaded_callbacks.data)
+  {
+    desired_velocity_subscriber_ = n.subscribe("syropod_remote/desired_velocity", 1,
+                                               &StateController::bodyVelocityInputCallback, this);
+  }
   desired_pose_subscriber_ = n.subscribe("syropod_remote/desired_pose", 1,
                                          &StateController::bodyPoseInputCallback, this);
   posing_mode_subscriber_ = n.subscribe("syropod_remote/posing_mode", 1,
@@ -80,15 +130,48 @@ StateController::StateController(void)
   plan_step_request_publisher_ = n.advertise<std_msgs::Int8>("/shc/plan_step_request", 1000);
 
   // Motor and other sensor topic subscriptions
-  imu_data_subscriber_ = n.subscribe(params_.syropod_type.data + "/imu/data", 1, &StateController::imuCallback, this);
-  joint_state_subscriber_ = n.subscribe("/joint_states", 100, &StateController::jointStatesCallback, this);
-  tip_state_subscriber_ = n.subscribe("/tip_states", 1, &StateController::tipStatesCallback, this);
+  if (params_.threaded_callbacks.data)
+  {
+    // Service sensor and velocity inputs on own callback queue, staging latest values for the control thread
+    int joint_count = model_->getJointStateStore()->getJointCount();
+    input_accumulator_.joint_positions_.assign(joint_count, UNASSIGNED_VALUE);
+    input_accumulator_.joint_velocities_.assign(joint_count, 0.0);
+    input_accumulator_.joint_efforts_.assign(joint_count, 0.0);
+    input_accumulator_.joint_position_received_.assign(joint_count, false);
+    input_accumulator_.joint_velocity_received_.assign(joint_count, false);
+    input_accumulator_.joint_effort_received_.assign(joint_count, false);
+    staged_inputs_ = std::make_shared<SnapshotBuffer<StagedInputs>>(input_accumulator_);
+
+    ros::NodeHandle input_n;
+    input_n.setCallbackQueue(&input_callback_queue_);
+    imu_data_subscriber_ = input_n.subscribe(params_.syropod_type.data + "/imu/data", 1,
+                                             &StateController::stageImuCallback, this);
+    joint_state_subscriber_ = input_n.subscribe("/joint_states", 100, &StateController::stageJointStatesCallback, this);
+    tip_state_subscriber_ = input_n.subscribe("/tip_states", 1, &StateController::stageTipStatesCallback, this);
+    desired_velocity_subscriber_ = input_n.subscribe("syropod_remote/desired_velocity", 1,
+                                                     &StateController::stageBodyVelocityInputCallback, this);
+
+    // Single spinner thread ensures staged inputs snapshot buffer has a single writer
+    input_spinner_ = std::make_shared<ros::AsyncSpinner>(1, &input_callback_queue_);
+    input_spinner_->start();
+  }
+  else
+  {
+    imu_data_subscriber_ = n.subscribe(params_.syropod_type.data + "/imu/data", 1,
+                                       &StateController::imuCallback, this);
+    joint_state_subscriber_ = n.subscribe("/joint_states", 100, &StateController::jointStatesCallback, this);
+    tip_state_subscriber_ = n.subscribe("/tip_states", 1, &StateController::tipStatesCallback, this);
+  }
 
   // Set up debugging publishers
   velocity_publisher_ = n.advertise<geometry_msgs::Twist>("/shc/velocity", 1000);
   pose_publisher_ = n.advertise<geometry_msgs::Twist>("/shc/pose", 1000);
   walkspace_publisher_ = n.advertise<std_msgs::Float32MultiArray>("/shc/walkspace", 1000);
   rotation_pose_error_publisher_ = n.advertise<std_msgs::Float32MultiArray>("/shc/rotation_pose_error", 1000);
+  if (params_.timing_profiler.data)
+  {
+    timing_publisher_ = n.advertise<syropod_highlevel_controller::TimingState>("/shc/timing", 1);
+  }
 
   // Set up combined desired joint state publisher
   if (params_.combined_control_interface.data)
@@ -120,6 +203,15 @@ StateController::StateController(void)
 
 StateController::~StateController(void)
 {
+  if (input_spinner_ != NULL)
+  {
+    input_spinner_->stop();
+  }
+  telemetry_running_ = false;
+  if (telemetry_thread_.joinable())
+  {
+    telemetry_thread_.join();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +243,61 @@ void StateController::init(void)
   poser_->init();
   admittance_ = 
     std::allocate_shared<AdmittanceController>(Eigen::aligned_allocator<AdmittanceController>(), model_, params_);
+  workspace_cache_ =
+    std::allocate_shared<WorkspaceCache>(Eigen::aligned_allocator<WorkspaceCache>(), model_, walker_, params_);
+
+  // Preallocate published messages with constant fields populated
+  int joint_count = model_->getJointStateStore()->getJointCount();
+  desired_joint_state_msg_.name.clear();
+  desired_joint_state_msg_.position.assign(joint_count, 0.0);
+  desired_joint_state_msg_.velocity.assign(joint_count, 0.0);
+  desired_joint_state_msg_.effort.assign(joint_count, 0.0);
+  leg_state_msgs_.assign(model_->getLegCount(), syropod_highlevel_controller::LegState());
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  {
+    std::shared_ptr<Leg> leg = leg_it_->second;
+    for (joint_it_ = leg->getJointContainer()->begin(); joint_it_ != leg->getJointContainer()->end(); ++joint_it_)
+    {
+      desired_joint_state_msg_.name.push_back(joint_it_->second->id_name_);
+    }
+    syropod_highlevel_controller::LegState &msg = leg_state_msgs_[leg->getIDNumber()];
+    msg.name = leg->getIDName();
+    msg.walker_tip_pose.header.frame_id = "walk_plane";
+    msg.target_tip_pose.header.frame_id = "walk_plane";
+    msg.poser_tip_pose.header.frame_id = "base_link";
+    msg.model_tip_pose.header.frame_id = "base_link";
+    msg.actual_tip_pose.header.frame_id = "base_link";
+    msg.model_tip_velocity.header.frame_id = "base_link";
+    msg.joint_positions.assign(leg->getJointCount(), 0.0);
+    msg.joint_velocities.assign(leg->getJointCount(), 0.0);
+    msg.joint_efforts.assign(leg->getJointCount(), 0.0);
+  }
+  frame_transforms_.reserve(2 + joint_count + model_->getLegCount());
+  published_frame_transforms_.assign(joint_count + model_->getLegCount(), geometry_msgs::TransformStamped());
+
+  // Start telemetry thread, publishing from preallocated snapshots
+  if (params_.threaded_telemetry.data && !telemetry_thread_.joinable())
+  {
+    const std::string topic_names[TELEMETRY_TOPIC_COUNT] =
+        {"leg_state", "velocity", "pose", "walkspace", "rotation_pose_error", "frame_transforms"};
+    for (int i = 0; i < TELEMETRY_TOPIC_COUNT; ++i)
+    {
+      int divisor = 1;
+      if (params_.telemetry_rate_divisors.data.count(topic_names[i]))
+      {
+        divisor = std::max(1, params_.telemetry_rate_divisors.data.at(topic_names[i]));
+      }
+      telemetry_rate_divisors_[i] = divisor;
+    }
+    TelemetrySnapshot snapshot;
+    std::fill(snapshot.due_, snapshot.due_ + TELEMETRY_TOPIC_COUNT, false);
+    snapshot.leg_states_ = leg_state_msgs_;
+    snapshot.frame_transforms_.reserve(frame_transforms_.capacity());
+    telemetry_buffer_ = std::make_shared<SnapshotBuffer<TelemetrySnapshot>>(snapshot);
+    telemetry_cycle_ = 0;
+    telemetry_running_ = true;
+    telemetry_thread_ = std::thread(&StateController::runTelemetry, this);
+  }
 
   robot_state_ = UNKNOWN;
 
@@ -161,16 +308,26 @@ void StateController::init(void)
 
 void StateController::loop(void)
 {
+  ScopedTimer timer(profiler_.get(), CONTROL_LOOP_TIMING);
+
+  // Apply sensor and velocity inputs staged since last control cycle
+  applyStagedInputs();
+
   // Posing - updates currentPose for body compensation
   if (robot_state_ != UNKNOWN)
   {
-    poser_->updateCurrentPose(robot_state_);
+    {
+      ScopedTimer pose_timer(profiler_.get(), UPDATE_CURRENT_POSE_TIMING);
+      poser_->updateCurrentPose(robot_state_);
+    }
     walker_->setPoseState(poser_->getAutoPoseState()); // Sends pose state from poser to walker
     generateExternalTargetTransforms();
 
     // Admittance control - updates deltaZ values
     if (params_.admittance_control.data)
     {
+      ScopedTimer admittance_timer(profiler_.get(), UPDATE_ADMITTANCE_TIMING);
+
       // Calculate new stiffness based on walking cycle
       if (walker_->getWalkState() != STOPPED && params_.dynamic_stiffness.data)
       {
@@ -180,6 +337,13 @@ void StateController::loop(void)
     }
   }
 
+  // Plan start up sequence in background whilst waiting in READY state
+  if (robot_state_ == READY && !transition_state_flag_ &&
+      params_.start_up_sequence.data && params_.plan_transition_sequence.data)
+  {
+    poser_->planSequence();
+  }
+
   // Syropod state machine
   if (transition_state_flag_)
   {
@@ -190,6 +354,16 @@ void StateController::loop(void)
   {
     runningState();
   }
+
+  if (ik_diagnostics_ != NULL)
+  {
+    ik_diagnostics_->update();
+  }
+
+  if (flight_recorder_ != NULL)
+  {
+    recordFlightState();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -268,8 +442,7 @@ void StateController::transitionRobotState(void)
       ROS_INFO_THROTTLE(throttle, "\n[SHC] Syropod transitioning DIRECTLY to RUNNING state (%d%%). . .\n", progress);
       robot_state_ = READY;
       model_->updateDefaultConfiguration();
-      model_->generateWorkspaces();
-      walker_->generateWalkspace();
+      generateWorkspaces();
       ROS_INFO("\nDirect startup sequence complete. Place Syropod on walking surface and press START to proceed.\n");
     }
   }
@@ -318,8 +491,7 @@ void StateController::transitionRobotState(void)
     {
       walker_->init();
       model_->updateDefaultConfiguration();
-      model_->generateWorkspaces();
-      walker_->generateWalkspace();
+      generateWorkspaces();
       robot_state_ = RUNNING;
       ROS_INFO("\nState transition complete. Syropod is in RUNNING state. Ready to walk.\n");
     }
@@ -376,6 +548,25 @@ void StateController::transitionRobotState(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void StateController::generateWorkspaces(void)
+{
+  // Load workspaces and walkspace from cache if available
+  if (params_.use_workspace_cache.data && workspace_cache_->load())
+  {
+    return;
+  }
+
+  model_->generateWorkspaces();
+  walker_->generateWalkspace();
+
+  if (params_.use_workspace_cache.data)
+  {
+    workspace_cache_->save();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void StateController::runningState(void)
 {
   bool update_tip_position = true;
@@ -426,7 +617,10 @@ void StateController::runningState(void)
   if (update_tip_position)
   {
     // Update tip positions for walking legs
-    walker_->updateWalk(linear_velocity_input_, angular_velocity_input_);
+    {
+      ScopedTimer walk_timer(profiler_.get(), UPDATE_WALK_TIMING);
+      walker_->updateWalk(linear_velocity_input_, angular_velocity_input_);
+    }
 
     // Update tip positions for manually controlled legs
     walker_->updateManual(primary_leg_selection_, primary_tip_velocity_input_,
@@ -439,10 +633,16 @@ void StateController::runningState(void)
                           secondary_leg_selection_, secondary_pose_input_);
 
     // Pose controller takes current tip positions from walker and applies body posing
-    poser_->updateStance();
+    {
+      ScopedTimer stance_timer(profiler_.get(), UPDATE_STANCE_TIMING);
+      poser_->updateStance();
+    }
     
     // Model takes desired tip poses from pose controller and applies inverse/forwards kinematics
-    model_->updateModel();
+    {
+      ScopedTimer model_timer(profiler_.get(), UPDATE_MODEL_TIMING);
+      model_->updateModel();
+    }
   }
 }
 
@@ -776,108 +976,113 @@ void StateController::generateExternalTargetTransforms(void)
 
 void StateController::publishDesiredJointState(void)
 {
-  sensor_msgs::JointState joint_state_msg;
-  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  ScopedTimer timer(profiler_.get(), PUBLISH_DESIRED_JOINT_STATE_TIMING);
+  if (params_.combined_control_interface.data)
   {
-    std::shared_ptr<Leg> leg = leg_it_->second;
-    JointContainer::iterator joint_it;
-    if (params_.combined_control_interface.data)
+    // Joint state store holds joints of all legs contiguously in the same order as preallocated message names
+    const JointStateStore &store = *model_->getJointStateStore();
+    desired_joint_state_msg_.header.stamp = ros::Time::now();
+    std::copy(store.desired_positions_.begin(), store.desired_positions_.end(),
+              desired_joint_state_msg_.position.begin());
+    std::copy(store.desired_velocities_.begin(), store.desired_velocities_.end(),
+              desired_joint_state_msg_.velocity.begin());
+    std::copy(store.desired_efforts_.begin(), store.desired_efforts_.end(),
+              desired_joint_state_msg_.effort.begin());
+    if (intra_process_)
     {
-      leg->generateDesiredJointStateMsg(&joint_state_msg);
+      // Published message is shared with intra process subscribers so must not be modified by later cycles
+      desired_joint_state_publisher_.publish(boost::make_shared<sensor_msgs::JointState>(desired_joint_state_msg_));
     }
-    
-    if (params_.individual_control_interface.data)
+    else
     {
-      for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+      desired_joint_state_publisher_.publish(desired_joint_state_msg_);
+    }
+  }
+
+  if (params_.individual_control_interface.data)
+  {
+    for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+    {
+      std::shared_ptr<Leg> leg = leg_it_->second;
+      for (joint_it_ = leg->getJointContainer()->begin(); joint_it_ != leg->getJointContainer()->end(); ++joint_it_)
       {
-        std::shared_ptr<Joint> joint = joint_it->second;
+        const std::shared_ptr<Joint> &joint = joint_it_->second;
         std_msgs::Float64 position_command_msg;
         position_command_msg.data = joint->desired_position_ + joint->offset_;
         joint->desired_position_publisher_.publish(position_command_msg);
       }
     }
   }
+}
 
-  if (params_.combined_control_interface.data)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::publishLegState(void)
+{
+  ScopedTimer timer(profiler_.get(), PUBLISH_LEG_STATE_TIMING);
+  generateLegStateMsgs(&leg_state_msgs_);
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
   {
-    desired_joint_state_publisher_.publish(joint_state_msg);
+    std::shared_ptr<Leg> leg = leg_it_->second;
+    leg->publishState(leg_state_msgs_[leg->getIDNumber()]);
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void StateController::publishLegState(void)
+void StateController::generateLegStateMsgs(std::vector<syropod_highlevel_controller::LegState>* msgs)
 {
+  ros::Time now = ros::Time::now();
 
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
   {
-    syropod_highlevel_controller::LegState msg;
     std::shared_ptr<Leg> leg = leg_it_->second;
     std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
     std::shared_ptr<LegPoser> leg_poser = leg->getLegPoser();
-    msg.header.stamp = ros::Time::now();
-    msg.name = leg->getIDName().c_str();
+    syropod_highlevel_controller::LegState &msg = (*msgs)[leg->getIDNumber()];
+    msg.header.stamp = now;
 
     // Tip poses
-    msg.walker_tip_pose.header.stamp = ros::Time::now();
-    msg.walker_tip_pose.header.frame_id = "walk_plane";
+    msg.walker_tip_pose.header.stamp = now;
     msg.walker_tip_pose.pose = leg_stepper->getCurrentTipPose().toPoseMessage();
     
-    msg.target_tip_pose.header.stamp = ros::Time::now();
-    msg.target_tip_pose.header.frame_id = "walk_plane";
+    msg.target_tip_pose.header.stamp = now;
     msg.target_tip_pose.pose = leg_stepper->getTargetTipPose().toPoseMessage();
     
-    msg.poser_tip_pose.header.stamp = ros::Time::now();
-    msg.poser_tip_pose.header.frame_id = "base_link";
+    msg.poser_tip_pose.header.stamp = now;
     msg.poser_tip_pose.pose = leg_poser->getCurrentTipPose().toPoseMessage();
     
-    msg.model_tip_pose.header.stamp = ros::Time::now();
-    msg.model_tip_pose.header.frame_id = "base_link";
+    msg.model_tip_pose.header.stamp = now;
     msg.model_tip_pose.pose = leg->getCurrentTipPose().toPoseMessage();
     
-    msg.actual_tip_pose.header.stamp = ros::Time::now();
-    msg.actual_tip_pose.header.frame_id = "base_link";
-    msg.actual_tip_pose.pose = leg->applyFK(false, true).toPoseMessage();
-    leg->applyFK();
+    msg.actual_tip_pose.header.stamp = now;
+    msg.actual_tip_pose.pose = leg->calculateActualTipPose().toPoseMessage();
 
     // Tip velocities
-    msg.model_tip_velocity.header.stamp = ros::Time::now();
-    msg.model_tip_pose.header.frame_id = "base_link";
+    msg.model_tip_velocity.header.stamp = now;
     msg.model_tip_velocity.twist.linear.x = leg->getCurrentTipVelocity()[0];
     msg.model_tip_velocity.twist.linear.y = leg->getCurrentTipVelocity()[1];
     msg.model_tip_velocity.twist.linear.z = leg->getCurrentTipVelocity()[2];
 
     // Joint positions/velocities
-    for (joint_it_ = leg->getJointContainer()->begin(); joint_it_ != leg->getJointContainer()->end(); ++joint_it_)
-    {
-      std::shared_ptr<Joint> joint = joint_it_->second;
-      msg.joint_positions.push_back(joint->desired_position_);
-      msg.joint_velocities.push_back(joint->desired_velocity_);
-      msg.joint_efforts.push_back(joint->desired_effort_);
-    }
+    const JointStateStore &store = *leg->getJointStateStore();
+    const int begin = leg->getJointStateOffset();
+    const int end = begin + leg->getJointCount();
+    std::copy(store.desired_positions_.begin() + begin, store.desired_positions_.begin() + end,
+              msg.joint_positions.begin());
+    std::copy(store.desired_velocities_.begin() + begin, store.desired_velocities_.begin() + end,
+              msg.joint_velocities.begin());
+    std::copy(store.desired_efforts_.begin() + begin, store.desired_efforts_.begin() + end,
+              msg.joint_efforts.begin());
 
     // Step progress
     msg.swing_progress = leg_stepper->getSwingProgress();
     msg.stance_progress = leg_stepper->getStanceProgress();
-    StepCycle step = walker_->getStepCycle();
-    double swing_time = (double(step.swing_period_) / step.period_) / step.frequency_;
-    double stance_time = (double(step.stance_period_) / step.period_) / step.frequency_;
-    double time_to_swing_end;
-    if (leg_stepper->getStanceProgress() >= 0.0)
-    {
-      time_to_swing_end = stance_time * (1.0 - leg_stepper->getStanceProgress()) + swing_time;
-    }
-    else
-    {
-      time_to_swing_end = swing_time * (1.0 - leg_stepper->getSwingProgress());
-    }
-    msg.time_to_swing_end = time_to_swing_end;
-    msg.pose_delta = walker_->calculateOdometry(time_to_swing_end).toPoseMessage();
+    msg.time_to_swing_end = walker_->getTimeToSwingEnd(leg->getIDNumber());
+    msg.pose_delta = walker_->getSwingEndOdometry(leg->getIDNumber()).toPoseMessage();
 
     // Leg specific auto pose
-    Eigen::Vector3d position = leg_poser->getAutoPose().position_;
-    Eigen::Quaterniond rotation = leg_poser->getAutoPose().rotation_;
-    msg.auto_pose = Pose(position, rotation).toPoseMessage();
+    msg.auto_pose = leg_poser->getAutoPose().toPoseMessage();
 
     // Admittance controller
     msg.tip_force.x = leg->getTipForceCalculated()[0] * params_.force_gain.current_value;
@@ -887,8 +1092,6 @@ void StateController::publishLegState(void)
     msg.admittance_delta.y = leg->getAdmittanceDelta()[1];
     msg.admittance_delta.z = leg->getAdmittanceDelta()[2];
     msg.virtual_stiffness = leg->getVirtualStiffness();
-
-    leg->publishState(msg);
   }
 }
 
@@ -896,89 +1099,144 @@ void StateController::publishLegState(void)
 
 void StateController::publishVelocity(void)
 {
+  ScopedTimer timer(profiler_.get(), PUBLISH_VELOCITY_TIMING);
   geometry_msgs::Twist msg;
-  msg.linear.x = walker_->getDesiredLinearVelocity()[0];
-  msg.linear.y = walker_->getDesiredLinearVelocity()[1];
-  msg.linear.z = 0.0;
-  msg.angular.x = 0.0;
-  msg.angular.y = 0.0;
-  msg.angular.z = walker_->getDesiredAngularVelocity();
+  generateVelocityMsg(&msg);
   velocity_publisher_.publish(msg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void StateController::generateVelocityMsg(geometry_msgs::Twist* msg)
+{
+  msg->linear.x = walker_->getDesiredLinearVelocity()[0];
+  msg->linear.y = walker_->getDesiredLinearVelocity()[1];
+  msg->linear.z = 0.0;
+  msg->angular.x = 0.0;
+  msg->angular.y = 0.0;
+  msg->angular.z = walker_->getDesiredAngularVelocity();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void StateController::publishPose(void)
 {
+  ScopedTimer timer(profiler_.get(), PUBLISH_POSE_TIMING);
   geometry_msgs::Twist msg;
+  generatePoseMsg(&msg);
+  pose_publisher_.publish(msg);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::generatePoseMsg(geometry_msgs::Twist* msg)
+{
   Eigen::Vector3d position = model_->getCurrentPose().position_;
   Eigen::Quaterniond rotation = model_->getCurrentPose().rotation_;
-  msg.linear.x = position[0];
-  msg.linear.y = position[1];
-  msg.linear.z = position[2];
-  msg.angular.x = quaternionToEulerAngles(rotation)[0];
-  msg.angular.y = quaternionToEulerAngles(rotation)[1];
-  msg.angular.z = quaternionToEulerAngles(rotation)[2];
-  pose_publisher_.publish(msg);
+  Eigen::Vector3d euler_angles = quaternionToEulerAngles(rotation);
+  msg->linear.x = position[0];
+  msg->linear.y = position[1];
+  msg->linear.z = position[2];
+  msg->angular.x = euler_angles[0];
+  msg->angular.y = euler_angles[1];
+  msg->angular.z = euler_angles[2];
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void StateController::publishWalkspace(void)
+{
+  ScopedTimer timer(profiler_.get(), PUBLISH_WALKSPACE_TIMING);
+  std_msgs::Float32MultiArray msg;
+  if (generateWalkspaceMsg(&msg))
+  {
+    walkspace_publisher_.publish(msg);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool StateController::generateWalkspaceMsg(std_msgs::Float32MultiArray* msg)
 {
   if (robot_state_ == RUNNING)
   {
-    std_msgs::Float32MultiArray msg;
+    msg->data.clear();
     LimitMap walkspace_map = walker_->getWalkspace();
     LimitMap::iterator walkspace_it;
     for (walkspace_it = walkspace_map.begin(); walkspace_it != walkspace_map.end(); ++walkspace_it)
     {
-      msg.data.push_back(static_cast<float>(walkspace_it->second));
+      msg->data.push_back(static_cast<float>(walkspace_it->second));
     }
-    
-    walkspace_publisher_.publish(msg);
+    return true;
   }
+  return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void StateController::publishRotationPoseError(void)
 {
+  ScopedTimer timer(profiler_.get(), PUBLISH_ROTATION_POSE_ERROR_TIMING);
   std_msgs::Float32MultiArray msg;
-  msg.data.clear();
-  msg.data.push_back(static_cast<float>(poser_->getRotationAbsementError()[0]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationAbsementError()[1]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationAbsementError()[2]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationPositionError()[0]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationPositionError()[1]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationPositionError()[2]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationVelocityError()[0]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationVelocityError()[1]));
-  msg.data.push_back(static_cast<float>(poser_->getRotationVelocityError()[2]));
+  generateRotationPoseErrorMsg(&msg);
   rotation_pose_error_publisher_.publish(msg);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void StateController::generateRotationPoseErrorMsg(std_msgs::Float32MultiArray* msg)
+{
+  msg->data.clear();
+  msg->data.push_back(static_cast<float>(poser_->getRotationAbsementError()[0]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationAbsementError()[1]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationAbsementError()[2]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationPositionError()[0]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationPositionError()[1]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationPositionError()[2]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationVelocityError()[0]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationVelocityError()[1]));
+  msg->data.push_back(static_cast<float>(poser_->getRotationVelocityError()[2]));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void StateController::publishFrameTransforms(void)
 {
+  ScopedTimer timer(profiler_.get(), PUBLISH_FRAME_TRANSFORMS_TIMING);
+  generateFrameTransforms(&frame_transforms_);
+  transform_broadcaster_.sendTransform(frame_transforms_);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::generateFrameTransforms(std::vector<geometry_msgs::TransformStamped>* transforms)
+{
+  transforms->clear();
+  ros::Time stamp = ros::Time::now();
   Pose odom_ideal_to_walk_plane = walker_->getOdometryIdeal();
   Pose walk_plane_to_base_link = model_->getCurrentPose();
   Pose odom_ideal_to_base_link = odom_ideal_to_walk_plane.addPose(walk_plane_to_base_link);
-  
+
+  // Check if odom tf from perception exists on tf tree (periodically rather than every cycle)
+  if (!odom_checked_ || (stamp - odom_check_time_).toSec() >= params_.odom_check_period.data)
+  {
+    odom_available_ = transform_buffer_.canTransform("base_link", "odom", ros::Time(0));
+    odom_check_time_ = stamp;
+    odom_checked_ = true;
+  }
+
   // Broadcast ideal odom tf, if odom tf from perception does not exist on tf tree
-  try
+  if (odom_available_)
   {
     fixed_frame_id_ = "odom";
-    transform_buffer_.lookupTransform("base_link", "odom", ros::Time(0));
   }
-  catch (tf2::TransformException &ex) 
+  else
   {
     ROS_WARN_ONCE("\n[SHC] No odom transform exists in tf tree - using ideal odometry\n");
     
     fixed_frame_id_ = "odom_ideal";
     geometry_msgs::TransformStamped odom_to_base_link;
-    odom_to_base_link.header.stamp = ros::Time::now();
+    odom_to_base_link.header.stamp = stamp;
     odom_to_base_link.header.frame_id = "odom_ideal";
     odom_to_base_link.child_frame_id = "base_link";
     odom_to_base_link.transform.translation.x = odom_ideal_to_base_link.position_[0];
@@ -988,24 +1246,26 @@ void StateController::publishFrameTransforms(void)
     odom_to_base_link.transform.rotation.x = odom_ideal_to_base_link.rotation_.x();
     odom_to_base_link.transform.rotation.y = odom_ideal_to_base_link.rotation_.y();
     odom_to_base_link.transform.rotation.z = odom_ideal_to_base_link.rotation_.z();
-    transform_broadcaster_.sendTransform(odom_to_base_link);
+    transforms->push_back(odom_to_base_link);
   }
   
   // Base Link frame to Walk Plane frame transform
+  Pose base_link_to_walk_plane_pose = ~walk_plane_to_base_link;
   geometry_msgs::TransformStamped base_link_to_walk_plane;
-  base_link_to_walk_plane.header.stamp = ros::Time::now();
+  base_link_to_walk_plane.header.stamp = stamp;
   base_link_to_walk_plane.header.frame_id = "base_link";
   base_link_to_walk_plane.child_frame_id = "walk_plane";
-  base_link_to_walk_plane.transform.translation.x = (~walk_plane_to_base_link).position_[0];
-  base_link_to_walk_plane.transform.translation.y = (~walk_plane_to_base_link).position_[1];
-  base_link_to_walk_plane.transform.translation.z = (~walk_plane_to_base_link).position_[2];
-  base_link_to_walk_plane.transform.rotation.w = (~walk_plane_to_base_link).rotation_.w();
-  base_link_to_walk_plane.transform.rotation.x = (~walk_plane_to_base_link).rotation_.x();
-  base_link_to_walk_plane.transform.rotation.y = (~walk_plane_to_base_link).rotation_.y();
-  base_link_to_walk_plane.transform.rotation.z = (~walk_plane_to_base_link).rotation_.z();
-  transform_broadcaster_.sendTransform(base_link_to_walk_plane);
+  base_link_to_walk_plane.transform.translation.x = base_link_to_walk_plane_pose.position_[0];
+  base_link_to_walk_plane.transform.translation.y = base_link_to_walk_plane_pose.position_[1];
+  base_link_to_walk_plane.transform.translation.z = base_link_to_walk_plane_pose.position_[2];
+  base_link_to_walk_plane.transform.rotation.w = base_link_to_walk_plane_pose.rotation_.w();
+  base_link_to_walk_plane.transform.rotation.x = base_link_to_walk_plane_pose.rotation_.x();
+  base_link_to_walk_plane.transform.rotation.y = base_link_to_walk_plane_pose.rotation_.y();
+  base_link_to_walk_plane.transform.rotation.z = base_link_to_walk_plane_pose.rotation_.z();
+  transforms->push_back(base_link_to_walk_plane);
   
   // Base Link frame to Joint/Tip frames
+  int frame_index = 0;
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
   {
     std::shared_ptr<Leg> leg = leg_it_->second;
@@ -1014,7 +1274,7 @@ void StateController::publishFrameTransforms(void)
       std::shared_ptr<Joint> joint = joint_it_->second;
       Pose joint_robot_frame = joint->getPoseRobotFrame();
       geometry_msgs::TransformStamped base_link_to_joint;
-      base_link_to_joint.header.stamp = ros::Time::now();
+      base_link_to_joint.header.stamp = stamp;
       base_link_to_joint.header.frame_id = "base_link";
       base_link_to_joint.child_frame_id = joint->id_name_;
       base_link_to_joint.transform.translation.x = joint_robot_frame.position_[0];
@@ -1026,13 +1286,16 @@ void StateController::publishFrameTransforms(void)
       base_link_to_joint.transform.rotation.x = rotation.x();
       base_link_to_joint.transform.rotation.y = rotation.y();
       base_link_to_joint.transform.rotation.z = rotation.z();
-      transform_broadcaster_.sendTransform(base_link_to_joint);
+      if (isFrameTransformDue(base_link_to_joint, frame_index++))
+      {
+        transforms->push_back(base_link_to_joint);
+      }
     }
 
     geometry_msgs::TransformStamped base_link_to_tip;
     std::shared_ptr<Tip> tip = leg->getTip();
     Pose tip_robot_frame = tip->getPoseRobotFrame();
-    base_link_to_tip.header.stamp = ros::Time::now();
+    base_link_to_tip.header.stamp = stamp;
     base_link_to_tip.header.frame_id = "base_link";
     base_link_to_tip.child_frame_id = tip->id_name_;
     base_link_to_tip.transform.translation.x = tip_robot_frame.position_[0];
@@ -1042,37 +1305,307 @@ void StateController::publishFrameTransforms(void)
     base_link_to_tip.transform.rotation.x = tip_robot_frame.rotation_.x();
     base_link_to_tip.transform.rotation.y = tip_robot_frame.rotation_.y();
     base_link_to_tip.transform.rotation.z = tip_robot_frame.rotation_.z();
-    transform_broadcaster_.sendTransform(base_link_to_tip);
+    if (isFrameTransformDue(base_link_to_tip, frame_index++))
+    {
+      transforms->push_back(base_link_to_tip);
+    }
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void StateController::RVIZDebugging(void)
+bool StateController::isFrameTransformDue(const geometry_msgs::TransformStamped &transform, const int &frame_index)
+{
+  if (params_.frame_transform_refresh_period.data <= 0.0)
+  {
+    return true;
+  }
+
+  geometry_msgs::TransformStamped &published = published_frame_transforms_[frame_index];
+  const geometry_msgs::Transform &current = transform.transform;
+  const geometry_msgs::Transform &previous = published.transform;
+  bool changed =
+      abs(current.translation.x - previous.translation.x) > FRAME_TRANSFORM_TOLERANCE ||
+      abs(current.translation.y - previous.translation.y) > FRAME_TRANSFORM_TOLERANCE ||
+      abs(current.translation.z - previous.translation.z) > FRAME_TRANSFORM_TOLERANCE ||
+      abs(current.rotation.w - previous.rotation.w) > FRAME_TRANSFORM_TOLERANCE ||
+      abs(current.rotation.x - previous.rotation.x) > FRAME_TRANSFORM_TOLERANCE ||
+      abs(current.rotation.y - previous.rotation.y) > FRAME_TRANSFORM_TOLERANCE ||
+      abs(current.rotation.z - previous.rotation.z) > FRAME_TRANSFORM_TOLERANCE;
+  bool refresh_due = published.header.stamp == ros::Time(0) ||
+                     (transform.header.stamp - published.header.stamp).toSec() >=
+                     params_.frame_transform_refresh_period.data;
+  if (changed || refresh_due)
+  {
+    published = transform;
+    return true;
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::updateTelemetry(void)
+{
+  ScopedTimer timer(profiler_.get(), UPDATE_TELEMETRY_TIMING);
+  TelemetrySnapshot &snapshot = telemetry_buffer_->getBack();
+  bool snapshot_due = false;
+  for (int i = 0; i < TELEMETRY_TOPIC_COUNT; ++i)
+  {
+    snapshot.due_[i] = (telemetry_cycle_ % telemetry_rate_divisors_[i] == 0);
+    snapshot_due = snapshot_due || snapshot.due_[i];
+  }
+  telemetry_cycle_++;
+
+  if (!snapshot_due)
+  {
+    return;
+  }
+
+  if (snapshot.due_[LEG_STATE_TELEMETRY])
+  {
+    generateLegStateMsgs(&snapshot.leg_states_);
+  }
+  if (snapshot.due_[VELOCITY_TELEMETRY])
+  {
+    generateVelocityMsg(&snapshot.velocity_);
+  }
+  if (snapshot.due_[POSE_TELEMETRY])
+  {
+    generatePoseMsg(&snapshot.pose_);
+  }
+  if (snapshot.due_[WALKSPACE_TELEMETRY])
+  {
+    snapshot.due_[WALKSPACE_TELEMETRY] = generateWalkspaceMsg(&snapshot.walkspace_);
+  }
+  if (snapshot.due_[ROTATION_POSE_ERROR_TELEMETRY])
+  {
+    generateRotationPoseErrorMsg(&snapshot.rotation_pose_error_);
+  }
+  if (snapshot.due_[FRAME_TRANSFORMS_TELEMETRY])
+  {
+    generateFrameTransforms(&snapshot.frame_transforms_);
+  }
+
+  // Frames filtered as published within a snapshot the telemetry thread never acquired must be resent
+  if (telemetry_buffer_->commit())
+  {
+    const TelemetrySnapshot &dropped = telemetry_buffer_->getBack();
+    if (dropped.due_[FRAME_TRANSFORMS_TELEMETRY])
+    {
+      invalidateFrameTransforms(dropped.frame_transforms_);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::invalidateFrameTransforms(const std::vector<geometry_msgs::TransformStamped> &transforms)
+{
+  for (const geometry_msgs::TransformStamped &transform : transforms)
+  {
+    for (geometry_msgs::TransformStamped &published : published_frame_transforms_)
+    {
+      if (published.child_frame_id == transform.child_frame_id)
+      {
+        published.header.stamp = ros::Time(0);
+        break;
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::runTelemetry(void)
 {
-  debug_visualiser_.generateRobotModel(model_);
-  debug_visualiser_.generateGravity(poser_->estimateGravity());
-  debug_visualiser_.generateWalkPlane(walker_->getWalkPlane(), walker_->getWalkPlaneNormal());
-  debug_visualiser_.generateTerrainEstimate(model_);
+  // Poll at twice control rate to avoid skipping snapshots committed each control cycle
+  ros::Rate r(roundToInt(2.0 / params_.time_delta.data));
+  while (telemetry_running_ && ros::ok())
+  {
+    if (telemetry_buffer_->update())
+    {
+      const TelemetrySnapshot &snapshot = telemetry_buffer_->getFront();
+      if (snapshot.due_[LEG_STATE_TELEMETRY])
+      {
+        LegContainer::iterator leg_it;
+        for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it)
+        {
+          std::shared_ptr<Leg> leg = leg_it->second;
+          leg->publishState(snapshot.leg_states_[leg->getIDNumber()]);
+        }
+      }
+      if (snapshot.due_[VELOCITY_TELEMETRY])
+      {
+        velocity_publisher_.publish(snapshot.velocity_);
+      }
+      if (snapshot.due_[POSE_TELEMETRY])
+      {
+        pose_publisher_.publish(snapshot.pose_);
+      }
+      if (snapshot.due_[WALKSPACE_TELEMETRY])
+      {
+        walkspace_publisher_.publish(snapshot.walkspace_);
+      }
+      if (snapshot.due_[ROTATION_POSE_ERROR_TELEMETRY])
+      {
+        rotation_pose_error_publisher_.publish(snapshot.rotation_pose_error_);
+      }
+      if (snapshot.due_[FRAME_TRANSFORMS_TELEMETRY])
+      {
+        transform_broadcaster_.sendTransform(snapshot.frame_transforms_);
+      }
+    }
+    r.sleep();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::publishTiming(void)
+{
+  if (params_.timing_profiler.data && timing_publish_divisor_ > 0 && timing_cycle_++ % timing_publish_divisor_ == 0)
+  {
+    profiler_->generateTimingMsg(&timing_msg_);
+    timing_publisher_.publish(timing_msg_);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void StateController::recordFlightState(void)
+{
+  FlightRecord &record = flight_recorder_->getNextRecord();
+  record.cycle_ = flight_record_cycle_++;
+  record.time_ = ros::Time::now().toSec();
+  record.robot_state_ = robot_state_;
+  record.walk_state_ = walker_->getWalkState();
+
+  // Body pose and each component pose of the pose controller
+  recordPose(model_->getCurrentPose(), &record.poses_[CURRENT_POSE_RECORD]);
+  recordPose(poser_->getManualPose(), &record.poses_[MANUAL_POSE_RECORD]);
+  recordPose(poser_->getAutoPose(), &record.poses_[AUTO_POSE_RECORD]);
+  recordPose(poser_->getIMUPose(), &record.poses_[IMU_POSE_RECORD]);
+  recordPose(poser_->getInclinationPose(), &record.poses_[INCLINATION_POSE_RECORD]);
+  recordPose(poser_->getAdmittancePose(), &record.poses_[ADMITTANCE_POSE_RECORD]);
+  recordPose(poser_->getWalkPlanePose(), &record.poses_[WALK_PLANE_POSE_RECORD]);
+  recordPose(poser_->getTipAlignPose(), &record.poses_[TIP_ALIGN_POSE_RECORD]);
+
+  // State of each leg
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
   {
     std::shared_ptr<Leg> leg = leg_it_->second;
-    debug_visualiser_.generateTipTrajectory(leg);
-    debug_visualiser_.generateJointTorques(leg);
+    if (leg->getIDNumber() >= FLIGHT_RECORDER_MAX_LEGS)
+    {
+      continue;
+    }
+    LegRecord &leg_record = record.legs_[leg->getIDNumber()];
+    int joint_index = 0;
+    for (joint_it_ = leg->getJointContainer()->begin();
+         joint_it_ != leg->getJointContainer()->end() && joint_index < MAX_LEG_JOINTS; ++joint_it_, ++joint_index)
+    {
+      std::shared_ptr<Joint> joint = joint_it_->second;
+      leg_record.desired_joint_positions_[joint_index] = joint->desired_position_;
+      leg_record.current_joint_positions_[joint_index] = joint->current_position_;
+    }
+    recordPose(leg->getDesiredTipPose(), &leg_record.desired_tip_pose_);
+    recordPose(leg->getCurrentTipPose(), &leg_record.current_tip_pose_);
+    Eigen::Vector3d admittance_delta = leg->getAdmittanceDelta();
+    leg_record.admittance_delta_[0] = admittance_delta[0];
+    leg_record.admittance_delta_[1] = admittance_delta[1];
+    leg_record.admittance_delta_[2] = admittance_delta[2];
+    std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+    leg_record.phase_ = leg_stepper->getPhase();
+    leg_record.step_state_ = leg_stepper->getStepState();
+    leg_record.leg_state_ = leg->getLegState();
+  }
+  flight_recorder_->commitRecord();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::simulateJointStates(void)
+{
+  std::shared_ptr<JointStateStore> store = model_->getJointStateStore();
+  std::copy(store->desired_positions_.begin(), store->desired_positions_.end(), store->current_positions_.begin());
+  std::copy(store->desired_velocities_.begin(), store->desired_velocities_.end(), store->current_velocities_.begin());
+  std::copy(store->desired_efforts_.begin(), store->desired_efforts_.end(), store->current_efforts_.begin());
+  joint_positions_initialised_ = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::RVIZDebugging(void)
+{
+  ScopedTimer timer(profiler_.get(), RVIZ_DEBUGGING_TIMING);
+  debug_visualiser_.advanceCycle(model_);
+  if (debug_visualiser_.isLayerDue(ROBOT_MODEL_LAYER))
+  {
+    debug_visualiser_.generateRobotModel(model_);
+  }
+  if (debug_visualiser_.isLayerDue(GRAVITY_LAYER))
+  {
+    debug_visualiser_.generateGravity(poser_->estimateGravity());
+  }
+  if (debug_visualiser_.isLayerDue(WALK_PLANE_LAYER))
+  {
+    debug_visualiser_.generateWalkPlane(walker_->getWalkPlane(), walker_->getWalkPlaneNormal());
+  }
+  if (debug_visualiser_.isLayerDue(TERRAIN_LAYER))
+  {
+    debug_visualiser_.generateTerrainEstimate(model_);
+  }
 
-    if (robot_state_ == RUNNING)
+  // Determine due layers once per cycle rather than per leg
+  bool running = (robot_state_ == RUNNING);
+  bool tip_trajectory_due = debug_visualiser_.isLayerDue(TIP_TRAJECTORY_LAYER);
+  bool joint_torque_due = debug_visualiser_.isLayerDue(JOINT_TORQUE_LAYER);
+  bool default_tip_position_due = running && debug_visualiser_.isLayerDue(DEFAULT_TIP_POSITION_LAYER);
+  bool target_tip_position_due = running && debug_visualiser_.isLayerDue(TARGET_TIP_POSITION_LAYER);
+  bool workspace_due = running && debug_visualiser_.isLayerDue(WORKSPACE_LAYER);
+  bool walkspace_due = running && debug_visualiser_.isLayerDue(WALKSPACE_LAYER);
+  bool bezier_curve_due = running && debug_visualiser_.isLayerDue(BEZIER_CURVE_LAYER);
+  bool stride_due = running && debug_visualiser_.isLayerDue(STRIDE_LAYER);
+  bool tip_force_due = running && params_.admittance_control.data && debug_visualiser_.isLayerDue(TIP_FORCE_LAYER);
+
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  {
+    std::shared_ptr<Leg> leg = leg_it_->second;
+    if (tip_trajectory_due)
+    {
+      debug_visualiser_.generateTipTrajectory(leg);
+    }
+    if (joint_torque_due)
+    {
+      debug_visualiser_.generateJointTorques(leg);
+    }
+    if (default_tip_position_due)
     {
       debug_visualiser_.generateDefaultTipPositions(leg);
+    }
+    if (target_tip_position_due)
+    {
       debug_visualiser_.generateTargetTipPositions(leg);
+    }
+    if (workspace_due)
+    {
       debug_visualiser_.generateWorkspace(leg, walker_->getBodyClearance());
+    }
+    if (walkspace_due)
+    {
       debug_visualiser_.generateWalkspace(leg, walker_->getWalkspace());
+    }
+    if (bezier_curve_due)
+    {
       debug_visualiser_.generateBezierCurves(leg);
+    }
+    if (stride_due)
+    {
       debug_visualiser_.generateStride(leg);
-      if (params_.admittance_control.data)
-      {
-        debug_visualiser_.generateTipForce(leg);
-      }
+    }
+    if (tip_force_due)
+    {
+      debug_visualiser_.generateTipForce(leg);
     }
   }
 }
@@ -1094,6 +1627,16 @@ void StateController::systemStateCallback(const std_msgs::Int8 &input)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void StateController::flightRecorderFlushCallback(const std_msgs::Bool &input)
+{
+  if (input.data && flight_recorder_ != NULL)
+  {
+    flight_recorder_->requestFlush();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void StateController::robotStateCallback(const std_msgs::Int8 &input)
 {
   RobotState input_state = static_cast<RobotState>(int(input.data));
@@ -1564,49 +2107,205 @@ void StateController::imuCallback(const sensor_msgs::Imu &data)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void StateController::updateJointStateLayout(const std::vector<std::string> &names)
+{
+  // Regenerate mapping of message joint order to joint state store slots only if message layout has changed
+  if (names == joint_state_layout_names_)
+  {
+    return;
+  }
+  joint_state_layout_names_ = names;
+  joint_state_layout_.clear();
+  for (uint i = 0; i < names.size(); ++i)
+  {
+    int slot = model_->getJointStateIndex(names[i]);
+    if (slot == -1)
+    {
+      ROS_WARN_THROTTLE(THROTTLE_PERIOD, "\n[SHC] Ignoring joint state of unknown joint '%s'.\n", names[i].c_str());
+      continue;
+    }
+    joint_state_layout_.push_back(std::make_pair(i, slot));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::updateTipStateLayout(const std::vector<std::string> &names)
+{
+  // Regenerate mapping of message tip order to legs only if message layout has changed
+  if (names == tip_state_layout_names_)
+  {
+    return;
+  }
+  tip_state_layout_names_ = names;
+  tip_state_layout_.clear();
+  for (uint i = 0; i < names.size(); ++i)
+  {
+    std::shared_ptr<Leg> leg = model_->getLegByIDName(names[i].substr(0, names[i].find("_")));
+    if (leg == NULL)
+    {
+      ROS_WARN_THROTTLE(THROTTLE_PERIOD, "\n[SHC] Ignoring tip state of unknown tip '%s'.\n", names[i].c_str());
+      continue;
+    }
+    tip_state_layout_.push_back(std::make_pair(i, leg));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void StateController::jointStatesCallback(const sensor_msgs::JointState &joint_states)
 {
   bool get_effort_values = (joint_states.effort.size() != 0);
   bool get_velocity_values = (joint_states.velocity.size() != 0);
 
-  // Iterate through message and assign found state values to joint objects
-  for (uint i = 0; i < joint_states.name.size(); ++i)
+  updateJointStateLayout(joint_states.name);
+
+  // Iterate through message and assign found state values to joint state store
+  std::shared_ptr<JointStateStore> store = model_->getJointStateStore();
+  for (uint j = 0; j < joint_state_layout_.size(); ++j)
   {
-    std::string joint_name = joint_states.name[i];
-    std::string leg_name = joint_name.substr(0, joint_name.find("_"));
-    std::shared_ptr<Leg> leg = model_->getLegByIDName(leg_name);
-    ROS_ASSERT(leg != NULL);
-    std::shared_ptr<Joint> joint = leg->getJointByIDName(joint_name);
-    ROS_ASSERT(joint != NULL);
-    joint->current_position_ = joint_states.position[i] - joint->offset_;
+    int i = joint_state_layout_[j].first;
+    int slot = joint_state_layout_[j].second;
+    store->current_positions_[slot] = joint_states.position[i] - store->offsets_[slot];
     if (get_velocity_values)
     {
-      joint->current_velocity_ = joint_states.velocity[i];
+      store->current_velocities_[slot] = joint_states.velocity[i];
     }
     if (get_effort_values)
     {
-      joint->current_effort_ = joint_states.effort[i];
-      joint->desired_effort_ = joint->current_effort_; // HACK
+      store->current_efforts_[slot] = joint_states.effort[i];
+      store->desired_efforts_[slot] = store->current_efforts_[slot]; // HACK
     }
   }
 
   // Check if all joint positions have been received from topic
   if (!joint_positions_initialised_)
   {
-    joint_positions_initialised_ = true;
-    for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+    joint_positions_initialised_ =
+        std::find(store->current_positions_.begin(), store->current_positions_.end(), UNASSIGNED_VALUE) ==
+        store->current_positions_.end();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::stageJointStatesCallback(const sensor_msgs::JointState &joint_states)
+{
+  bool get_effort_values = (joint_states.effort.size() != 0);
+  bool get_velocity_values = (joint_states.velocity.size() != 0);
+
+  updateJointStateLayout(joint_states.name);
+
+  // Merge message values into accumulated inputs so joints published on separate messages are all retained
+  std::shared_ptr<JointStateStore> store = model_->getJointStateStore();
+  for (uint j = 0; j < joint_state_layout_.size(); ++j)
+  {
+    int i = joint_state_layout_[j].first;
+    int slot = joint_state_layout_[j].second;
+    input_accumulator_.joint_positions_[slot] = joint_states.position[i] - store->offsets_[slot];
+    input_accumulator_.joint_position_received_[slot] = true;
+    if (get_velocity_values)
     {
-      std::shared_ptr<Leg> leg = leg_it_->second;
-      JointContainer::iterator joint_it;
-      for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+      input_accumulator_.joint_velocities_[slot] = joint_states.velocity[i];
+      input_accumulator_.joint_velocity_received_[slot] = true;
+    }
+    if (get_effort_values)
+    {
+      input_accumulator_.joint_efforts_[slot] = joint_states.effort[i];
+      input_accumulator_.joint_effort_received_[slot] = true;
+    }
+  }
+  input_accumulator_.joint_states_count_++;
+  staged_inputs_->getBack() = input_accumulator_;
+  staged_inputs_->commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::stageImuCallback(const sensor_msgs::Imu &data)
+{
+  input_accumulator_.imu_ = data;
+  input_accumulator_.imu_count_++;
+  staged_inputs_->getBack() = input_accumulator_;
+  staged_inputs_->commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::stageTipStatesCallback(const syropod_highlevel_controller::TipState &tip_states)
+{
+  input_accumulator_.tip_states_ = tip_states;
+  input_accumulator_.tip_states_count_++;
+  staged_inputs_->getBack() = input_accumulator_;
+  staged_inputs_->commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::stageBodyVelocityInputCallback(const geometry_msgs::Twist &input)
+{
+  input_accumulator_.velocity_ = input;
+  input_accumulator_.velocity_count_++;
+  staged_inputs_->getBack() = input_accumulator_;
+  staged_inputs_->commit();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void StateController::applyStagedInputs(void)
+{
+  if (staged_inputs_ == NULL || !staged_inputs_->update())
+  {
+    return;
+  }
+  const StagedInputs &inputs = staged_inputs_->getFront();
+
+  // Apply joint states to joint state store
+  if (inputs.joint_states_count_ != applied_input_counts_.joint_states_count_)
+  {
+    std::shared_ptr<JointStateStore> store = model_->getJointStateStore();
+    for (uint slot = 0; slot < inputs.joint_positions_.size(); ++slot)
+    {
+      if (inputs.joint_position_received_[slot])
       {
-        std::shared_ptr<Joint> joint = joint_it->second;
-        if (joint->current_position_ == UNASSIGNED_VALUE)
-        {
-          joint_positions_initialised_ = false;
-        }
+        store->current_positions_[slot] = inputs.joint_positions_[slot];
+      }
+      if (inputs.joint_velocity_received_[slot])
+      {
+        store->current_velocities_[slot] = inputs.joint_velocities_[slot];
+      }
+      if (inputs.joint_effort_received_[slot])
+      {
+        store->current_efforts_[slot] = inputs.joint_efforts_[slot];
+        store->desired_efforts_[slot] = store->current_efforts_[slot]; // HACK
       }
     }
+
+    // Check if all joint positions have been received from topic
+    if (!joint_positions_initialised_)
+    {
+      joint_positions_initialised_ =
+          std::find(store->current_positions_.begin(), store->current_positions_.end(), UNASSIGNED_VALUE) ==
+          store->current_positions_.end();
+    }
+    applied_input_counts_.joint_states_count_ = inputs.joint_states_count_;
+  }
+
+  // Apply remaining inputs through standard callbacks on control thread
+  if (inputs.imu_count_ != applied_input_counts_.imu_count_)
+  {
+    imuCallback(inputs.imu_);
+    applied_input_counts_.imu_count_ = inputs.imu_count_;
+  }
+  if (inputs.tip_states_count_ != applied_input_counts_.tip_states_count_)
+  {
+    tipStatesCallback(inputs.tip_states_);
+    applied_input_counts_.tip_states_count_ = inputs.tip_states_count_;
+  }
+  if (inputs.velocity_count_ != applied_input_counts_.velocity_count_)
+  {
+    bodyVelocityInputCallback(inputs.velocity_);
+    applied_input_counts_.velocity_count_ = inputs.velocity_count_;
   }
 }
 
@@ -1617,14 +2316,14 @@ void StateController::tipStatesCallback(const syropod_highlevel_controller::TipS
   bool get_wrench_values = tip_states.wrench.size() > 0;
   bool get_step_plane_values = tip_states.step_plane.size() > 0;
   
+  updateTipStateLayout(tip_states.name);
+
   // Iterate through message and assign found contact proximity value to leg objects
   std::string error_string;
-  for (uint i = 0; i < tip_states.name.size(); ++i)
+  for (uint j = 0; j < tip_state_layout_.size(); ++j)
   {
-    std::string tip_name = tip_states.name[i];
-    std::string leg_name = tip_name.substr(0, tip_name.find("_"));
-    std::shared_ptr<Leg> leg = model_->getLegByIDName(leg_name);
-    ROS_ASSERT(leg != NULL);
+    int i = tip_state_layout_[j].first;
+    std::shared_ptr<Leg> leg = tip_state_layout_[j].second;
     std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
     if (get_wrench_values)
     {
@@ -1663,7 +2362,8 @@ void StateController::tipStatesCallback(const syropod_highlevel_controller::TipS
       else
       {
         leg->setStepPlanePose(Pose::Undefined()); 
-        error_string += stringFormat("\nLost contact with tip range sensor/s of leg %s.\n", leg_name.c_str());
+        error_string += stringFormat("\nLost contact with tip range sensor/s of leg %s.\n",
+                                     leg->getIDName().c_str());
       }
     }
   }
@@ -1777,6 +2477,18 @@ void StateController::initParameters(void)
   // Hardware interface parameters
   params_.individual_control_interface.init("individual_control_interface");
   params_.combined_control_interface.init("combined_control_interface");
+  params_.threaded_telemetry.init("threaded_telemetry");
+  params_.threaded_callbacks.init("threaded_callbacks");
+  params_.odom_check_period.init("odom_check_period");
+  params_.frame_transform_refresh_period.init("frame_transform_refresh_period");
+  params_.timing_profiler.init("timing_profiler");
+  params_.timing_publish_rate.init("timing_publish_rate");
+  params_.flight_recorder.init("flight_recorder");
+  params_.flight_recorder_length.init("flight_recorder_length");
+  params_.real_time_mode.init("real_time_mode");
+  params_.real_time_core.init("real_time_core");
+  params_.real_time_priority.init("real_time_priority");
+  params_.telemetry_rate_divisors.init("telemetry_rate_divisors");
 
   // Model parameters
   params_.syropod_type.init("syropod_type");
@@ -1787,6 +2499,13 @@ void StateController::initParameters(void)
   params_.clamp_joint_positions.init("clamp_joint_positions");
   params_.clamp_joint_velocities.init("clamp_joint_velocities");
   params_.ignore_IK_warnings.init("ignore_IK_warnings");
+  params_.IK_diagnostics_period.init("IK_diagnostics_period");
+  params_.analytic_IK.init("analytic_IK");
+  params_.parallel_workspace_generation.init("parallel_workspace_generation");
+  params_.parallel_leg_updates.init("parallel_leg_updates");
+  params_.leg_worker_threads.init("leg_worker_threads");
+  params_.workspace_generation_method.init("workspace_generation_method");
+  params_.use_workspace_cache.init("use_workspace_cache");
 
   // Walk controller parameters
   params_.gait_type.init("gait_type");
@@ -1806,12 +2525,14 @@ void StateController::initParameters(void)
   params_.force_normal_touchdown.init("force_normal_touchdown");
   params_.gravity_aligned_tips.init("gravity_aligned_tips");
   params_.liftoff_threshold.init("liftoff_threshold");
+  params_.odometry_prediction_horizons.init("odometry_prediction_horizons");
   params_.touchdown_threshold.init("touchdown_threshold");
 
   // Pose controller parameters
   params_.auto_pose_type.init("auto_pose_type");
   params_.start_up_sequence.init("start_up_sequence");
   params_.time_to_start.init("time_to_start");
+  params_.plan_transition_sequence.init("plan_transition_sequence");
   params_.rotation_pid_gains.init("rotation_pid_gains");
   params_.max_translation.init("max_translation");
   params_.max_translation_velocity.init("max_translation_velocity");
@@ -1832,6 +2553,10 @@ void StateController::initParameters(void)
 
   // Debug Parameters
   params_.debug_rviz.init("debug_rviz");
+  params_.debug_rviz_rate_divisors.init("debug_rviz_rate_divisors");
+  params_.headless_simulation.init("headless_simulation");
+  params_.simulation_duration.init("simulation_duration");
+  params_.simulation_velocity.init("simulation_velocity");
   params_.console_verbosity.init("console_verbosity");
   params_.debug_moveToJointPosition.init("debug_move_to_joint_position");
   params_.debug_stepToPosition.init("debug_step_to_position");
@@ -1887,7 +2612,10 @@ void StateController::initParameters(void)
   params_.adjustable_map.insert(AdjustableMapType::value_type(FORCE_GAIN, &params_.force_gain));
 
   // Dynamic reconfigure server and callback setup
-  dynamic_reconfigure_server_ = new dynamic_reconfigure::Server<syropod_highlevel_controller::DynamicConfig>(mutex_);
+  ros::NodeHandle reconfigure_n(private_namespace_);
+  reconfigure_n.setCallbackQueue(callback_queue_);
+  dynamic_reconfigure_server_ =
+    new dynamic_reconfigure::Server<syropod_highlevel_controller::DynamicConfig>(mutex_, reconfigure_n);
   dynamic_reconfigure::Server<syropod_highlevel_controller::DynamicConfig>::CallbackType callback_type;
   callback_type = boost::bind(&StateController::dynamicParameterCallback, this, _1, _2);
   dynamic_reconfigure_server_->setCallback(callback_type);
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/control_loop.h"
+
+#include <nodelet/nodelet.h>
+#include <pluginlib/class_list_macros.h>
+
+namespace syropod_highlevel_controller
+{
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Nodelet variant of the controller node, allowing the controller to be loaded into the same process as hardware
+/// driver nodelets. Desired joint states are published by shared pointer and joint/tip states published likewise by
+/// drivers are received without serialisation. The control loop runs on its own thread and services all controller
+/// subscriptions from its own callback queue, so callbacks are never executed concurrently by nodelet manager threads.
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+class StateControllerNodelet : public nodelet::Nodelet
+{
+public:
+  /// StateControllerNodelet object destructor. Stops the control loop and waits for the control thread to finish.
+  ~StateControllerNodelet(void)
+  {
+    running_ = false;
+    if (control_thread_.joinable())
+    {
+      control_thread_.join();
+    }
+  };
+
+private:
+  /// Nodelet initialisation. Starts the control thread, which creates and runs the state controller.
+  virtual void onInit(void)
+  {
+    control_thread_ = std::thread(&StateControllerNodelet::run, this);
+  };
+
+  /// Main function of the control thread. The state controller is created on the control thread so that all
+  /// controller state is owned by the thread running the control loop.
+  void run(void)
+  {
+    StateController state(&callback_queue_, getName());
+    state.setIntraProcess(true);
+    runControlLoop(state, running_);
+  };
+
+  ros::CallbackQueue callback_queue_;    ///< Callback queue servicing controller subscriptions on the control thread
+  std::thread control_thread_;           ///< Thread creating and running the state controller
+  std::atomic<bool> running_{ true };    ///< Flag denoting if the control loop should continue running
+};
+}
+
+PLUGINLIB_EXPORT_CLASS(syropod_highlevel_controller::StateControllerNodelet, nodelet::Nodelet)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
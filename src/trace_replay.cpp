@@ -0,0 +1,569 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/state_controller.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef TRACE_REPLAY_TEST
+#include <gtest/gtest.h>
+#endif
+
+#define DEFAULT_REPLAY_CYCLES 2500          ///< Default number of walking control cycles replayed for each gait
+#define DEFAULT_JOINT_TOLERANCE 1.0e-4      ///< Default max allowed desired joint position divergence (rad)
+#define DEFAULT_TIP_POSITION_TOLERANCE 1.0e-4 ///< Default max allowed tip position divergence (m)
+#define DEFAULT_TIP_ROTATION_TOLERANCE 1.0e-3 ///< Default max allowed tip rotation divergence (rad)
+#define STARTUP_CYCLE_LIMIT 100000          ///< Max control cycles allowed for direct start up of each gait
+#define VELOCITY_INPUT_PERIOD 1000          ///< Period of scripted velocity input sequence (control cycles)
+#define STANCE_TIP_FORCE 10.0               ///< Scripted measured tip force of stance legs driving admittance (N)
+#define TRACE_PRECISION 12                  ///< Significant digits of values written to reference traces
+
+/// Struct containing a per cycle trace of desired joint positions and tip poses from replaying a single gait.
+struct ReplayTrace
+{
+  std::string syropod_type_;               ///< The type of the robot which generated the trace
+  std::string gait_type_;                  ///< The gait replayed to generate the trace
+  bool started_ = false;                   ///< Flag denoting if the direct start up completed
+  double mean_cycle_time_ = 0.0;           ///< Mean wall time of each replayed control cycle (sec)
+  std::vector<std::string> columns_;       ///< Names of the values recorded each cycle
+  std::vector<std::vector<double>> rows_;  ///< Values recorded each cycle, ordered as columns
+};
+
+/// Struct containing the divergence of a replayed trace from its reference trace.
+struct ReplayComparison
+{
+  int cycles_ = 0;                         ///< Number of control cycles compared
+  int first_divergent_cycle_ = -1;         ///< First cycle exceeding any tolerance (-1 if none)
+  double max_joint_error_ = 0.0;           ///< Max desired joint position divergence (rad)
+  double max_tip_position_error_ = 0.0;    ///< Max tip position divergence (m)
+  double max_tip_rotation_error_ = 0.0;    ///< Max tip rotation divergence (rad)
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Replays a gait by building an isolated robot model, walk, pose and admittance controller, executing a direct start
+/// up and walking in lockstep simulation over a scripted velocity input sequence. Desired joint states are fed back as
+/// current joint states each cycle and stance legs measure a scripted tip force to drive admittance control. The
+/// desired joint positions and tip poses of every cycle are recorded to the trace.
+/// @param[in] params The parameter data structure of the replay, including engine options (must outlive replay)
+/// @param[in] cycles The number of walking control cycles to replay
+/// @param[out] trace Pointer to the trace object to populate
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void replayGait(const Parameters& params, const int& cycles, ReplayTrace* trace)
+{
+  trace->syropod_type_ = params.syropod_type.data;
+  trace->gait_type_ = params.gait_type.data;
+
+  std::shared_ptr<DebugVisualiser> debug_visualiser =
+      std::allocate_shared<DebugVisualiser>(Eigen::aligned_allocator<DebugVisualiser>());
+  std::shared_ptr<Model> model =
+      std::allocate_shared<Model>(Eigen::aligned_allocator<Model>(), params, debug_visualiser);
+  model->generate();
+  if (params.parallel_leg_updates.data)
+  {
+    int worker_count = params.leg_worker_threads.data;
+    if (worker_count <= 0)
+    {
+      int core_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+      worker_count = std::min(model->getLegCount(), core_count) - 1;
+    }
+    model->setWorkerPool(std::make_shared<WorkerPool>(worker_count));
+  }
+  model->initLegs(true);
+  std::shared_ptr<WalkController> walker =
+      std::allocate_shared<WalkController>(Eigen::aligned_allocator<WalkController>(), model, params);
+  walker->init();
+  std::shared_ptr<PoseController> poser =
+      std::allocate_shared<PoseController>(Eigen::aligned_allocator<PoseController>(), model, params);
+  poser->init();
+  std::shared_ptr<AdmittanceController> admittance =
+      std::allocate_shared<AdmittanceController>(Eigen::aligned_allocator<AdmittanceController>(), model, params);
+
+  // Direct start up to default stance
+  int startup_cycles = 0;
+  while (poser->directStartup() != PROGRESS_COMPLETE && startup_cycles < STARTUP_CYCLE_LIMIT)
+  {
+    startup_cycles++;
+  }
+  if (startup_cycles == STARTUP_CYCLE_LIMIT)
+  {
+    return;
+  }
+  trace->started_ = true;
+  model->updateDefaultConfiguration();
+  model->generateWorkspaces();
+  walker->generateWalkspace();
+
+  // Name trace columns
+  LegContainer::iterator leg_it;
+  JointContainer::iterator joint_it;
+  trace->columns_.clear();
+  for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+    {
+      trace->columns_.push_back(joint_it->second->id_name_);
+    }
+  }
+  for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+  {
+    std::string prefix = leg_it->second->getIDName() + "_tip_";
+    std::vector<std::string> suffixes = { "x", "y", "z", "qw", "qx", "qy", "qz" };
+    for (uint i = 0; i < suffixes.size(); ++i)
+    {
+      trace->columns_.push_back(prefix + suffixes[i]);
+    }
+  }
+
+  // Walk in lockstep simulation over scripted velocity input sequence, timing only controller updates
+  std::shared_ptr<JointStateStore> store = model->getJointStateStore();
+  std::chrono::duration<double> total_duration(0.0);
+  trace->rows_.clear();
+  trace->rows_.reserve(cycles);
+  for (int i = 0; i < cycles; ++i)
+  {
+    double phase = 2.0 * M_PI * i / VELOCITY_INPUT_PERIOD;
+    Eigen::Vector2d linear_velocity_input =
+        Eigen::Vector2d(sin(phase), 0.5 * sin(2.0 * phase)) * params.body_velocity_scaler.data;
+    double angular_velocity_input = 0.5 * cos(phase) * params.body_velocity_scaler.data;
+    for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+    {
+      std::shared_ptr<Leg> leg = leg_it->second;
+      bool stance = (leg->getLegStepper()->getStepState() == STANCE);
+      leg->setTipForceMeasured(Eigen::Vector3d(0.0, 0.0, stance ? STANCE_TIP_FORCE : 0.0));
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    poser->updateCurrentPose(RUNNING);
+    walker->setPoseState(poser->getAutoPoseState());
+    if (walker->getWalkState() != STOPPED && params.dynamic_stiffness.data)
+    {
+      admittance->updateStiffness(walker);
+    }
+    admittance->updateAdmittance();
+    walker->updateWalk(linear_velocity_input, angular_velocity_input);
+    poser->updateStance();
+    model->updateModel();
+    total_duration += std::chrono::steady_clock::now() - start;
+
+    std::vector<double> row;
+    row.reserve(trace->columns_.size());
+    for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+    {
+      std::shared_ptr<Leg> leg = leg_it->second;
+      for (joint_it = leg->getJointContainer()->begin(); joint_it != leg->getJointContainer()->end(); ++joint_it)
+      {
+        row.push_back(joint_it->second->desired_position_);
+      }
+    }
+    for (leg_it = model->getLegContainer()->begin(); leg_it != model->getLegContainer()->end(); ++leg_it)
+    {
+      Pose tip_pose = leg_it->second->getCurrentTipPose();
+      row.insert(row.end(), { tip_pose.position_[0], tip_pose.position_[1], tip_pose.position_[2],
+                              tip_pose.rotation_.w(), tip_pose.rotation_.x(),
+                              tip_pose.rotation_.y(), tip_pose.rotation_.z() });
+    }
+    trace->rows_.push_back(row);
+
+    std::copy(store->desired_positions_.begin(), store->desired_positions_.end(), store->current_positions_.begin());
+    std::copy(store->desired_velocities_.begin(), store->desired_velocities_.end(),
+              store->current_velocities_.begin());
+  }
+  trace->mean_cycle_time_ = cycles > 0 ? total_duration.count() / cycles : 0.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Generates the file path of the reference trace of a gait.
+/// @param[in] directory The directory holding reference traces
+/// @param[in] syropod_type The type of the robot
+/// @param[in] gait_type The replayed gait
+/// @return The file path of the reference trace
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::string getTracePath(const std::string& directory, const std::string& syropod_type, const std::string& gait_type)
+{
+  return directory + "/" + syropod_type + "_" + gait_type + "_trace.csv";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Writes a trace as a CSV table, preceded by a metadata line of the robot type, gait and mean cycle time.
+/// @param[in] file_path The file path of the trace
+/// @param[in] trace The trace to write
+/// @return Bool denoting if the trace was successfully written
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool writeTrace(const std::string& file_path, const ReplayTrace& trace)
+{
+  std::ofstream file(file_path.c_str());
+  if (!file.is_open())
+  {
+    return false;
+  }
+
+  file << std::setprecision(TRACE_PRECISION);
+  file << "# " << trace.syropod_type_ << "," << trace.gait_type_ << "," << trace.mean_cycle_time_ << "\n";
+  file << "cycle";
+  for (uint i = 0; i < trace.columns_.size(); ++i)
+  {
+    file << "," << trace.columns_[i];
+  }
+  file << "\n";
+  for (uint i = 0; i < trace.rows_.size(); ++i)
+  {
+    file << i;
+    for (uint j = 0; j < trace.rows_[i].size(); ++j)
+    {
+      file << "," << trace.rows_[i][j];
+    }
+    file << "\n";
+  }
+  return file.good();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Reads a trace written by writeTrace.
+/// @param[in] file_path The file path of the trace
+/// @param[out] trace Pointer to the trace object to populate
+/// @return Bool denoting if the trace was successfully read
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool readTrace(const std::string& file_path, ReplayTrace* trace)
+{
+  std::ifstream file(file_path.c_str());
+  std::string line;
+  if (!file.is_open() || !std::getline(file, line) || line.compare(0, 2, "# ") != 0)
+  {
+    return false;
+  }
+
+  // Parse metadata line
+  std::stringstream metadata(line.substr(2));
+  std::string mean_cycle_time;
+  std::getline(metadata, trace->syropod_type_, ',');
+  std::getline(metadata, trace->gait_type_, ',');
+  std::getline(metadata, mean_cycle_time, ',');
+  trace->mean_cycle_time_ = atof(mean_cycle_time.c_str());
+  trace->started_ = true;
+
+  // Parse column names (excluding cycle number)
+  if (!std::getline(file, line))
+  {
+    return false;
+  }
+  std::stringstream header(line);
+  std::string column;
+  std::getline(header, column, ',');
+  trace->columns_.clear();
+  while (std::getline(header, column, ','))
+  {
+    trace->columns_.push_back(column);
+  }
+
+  // Parse rows (excluding cycle number)
+  trace->rows_.clear();
+  while (std::getline(file, line))
+  {
+    std::stringstream row_data(line);
+    std::string value;
+    std::vector<double> row;
+    std::getline(row_data, value, ',');
+    while (std::getline(row_data, value, ','))
+    {
+      row.push_back(atof(value.c_str()));
+    }
+    if (row.size() != trace->columns_.size())
+    {
+      return false;
+    }
+    trace->rows_.push_back(row);
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Compares a replayed trace against its reference trace cycle by cycle. Joint columns are compared directly, tip
+/// positions by euclidean distance and tip rotations by angular distance.
+/// @param[in] reference The reference trace
+/// @param[in] replay The replayed trace
+/// @param[in] tolerances The max allowed [joint position, tip position, tip rotation] divergence
+/// @param[out] comparison Pointer to the comparison object to populate
+/// @return Bool denoting if trace layouts match, allowing comparison
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool compareTraces(const ReplayTrace& reference, const ReplayTrace& replay,
+                   const Eigen::Vector3d& tolerances, ReplayComparison* comparison)
+{
+  if (reference.columns_ != replay.columns_)
+  {
+    return false;
+  }
+
+  // Tip pose columns are the trailing 7 values (position and quaternion) of each leg
+  int tip_column_start = 0;
+  while (tip_column_start < int(reference.columns_.size()) &&
+         reference.columns_[tip_column_start].find("_tip_") == std::string::npos)
+  {
+    tip_column_start++;
+  }
+
+  int cycles = static_cast<int>(std::min(reference.rows_.size(), replay.rows_.size()));
+  for (int i = 0; i < cycles; ++i)
+  {
+    const std::vector<double>& expected = reference.rows_[i];
+    const std::vector<double>& actual = replay.rows_[i];
+    double joint_error = 0.0;
+    double tip_position_error = 0.0;
+    double tip_rotation_error = 0.0;
+    for (int j = 0; j < tip_column_start; ++j)
+    {
+      joint_error = std::max(joint_error, std::abs(actual[j] - expected[j]));
+    }
+    for (int j = tip_column_start; j + 7 <= int(expected.size()); j += 7)
+    {
+      Eigen::Vector3d expected_position(expected[j], expected[j + 1], expected[j + 2]);
+      Eigen::Vector3d actual_position(actual[j], actual[j + 1], actual[j + 2]);
+      Eigen::Quaterniond expected_rotation(expected[j + 3], expected[j + 4], expected[j + 5], expected[j + 6]);
+      Eigen::Quaterniond actual_rotation(actual[j + 3], actual[j + 4], actual[j + 5], actual[j + 6]);
+      tip_position_error = std::max(tip_position_error, (actual_position - expected_position).norm());
+      tip_rotation_error = std::max(tip_rotation_error,
+                                    actual_rotation.normalized().angularDistance(expected_rotation.normalized()));
+    }
+    comparison->max_joint_error_ = std::max(comparison->max_joint_error_, joint_error);
+    comparison->max_tip_position_error_ = std::max(comparison->max_tip_position_error_, tip_position_error);
+    comparison->max_tip_rotation_error_ = std::max(comparison->max_tip_rotation_error_, tip_rotation_error);
+    bool divergent = (joint_error > tolerances[0] || tip_position_error > tolerances[1] ||
+                      tip_rotation_error > tolerances[2]);
+    if (divergent && comparison->first_divergent_cycle_ == -1)
+    {
+      comparison->first_divergent_cycle_ = i;
+    }
+    comparison->cycles_++;
+  }
+  if (reference.rows_.size() != replay.rows_.size() && comparison->first_divergent_cycle_ == -1)
+  {
+    comparison->first_divergent_cycle_ = cycles;
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/// Runs the trace replay. Acquires base parameters from the parameter server (see launch/trace_replay.launch) and
+/// replays each requested gait in an isolated lockstep simulation. In 'record' mode the per cycle desired joint
+/// positions and tip poses are written as reference traces. In 'compare' mode each replay is compared against its
+/// reference trace within tolerances, reporting divergence alongside speedup over the reference. Defined by private
+/// parameters: ~mode, ~trace_directory, ~gaits (list of gait types), ~cycles, ~joint_tolerance,
+/// ~tip_position_tolerance, ~tip_rotation_tolerance and engine options overriding the base parameters: ~analytic_IK,
+/// ~parallel_workspace_generation, ~parallel_leg_updates, ~leg_worker_threads and ~workspace_generation_method.
+/// Only these optional engine paths can be compared. Unconditional changes to the kinematics (e.g. cached forward
+/// kinematics, exact discrete-time admittance and workspace grid lookup) are captured by both recorded and replayed
+/// traces and so are not verified against the kinematics preceding them.
+/// @return Bool denoting if all gaits were replayed (and in 'compare' mode match reference traces within tolerance)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool runTraceReplay(void)
+{
+  ros::NodeHandle private_n("~");
+
+  std::string mode;
+  std::string trace_directory;
+  std::vector<std::string> gaits;
+  int cycles;
+  double joint_tolerance;
+  double tip_position_tolerance;
+  double tip_rotation_tolerance;
+  private_n.param("mode", mode, std::string("compare"));
+  private_n.param("trace_directory", trace_directory, std::string("."));
+  private_n.param("gaits", gaits, std::vector<std::string>({ "wave_gait", "amble_gait", "ripple_gait",
+                                                             "tripod_gait" }));
+  private_n.param("cycles", cycles, DEFAULT_REPLAY_CYCLES);
+  private_n.param("joint_tolerance", joint_tolerance, DEFAULT_JOINT_TOLERANCE);
+  private_n.param("tip_position_tolerance", tip_position_tolerance, DEFAULT_TIP_POSITION_TOLERANCE);
+  private_n.param("tip_rotation_tolerance", tip_rotation_tolerance, DEFAULT_TIP_ROTATION_TOLERANCE);
+  if (mode != "record" && mode != "compare")
+  {
+    ROS_FATAL("\nInvalid trace replay mode '%s'. Modes are: record and compare.\n", mode.c_str());
+    return false;
+  }
+  Eigen::Vector3d tolerances(joint_tolerance, tip_position_tolerance, tip_rotation_tolerance);
+
+  // Acquire base parameters
+  StateController state;
+  Parameters base_params = state.getParameters();
+  base_params.adjustable_map.clear(); // Refers to parameters of state controller
+  base_params.debug_rviz.data = false;
+  base_params.ignore_IK_warnings.data = true;
+  base_params.admittance_control.data = true;
+  base_params.use_joint_effort.data = false;
+  base_params.use_workspace_cache.data = false;
+
+  // Apply engine options
+  private_n.param("analytic_IK", base_params.analytic_IK.data, base_params.analytic_IK.data);
+  private_n.param("parallel_workspace_generation", base_params.parallel_workspace_generation.data,
+                  base_params.parallel_workspace_generation.data);
+  private_n.param("parallel_leg_updates", base_params.parallel_leg_updates.data,
+                  base_params.parallel_leg_updates.data);
+  private_n.param("leg_worker_threads", base_params.leg_worker_threads.data, base_params.leg_worker_threads.data);
+  private_n.param("workspace_generation_method", base_params.workspace_generation_method.data,
+                  base_params.workspace_generation_method.data);
+  ROS_INFO("\nReplaying %s gaits (%s) with engine: analytic_IK=%d, parallel_workspace_generation=%d, "
+           "parallel_leg_updates=%d, leg_worker_threads=%d, workspace_generation_method=%s\n",
+           base_params.syropod_type.data.c_str(), mode.c_str(), int(base_params.analytic_IK.data),
+           int(base_params.parallel_workspace_generation.data), int(base_params.parallel_leg_updates.data),
+           base_params.leg_worker_threads.data, base_params.workspace_generation_method.data.c_str());
+
+  if (mode == "compare")
+  {
+    std::cout << "\n" << std::left << std::setw(16) << "gait" << std::right << std::setw(8) << "cycles"
+              << std::setw(14) << "joint (rad)" << std::setw(14) << "tip (m)" << std::setw(14) << "tip (rad)"
+              << std::setw(12) << "diverges" << std::setw(14) << "ref (usec)" << std::setw(14) << "new (usec)"
+              << std::setw(10) << "speedup" << std::endl;
+  }
+
+  // Replay each gait sequentially so cycle timings are not disturbed by concurrent replays
+  bool passed = true;
+  for (uint i = 0; i < gaits.size() && ros::ok(); ++i)
+  {
+    GaitDesignation gait_selection = GAIT_UNDESIGNATED;
+    if (gaits[i] == "wave_gait")
+    {
+      gait_selection = WAVE_GAIT;
+    }
+    else if (gaits[i] == "amble_gait")
+    {
+      gait_selection = AMBLE_GAIT;
+    }
+    else if (gaits[i] == "ripple_gait")
+    {
+      gait_selection = RIPPLE_GAIT;
+    }
+    else if (gaits[i] == "tripod_gait")
+    {
+      gait_selection = TRIPOD_GAIT;
+    }
+    else
+    {
+      ROS_FATAL("\nInvalid replay gait '%s'. Gaits are: wave_gait, amble_gait, ripple_gait and tripod_gait.\n",
+                gaits[i].c_str());
+      return false;
+    }
+
+    // Acquire gait and auto pose parameters of the replayed gait
+    state.initGaitParameters(gait_selection);
+    state.initAutoPoseParameters();
+    Parameters params = base_params;
+    const Parameters& gait_params = state.getParameters();
+    params.gait_type = gait_params.gait_type;
+    params.stance_phase = gait_params.stance_phase;
+    params.swing_phase = gait_params.swing_phase;
+    params.phase_offset = gait_params.phase_offset;
+    params.offset_multiplier = gait_params.offset_multiplier;
+    params.pose_frequency = gait_params.pose_frequency;
+    params.pose_phase_length = gait_params.pose_phase_length;
+    params.pose_phase_starts = gait_params.pose_phase_starts;
+    params.pose_phase_ends = gait_params.pose_phase_ends;
+    params.pose_negation_phase_starts = gait_params.pose_negation_phase_starts;
+    params.pose_negation_phase_ends = gait_params.pose_negation_phase_ends;
+    params.negation_transition_ratio = gait_params.negation_transition_ratio;
+    params.x_amplitudes = gait_params.x_amplitudes;
+    params.y_amplitudes = gait_params.y_amplitudes;
+    params.z_amplitudes = gait_params.z_amplitudes;
+    params.gravity_amplitudes = gait_params.gravity_amplitudes;
+    params.roll_amplitudes = gait_params.roll_amplitudes;
+    params.pitch_amplitudes = gait_params.pitch_amplitudes;
+    params.yaw_amplitudes = gait_params.yaw_amplitudes;
+
+    ReplayTrace replay;
+    replayGait(params, cycles, &replay);
+    if (!replay.started_)
+    {
+      ROS_ERROR("\nFailed to start up %s replay within %d control cycles.\n", gaits[i].c_str(), STARTUP_CYCLE_LIMIT);
+      passed = false;
+      continue;
+    }
+
+    std::string trace_path = getTracePath(trace_directory, replay.syropod_type_, replay.gait_type_);
+    if (mode == "record")
+    {
+      if (!writeTrace(trace_path, replay))
+      {
+        ROS_ERROR("\nFailed to write reference trace to '%s'.\n", trace_path.c_str());
+        passed = false;
+        continue;
+      }
+      ROS_INFO("\nRecorded %d cycle reference trace of %s to '%s' (%.3f usec/cycle).\n",
+               int(replay.rows_.size()), gaits[i].c_str(), trace_path.c_str(), replay.mean_cycle_time_ * 1.0e6);
+      continue;
+    }
+
+    ReplayTrace reference;
+    ReplayComparison comparison;
+    if (!readTrace(trace_path, &reference))
+    {
+      ROS_ERROR("\nFailed to read reference trace from '%s'.\n", trace_path.c_str());
+      passed = false;
+      continue;
+    }
+    if (!compareTraces(reference, replay, tolerances, &comparison))
+    {
+      ROS_ERROR("\nReference trace '%s' does not match the layout of the replayed model.\n", trace_path.c_str());
+      passed = false;
+      continue;
+    }
+    passed = passed && comparison.first_divergent_cycle_ == -1;
+    double speedup = replay.mean_cycle_time_ > 0.0 ? reference.mean_cycle_time_ / replay.mean_cycle_time_ : 0.0;
+    std::cout << std::left << std::setw(16) << gaits[i] << std::right << std::setw(8) << comparison.cycles_
+              << std::scientific << std::setprecision(2)
+              << std::setw(14) << comparison.max_joint_error_
+              << std::setw(14) << comparison.max_tip_position_error_
+              << std::setw(14) << comparison.max_tip_rotation_error_
+              << std::setw(12) << (comparison.first_divergent_cycle_ == -1 ?
+                                   std::string("-") : numberToString(comparison.first_divergent_cycle_))
+              << std::fixed << std::setprecision(3)
+              << std::setw(14) << reference.mean_cycle_time_ * 1.0e6
+              << std::setw(14) << replay.mean_cycle_time_ * 1.0e6
+              << std::setw(10) << std::setprecision(2) << speedup << std::endl;
+  }
+
+  if (mode == "compare")
+  {
+    std::cout << std::endl;
+    if (!passed)
+    {
+      ROS_ERROR("\nReplayed traces diverge from reference traces beyond tolerance.\n");
+      return false;
+    }
+    ROS_INFO("\nReplayed traces match reference traces within tolerance.\n");
+  }
+  return passed;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef TRACE_REPLAY_TEST
+/// Golden trace regression test (see test/trace_replay.test), run in 'compare' mode against the checked in traces.
+TEST(TraceReplay, MatchesGoldenTraces)
+{
+  EXPECT_TRUE(runTraceReplay());
+}
+
+/// Trace replay regression test executable run via rostest.
+int main(int argc, char* argv[])
+{
+  testing::InitGoogleTest(&argc, argv);
+  ros::init(argc, argv, "shc_trace_replay_test");
+  return RUN_ALL_TESTS();
+}
+#else
+/// Trace replay executable (see runTraceReplay).
+int main(int argc, char* argv[])
+{
+  ros::init(argc, argv, "shc_trace_replay");
+  return runTraceReplay() ? 0 : 1;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,6 +19,37 @@ WalkController::WalkController(std::shared_ptr<Model> model, const Parameters &p
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+WalkController::WalkController(std::shared_ptr<WalkController> walker,
+                               std::shared_ptr<Model> model, const Parameters &params)
+    : model_(model), params_(params)
+{
+  time_delta_ = walker->time_delta_;
+  walk_state_ = walker->walk_state_;
+  pose_state_ = walker->pose_state_;
+  step_ = walker->step_;
+  trajectory_table_ = walker->trajectory_table_;
+  walkspace_ = walker->walkspace_;
+  leg_walkspaces_ = walker->leg_walkspaces_;
+  walk_plane_ = walker->walk_plane_;
+  walk_plane_normal_ = walker->walk_plane_normal_;
+  regenerate_walkspace_ = walker->regenerate_walkspace_.load();
+  desired_linear_velocity_ = walker->desired_linear_velocity_;
+  desired_angular_velocity_ = walker->desired_angular_velocity_;
+  odometry_ideal_ = walker->odometry_ideal_;
+  swing_end_predictions_ = walker->swing_end_predictions_;
+  horizon_odometry_ = walker->horizon_odometry_;
+  max_linear_speed_ = walker->max_linear_speed_;
+  max_angular_speed_ = walker->max_angular_speed_;
+  max_linear_acceleration_ = walker->max_linear_acceleration_;
+  max_angular_acceleration_ = walker->max_angular_acceleration_;
+  limit_table_ = walker->limit_table_;
+  legs_at_correct_phase_ = walker->legs_at_correct_phase_;
+  legs_completed_first_step_ = walker->legs_completed_first_step_;
+  return_to_default_attempted_ = walker->return_to_default_attempted_;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void WalkController::init(void)
 {
   time_delta_ = params_.time_delta.data;
@@ -26,6 +57,7 @@ void WalkController::init(void)
   walk_plane_ = Eigen::Vector3d::Zero();
   walk_plane_normal_ = Eigen::Vector3d::UnitZ();
   odometry_ideal_ = Pose::Identity();
+  limit_table_ = LimitTable::Zero();
 
   // Set default stance tip positions from parameters
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
@@ -50,51 +82,66 @@ void WalkController::init(void)
 
   // Generate step timing
   generateStepCycle();
+  updateOdometryPredictions();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void WalkController::generateWalkspace(void)
+void WalkController::generateWalkspace(const bool &incremental)
 {
+  int leg_count = model_->getLegCount();
+  if (!incremental || static_cast<int>(leg_walkspaces_.size()) != leg_count)
+  {
+    leg_walkspaces_.assign(leg_count, LegWalkspace());
+  }
+
+  // Determine legs with changed default tip positions (all legs if cached contributions are undefined)
+  Pose current_pose = model_->getCurrentPose();
+  std::vector<bool> default_changed(leg_count);
+  for (int i = 0; i < leg_count; ++i)
+  {
+    std::shared_ptr<Leg> leg = model_->getLegByIDNumber(i);
+    Eigen::Vector3d default_tip_position = leg->getLegStepper()->getDefaultTipPose().position_;
+    const LegWalkspace &leg_walkspace = leg_walkspaces_[i];
+    default_changed[i] = !leg_walkspace.defined_ || leg_walkspace.default_tip_position_ != default_tip_position;
+  }
+
+  // Regenerate contributions of legs affected by changes
+  for (int i = 0; i < leg_count; ++i)
+  {
+    std::shared_ptr<Leg> leg = model_->getLegByIDNumber(i);
+    LegWalkspace &leg_walkspace = leg_walkspaces_[i];
+    bool pose_changed = !leg_walkspace.defined_ || leg_walkspace.current_pose_ != current_pose;
+    bool workspace_changed =
+        !leg_walkspace.defined_ || leg_walkspace.workspace_revision_ != leg->getWorkspaceRevision();
+
+    // Overlap limits depend on default tip positions of this leg and both adjacent legs
+    if (default_changed[i] || default_changed[mod(i + 1, leg_count)] || default_changed[mod(i - 1, leg_count)])
+    {
+      generateOverlapLimits(leg, &leg_walkspace);
+    }
+
+    // Walkspace radii depend on default tip position and workspace of this leg and body pose
+    if (default_changed[i] || pose_changed || workspace_changed)
+    {
+      generateWalkspaceRadii(leg, &leg_walkspace);
+    }
+
+    leg_walkspace.default_tip_position_ = leg->getLegStepper()->getDefaultTipPose().position_;
+    leg_walkspace.current_pose_ = current_pose;
+    leg_walkspace.defined_ = true;
+  }
+
   // Initially populate walkspace with maximum values (without overlapping between adjacent legs)
   walkspace_.clear();
-  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  for (int i = 0; i < leg_count; ++i)
   {
-    // Get positions of adjacent legs
-    int leg_count = model_->getLegCount();
-    std::shared_ptr<Leg> leg = leg_it_->second;
-    std::shared_ptr<Leg> adjacent_leg_1 = model_->getLegByIDNumber(mod(leg->getIDNumber() + 1, leg_count));
-    std::shared_ptr<Leg> adjacent_leg_2 = model_->getLegByIDNumber(mod(leg->getIDNumber() - 1, leg_count));
-    Eigen::Vector3d default_tip_position = leg->getLegStepper()->getDefaultTipPose().position_;
-    Eigen::Vector3d adjacent_1_tip_position = adjacent_leg_1->getLegStepper()->getDefaultTipPose().position_;
-    Eigen::Vector3d adjacent_2_tip_position = adjacent_leg_2->getLegStepper()->getDefaultTipPose().position_;
-
-    // Get distance and bearing to adjacent legs from this leg
-    double distance_to_adjacent_leg_1 = Eigen::Vector3d(default_tip_position - adjacent_1_tip_position).norm() / 2.0;
-    double distance_to_adjacent_leg_2 = Eigen::Vector3d(default_tip_position - adjacent_2_tip_position).norm() / 2.0;
-    double bearing_to_adjacent_leg_1 = radiansToDegrees(atan2(adjacent_1_tip_position[1] - default_tip_position[1],
-                                                              adjacent_1_tip_position[0] - default_tip_position[0]));
-    double bearing_to_adjacent_leg_2 = radiansToDegrees(atan2(adjacent_2_tip_position[1] - default_tip_position[1],
-                                                              adjacent_2_tip_position[0] - default_tip_position[0]));
-
-    // Populate walkspace
-    for (int bearing = 0; bearing <= 360; bearing += BEARING_STEP)
+    LimitMap::const_iterator overlap_it;
+    const LimitMap &overlap_limits = leg_walkspaces_[i].overlap_limits_;
+    for (overlap_it = overlap_limits.begin(); overlap_it != overlap_limits.end(); ++overlap_it)
     {
-      int bearing_diff_1 = abs(mod(static_cast<int>(bearing_to_adjacent_leg_1), 360) - bearing);
-      int bearing_diff_2 = abs(mod(static_cast<int>(bearing_to_adjacent_leg_2), 360) - bearing);
-      double distance_to_overlap_1 = UNASSIGNED_VALUE;
-      double distance_to_overlap_2 = UNASSIGNED_VALUE;
-      if ((bearing_diff_1 < 90 || bearing_diff_1 > 270) && distance_to_adjacent_leg_1 > 0.0)
-      {
-        distance_to_overlap_1 = distance_to_adjacent_leg_1 / cos(degreesToRadians(bearing_diff_1));
-      }
-      if ((bearing_diff_2 < 90 || bearing_diff_2 > 270) && distance_to_adjacent_leg_2 > 0.0)
-      {
-        distance_to_overlap_2 = distance_to_adjacent_leg_2 / cos(degreesToRadians(bearing_diff_2));
-      }
-      bool overlapping = params_.overlapping_walkspaces.data;
-      double min_distance = overlapping ? MAX_WORKSPACE_RADIUS : std::min(distance_to_overlap_1, distance_to_overlap_2);
-      min_distance = std::min(min_distance, MAX_WORKSPACE_RADIUS);
+      int bearing = overlap_it->first;
+      double min_distance = overlap_it->second;
       if (walkspace_.find(bearing) != walkspace_.end() && min_distance < walkspace_[bearing])
       {
         walkspace_[bearing] = min_distance;
@@ -106,113 +153,19 @@ void WalkController::generateWalkspace(void)
     }
   }
 
-  // Generate walkspace for each leg whilst ensuring symmetry and minimum values
-  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  // Combine walkspace radii of each leg whilst ensuring symmetry and minimum values
+  for (int i = 0; i < leg_count; ++i)
   {
-    std::shared_ptr<Leg> leg = leg_it_->second;
-    std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
-
-    // Calculate target height of plane within workspace
-    Pose current_pose = model_->getCurrentPose();
-    Eigen::Vector3d identity_tip_position =
-        current_pose.inverseTransformVector(leg_stepper->getIdentityTipPose().position_);
-    Eigen::Vector3d default_tip_position =
-        current_pose.inverseTransformVector(leg_stepper->getDefaultTipPose().position_);
-    Eigen::Vector3d default_shift = default_tip_position - identity_tip_position;
-    double target_workplane_height = default_shift[2];
-    LimitMap workplane = leg->getWorkplane(target_workplane_height); // Interpolated workplane
-    if (workplane.empty())
+    const LimitMap &radii = leg_walkspaces_[i].radii_;
+    if (radii.empty())
     {
       continue;
     }
-
-    // Generate walkspace radii
     LimitMap::iterator walkspace_it;
     for (walkspace_it = walkspace_.begin(); walkspace_it != walkspace_.end(); ++walkspace_it)
     {
       int bearing = walkspace_it->first;
-      double radius = walkspace_it->second;
-
-      // If default tip position is equal to identity tip position skip default shift radius generation
-      if (default_shift.norm() == 0.0)
-      {
-        radius = workplane.at(bearing);
-      }
-      // Generate radius from interpolated workplane for shifted default tip position within plane.
-      else
-      {
-        // Generate new point in walkspace
-        Eigen::Vector3d new_point = Eigen::Vector3d::UnitX() * MAX_WORKSPACE_RADIUS;
-        new_point = Eigen::AngleAxisd(degreesToRadians(bearing), Eigen::Vector3d::UnitZ())._transformVector(new_point);
-        new_point = setPrecision(new_point, 3);
-
-        // Generate radius from finding intersection of new point direction vector and existing workplane limits
-        LimitMap::iterator workplane_it;
-        for (workplane_it = workplane.begin(); workplane_it != workplane.end(); ++workplane_it)
-        {
-          // Generate reference point 1
-          int bearing_1 = workplane_it->first;
-          double radius_1 = workplane_it->second;
-          Eigen::Vector3d point_1 = Eigen::Vector3d::UnitX() * radius_1;
-          point_1 = Eigen::AngleAxisd(degreesToRadians(bearing_1), Eigen::Vector3d::UnitZ())._transformVector(point_1);
-          point_1 -= default_shift;
-          point_1[2] = 0.0;
-          point_1 = setPrecision(point_1, 3);
-
-          // Unable to find reference points which bound new walkspace point direction vector therefore set zero radius
-          if (bearing_1 == workplane.rbegin()->first)
-          {
-            ROS_WARN("\n[SHC] Unable to generate radius at bearing %d for leg %s and workplane at height %f.\n",
-                     bearing, leg->getIDName().c_str(), target_workplane_height);
-            radius = 0.0;
-            break;
-          }
-
-          // Generate reference point 2
-          int bearing_2 = next(workplane_it)->first;
-          double radius_2 = next(workplane_it)->second;
-          Eigen::Vector3d point_2 = Eigen::Vector3d::UnitX() * radius_2;
-          point_2 = Eigen::AngleAxisd(degreesToRadians(bearing_2), Eigen::Vector3d::UnitZ())._transformVector(point_2);
-          point_2 -= default_shift;
-          point_2[2] = 0.0;
-          point_2 = setPrecision(point_2, 3);
-
-          // Reference point 1 in same direction as new point
-          if (point_1.cross(new_point).norm() == 0.0)
-          {
-            radius = point_1.norm();
-            break;
-          }
-          // Reference point 2 in same direction as new point
-          else if (point_2.cross(new_point).norm() == 0.0)
-          {
-            radius = point_2.norm();
-            break;
-          }
-          // New point direction is between reference points - calculate distance to line connecting reference points
-          // Ref: stackoverflow.com/questions/13640931/how-to-determine-if-a-vector-is-between-two-other-vectors
-          else if (point_1.cross(new_point).dot(point_1.cross(point_2)) >= 0.0 &&
-                   point_2.cross(new_point).dot(point_2.cross(point_1)) >= 0.0)
-          {
-            // Calculate vector (with same direction as new point) normal to line connecting p1 & p2 on horizontal plane
-            double dx = point_2[0] - point_1[0];
-            double dy = point_2[1] - point_1[1];
-            Eigen::Vector3d normal_1 = Eigen::Vector3d(dy, -dx, 0.0).normalized();
-            Eigen::Vector3d normal_2 = Eigen::Vector3d(-dy, dx, 0.0).normalized();
-            bool same_direction_as_new_point = getProjection(new_point, normal_1).dot(normal_1) >= 0.0;
-            Eigen::Vector3d normal = (same_direction_as_new_point ? normal_1 : normal_2);
-
-            // Use normal to calculate intersection distance of new point vector on line connecting p1 & p2.
-            Eigen::Vector3d new_point_projection = getProjection(new_point, normal);
-            Eigen::Vector3d point_1_projection = getProjection(point_1, normal);
-            double ratio = point_1_projection.norm() / new_point_projection.norm();
-            radius = ratio * MAX_WORKSPACE_RADIUS;
-            break;
-          }
-        }
-      }
-
-      // Add calculated radius to walkspace whilst ensuring symmetry and min values.
+      double radius = radii.at(bearing);
       int opposite_bearing = mod(bearing + 180, 360);
       if (radius < walkspace_.at(bearing))
       {
@@ -228,6 +181,175 @@ void WalkController::generateWalkspace(void)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void WalkController::generateOverlapLimits(std::shared_ptr<Leg> leg, LegWalkspace *leg_walkspace)
+{
+  // Get positions of adjacent legs
+  int leg_count = model_->getLegCount();
+  std::shared_ptr<Leg> adjacent_leg_1 = model_->getLegByIDNumber(mod(leg->getIDNumber() + 1, leg_count));
+  std::shared_ptr<Leg> adjacent_leg_2 = model_->getLegByIDNumber(mod(leg->getIDNumber() - 1, leg_count));
+  Eigen::Vector3d default_tip_position = leg->getLegStepper()->getDefaultTipPose().position_;
+  Eigen::Vector3d adjacent_1_tip_position = adjacent_leg_1->getLegStepper()->getDefaultTipPose().position_;
+  Eigen::Vector3d adjacent_2_tip_position = adjacent_leg_2->getLegStepper()->getDefaultTipPose().position_;
+
+  // Get distance and bearing to adjacent legs from this leg
+  double distance_to_adjacent_leg_1 = Eigen::Vector3d(default_tip_position - adjacent_1_tip_position).norm() / 2.0;
+  double distance_to_adjacent_leg_2 = Eigen::Vector3d(default_tip_position - adjacent_2_tip_position).norm() / 2.0;
+  double bearing_to_adjacent_leg_1 = radiansToDegrees(atan2(adjacent_1_tip_position[1] - default_tip_position[1],
+                                                            adjacent_1_tip_position[0] - default_tip_position[0]));
+  double bearing_to_adjacent_leg_2 = radiansToDegrees(atan2(adjacent_2_tip_position[1] - default_tip_position[1],
+                                                            adjacent_2_tip_position[0] - default_tip_position[0]));
+
+  // Populate overlap limits
+  leg_walkspace->overlap_limits_.clear();
+  for (int bearing = 0; bearing <= 360; bearing += BEARING_STEP)
+  {
+    int bearing_diff_1 = abs(mod(static_cast<int>(bearing_to_adjacent_leg_1), 360) - bearing);
+    int bearing_diff_2 = abs(mod(static_cast<int>(bearing_to_adjacent_leg_2), 360) - bearing);
+    double distance_to_overlap_1 = UNASSIGNED_VALUE;
+    double distance_to_overlap_2 = UNASSIGNED_VALUE;
+    if ((bearing_diff_1 < 90 || bearing_diff_1 > 270) && distance_to_adjacent_leg_1 > 0.0)
+    {
+      distance_to_overlap_1 = distance_to_adjacent_leg_1 / cos(degreesToRadians(bearing_diff_1));
+    }
+    if ((bearing_diff_2 < 90 || bearing_diff_2 > 270) && distance_to_adjacent_leg_2 > 0.0)
+    {
+      distance_to_overlap_2 = distance_to_adjacent_leg_2 / cos(degreesToRadians(bearing_diff_2));
+    }
+    bool overlapping = params_.overlapping_walkspaces.data;
+    double min_distance = overlapping ? MAX_WORKSPACE_RADIUS : std::min(distance_to_overlap_1, distance_to_overlap_2);
+    min_distance = std::min(min_distance, MAX_WORKSPACE_RADIUS);
+    leg_walkspace->overlap_limits_[bearing] = min_distance;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WalkController::generateWalkspaceRadii(std::shared_ptr<Leg> leg, LegWalkspace *leg_walkspace)
+{
+  std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+  leg_walkspace->radii_.clear();
+
+  // Calculate target height of plane within workspace
+  Pose current_pose = model_->getCurrentPose();
+  Eigen::Vector3d identity_tip_position =
+      current_pose.inverseTransformVector(leg_stepper->getIdentityTipPose().position_);
+  Eigen::Vector3d default_tip_position =
+      current_pose.inverseTransformVector(leg_stepper->getDefaultTipPose().position_);
+  Eigen::Vector3d default_shift = default_tip_position - identity_tip_position;
+  double target_workplane_height = default_shift[2];
+
+  // Reuse interpolated workplane if target height and leg workspace are unchanged
+  if (!leg_walkspace->workplane_defined_ || leg_walkspace->workplane_height_ != target_workplane_height ||
+      leg_walkspace->workspace_revision_ != leg->getWorkspaceRevision())
+  {
+    leg_walkspace->workplane_ = leg->getWorkplane(target_workplane_height);
+    leg_walkspace->workplane_height_ = target_workplane_height;
+    leg_walkspace->workspace_revision_ = leg->getWorkspaceRevision();
+    leg_walkspace->workplane_defined_ = true;
+  }
+  const Workplane &workplane = leg_walkspace->workplane_;
+  if (workplane.empty())
+  {
+    return;
+  }
+
+  // Generate workplane limit points shifted to default tip position
+  std::vector<Eigen::Vector3d> points;
+  Workplane::const_iterator workplane_it;
+  for (workplane_it = workplane.begin(); workplane_it != workplane.end(); ++workplane_it)
+  {
+    Eigen::Vector3d point = Eigen::Vector3d::UnitX() * workplane_it->second;
+    point = Eigen::AngleAxisd(degreesToRadians(workplane_it->first), Eigen::Vector3d::UnitZ())._transformVector(point);
+    point -= default_shift;
+    point[2] = 0.0;
+    point = setPrecision(point, 3);
+    points.push_back(point);
+  }
+
+  // Generate walkspace radii
+  for (int bearing = 0; bearing <= 360; bearing += BEARING_STEP)
+  {
+    double radius = 0.0;
+
+    // If default tip position is equal to identity tip position skip default shift radius generation
+    if (default_shift.norm() == 0.0)
+    {
+      radius = workplane.at(bearing);
+      leg_walkspace->radii_[bearing] = radius;
+      continue;
+    }
+
+    // Generate new point in walkspace
+    Eigen::Vector3d new_point = Eigen::Vector3d::UnitX() * MAX_WORKSPACE_RADIUS;
+    new_point = Eigen::AngleAxisd(degreesToRadians(bearing), Eigen::Vector3d::UnitZ())._transformVector(new_point);
+    new_point = setPrecision(new_point, 3);
+
+    // Generate radius from intersection of new point direction vector and the workplane limits connecting a pair of
+    // reference points, searching pairs in order for the first which bounds the new point direction.
+    int point_count = static_cast<int>(points.size());
+    bool found = false;
+    for (int k = 0; k < point_count - 1 && !found; ++k)
+    {
+      const Eigen::Vector3d &point_1 = points[k];
+      const Eigen::Vector3d &point_2 = points[k + 1];
+
+      // Reference point 1 in same direction as new point
+      if (point_1.cross(new_point).norm() == 0.0)
+      {
+        radius = point_1.norm();
+        found = true;
+      }
+      // Reference point 2 in same direction as new point
+      else if (point_2.cross(new_point).norm() == 0.0)
+      {
+        radius = point_2.norm();
+        found = true;
+      }
+      // New point direction is between reference points - calculate distance to line connecting reference points
+      // Ref: stackoverflow.com/questions/13640931/how-to-determine-if-a-vector-is-between-two-other-vectors
+      else if (point_1.cross(new_point).dot(point_1.cross(point_2)) >= 0.0 &&
+               point_2.cross(new_point).dot(point_2.cross(point_1)) >= 0.0)
+      {
+        // Calculate vector (with same direction as new point) normal to line connecting p1 & p2 on horizontal plane
+        double dx = point_2[0] - point_1[0];
+        double dy = point_2[1] - point_1[1];
+        Eigen::Vector3d normal_1 = Eigen::Vector3d(dy, -dx, 0.0).normalized();
+        Eigen::Vector3d normal_2 = Eigen::Vector3d(-dy, dx, 0.0).normalized();
+        bool same_direction_as_new_point = getProjection(new_point, normal_1).dot(normal_1) >= 0.0;
+        Eigen::Vector3d normal = (same_direction_as_new_point ? normal_1 : normal_2);
+
+        // Use normal to calculate intersection distance of new point vector on line connecting p1 & p2.
+        Eigen::Vector3d new_point_projection = getProjection(new_point, normal);
+        Eigen::Vector3d point_1_projection = getProjection(point_1, normal);
+        double ratio = point_1_projection.norm() / new_point_projection.norm();
+        radius = ratio * MAX_WORKSPACE_RADIUS;
+        found = true;
+      }
+    }
+
+    // Unable to find reference points which bound new walkspace point direction vector therefore set zero radius
+    if (!found)
+    {
+      ROS_WARN("\n[SHC] Unable to generate radius at bearing %d for leg %s and workplane at height %f.\n",
+               bearing, leg->getIDName().c_str(), target_workplane_height);
+      radius = 0.0;
+    }
+    leg_walkspace->radii_[bearing] = radius;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WalkController::setWalkspace(const LimitMap &walkspace)
+{
+  walkspace_ = walkspace;
+  leg_walkspaces_.clear();
+  regenerate_walkspace_ = false;
+  generateLimits();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void WalkController::generateLimits(StepCycle step,
                                     LimitMap *max_linear_speed_ptr,
                                     LimitMap *max_angular_speed_ptr,
@@ -340,6 +462,17 @@ void WalkController::generateLimits(StepCycle step,
       max_angular_acceleration = UNASSIGNED_VALUE;
     }
 
+    // Populate dense limit table
+    if (set_limits)
+    {
+      int bucket = it->first / BEARING_STEP;
+      limit_table_(WALKSPACE_LIMIT, bucket) = walkspace_radius;
+      limit_table_(LINEAR_SPEED_LIMIT, bucket) = max_linear_speed;
+      limit_table_(ANGULAR_SPEED_LIMIT, bucket) = max_angular_speed;
+      limit_table_(LINEAR_ACCELERATION_LIMIT, bucket) = max_linear_acceleration;
+      limit_table_(ANGULAR_ACCELERATION_LIMIT, bucket) = max_angular_acceleration;
+    }
+
     // Populate limit maps
     if (max_linear_speed_ptr)
     {
@@ -396,6 +529,7 @@ StepCycle WalkController::generateStepCycle(const bool set_step_cycle)
   if (set_step_cycle)
   {
     step_ = step;
+    generateTrajectoryTable();
     if (walk_state_ == MOVING)
     {
       for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
@@ -411,11 +545,62 @@ StepCycle WalkController::generateStepCycle(const bool set_step_cycle)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void WalkController::generateTrajectoryTable(void)
+{
+  TrajectoryTable &table = trajectory_table_;
+
+  // Calculates number of iterations for ENTIRE swing period and time delta used for EACH bezier curve time input
+  table.swing_iterations_ = int((double(step_.swing_period_) / step_.period_) / (step_.frequency_ * time_delta_));
+  table.swing_iterations_ = roundToEvenInt(table.swing_iterations_); // Must be even
+  table.swing_delta_t_ = 1.0 / (table.swing_iterations_ / 2.0);
+
+  // Calculates number of iterations for standard stance period and time delta used for bezier curve time input
+  table.stance_period_ = step_.stance_period_;
+  table.stance_iterations_ = int((double(table.stance_period_) / step_.period_) / (step_.frequency_ * time_delta_));
+  table.stance_delta_t_ = 1.0 / table.stance_iterations_;
+
+  // Generate tip position delta weights (derivative basis weights scaled by time delta) for each curve iteration
+  table.swing_weights_.resize(table.swing_iterations_ / 2);
+  for (uint i = 0; i < table.swing_weights_.size(); ++i)
+  {
+    table.swing_weights_[i] = quarticBezierDotWeights(table.swing_delta_t_ * (i + 1), table.swing_delta_t_);
+  }
+  table.stance_weights_.resize(std::max(0, table.stance_iterations_));
+  for (uint i = 0; i < table.stance_weights_.size(); ++i)
+  {
+    table.stance_weights_[i] = quarticBezierDotWeights(table.stance_delta_t_ * (i + 1), table.stance_delta_t_);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 double WalkController::getLimit(const Eigen::Vector2d &linear_velocity_input,
                                 const double &angular_velocity_input,
                                 const LimitMap &limit)
 {
-  double min_limit = UNASSIGNED_VALUE;
+  LimitTable table = LimitTable::Zero();
+  setLimitTableRow(&table, WALKSPACE_LIMIT, limit);
+  return interpolateLimits(table, linear_velocity_input, angular_velocity_input)[WALKSPACE_LIMIT];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WalkController::setLimitTableRow(LimitTable *table, const LimitType &type, const LimitMap &limit)
+{
+  for (int bucket = 0; bucket <= BEARING_BUCKET_COUNT; ++bucket)
+  {
+    ROS_ASSERT(limit.count(bucket * BEARING_STEP));
+    (*table)(type, bucket) = limit.at(bucket * BEARING_STEP);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+LimitVector WalkController::interpolateLimits(const LimitTable &table,
+                                              const Eigen::Vector2d &linear_velocity_input,
+                                              const double &angular_velocity_input)
+{
+  LimitVector min_limits = LimitVector::Constant(UNASSIGNED_VALUE);
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
   {
     std::shared_ptr<Leg> leg = leg_it_->second;
@@ -423,16 +608,17 @@ double WalkController::getLimit(const Eigen::Vector2d &linear_velocity_input,
     Eigen::Vector3d tip_position = leg_stepper->getCurrentTipPose().position_;
     Eigen::Vector2d rotation_normal = Eigen::Vector2d(-tip_position[1], tip_position[0]);
     Eigen::Vector2d stride_vector = linear_velocity_input + angular_velocity_input * rotation_normal;
-    int bearing = mod(roundToInt(radiansToDegrees(atan2(stride_vector[1], stride_vector[0]))), 360);
-    int upper_bound = limit.lower_bound(bearing)->first;
-    int lower_bound = mod(upper_bound - BEARING_STEP, 360);
-    bearing += (bearing < lower_bound) ? 360 : 0;
-    upper_bound += (upper_bound < lower_bound) ? 360 : 0;
-    double control_input = (bearing - lower_bound) / (upper_bound - lower_bound);
-    double limit_interpolation = interpolate(limit.at(lower_bound), limit.at(mod(upper_bound, 360)), control_input);
-    min_limit = std::min(min_limit, limit_interpolation);
+
+    // Find bounding bearing buckets and interpolate all limit types between them
+    double bearing = radiansToDegrees(atan2(stride_vector[1], stride_vector[0]));
+    bearing += (bearing < 0.0) ? 360.0 : 0.0;
+    double bucket = bearing / BEARING_STEP;
+    int lower_bucket = std::min(static_cast<int>(bucket), BEARING_BUCKET_COUNT - 1);
+    double control_input = bucket - lower_bucket;
+    LimitVector limits = table.col(lower_bucket) * (1.0 - control_input) + table.col(lower_bucket + 1) * control_input;
+    min_limits = min_limits.cwiseMin(limits);
   }
-  return min_limit;
+  return min_limits;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -442,10 +628,11 @@ void WalkController::updateWalk(const Eigen::Vector2d &linear_velocity_input, co
   Eigen::Vector2d new_linear_velocity;
   double new_angular_velocity;
 
-  double max_linear_speed = getLimit(linear_velocity_input, angular_velocity_input, max_linear_speed_);
-  double max_angular_speed = getLimit(linear_velocity_input, angular_velocity_input, max_angular_speed_);
-  double max_linear_acceleration = getLimit(linear_velocity_input, angular_velocity_input, max_linear_acceleration_);
-  double max_angular_acceleration = getLimit(linear_velocity_input, angular_velocity_input, max_angular_acceleration_);
+  LimitVector limits = getLimits(linear_velocity_input, angular_velocity_input);
+  double max_linear_speed = limits[LINEAR_SPEED_LIMIT];
+  double max_angular_speed = limits[ANGULAR_SPEED_LIMIT];
+  double max_linear_acceleration = limits[LINEAR_ACCELERATION_LIMIT];
+  double max_angular_acceleration = limits[ANGULAR_ACCELERATION_LIMIT];
 
   // Calculate desired angular/linear velocities according to input mode and max limits
   if (walk_state_ != STOPPING)
@@ -563,7 +750,7 @@ void WalkController::updateWalk(const Eigen::Vector2d &linear_velocity_input, co
     walk_state_ = STOPPED;
   }
 
-  // Update walk/step state and tip position along trajectory for each leg
+  // Update walk/step state for each leg
   for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
   {
     std::shared_ptr<Leg> leg = leg_it_->second;
@@ -630,20 +817,44 @@ void WalkController::updateWalk(const Eigen::Vector2d &linear_velocity_input, co
       leg_stepper->setStepState(FORCE_STOP);
       leg_stepper->setPhase(0.0);
     }
+  }
 
-    // Update tip positions
-    if (/*walk_state_ != STOPPED && */ leg->getLegState() == WALKING)
+  // Update tip positions - each leg stepper only modifies its own state so legs may be updated concurrently
+  std::shared_ptr<WorkerPool> worker_pool = model_->getWorkerPool();
+  if (worker_pool != NULL)
+  {
+    worker_pool->run(leg_count, [&](const int &leg_id_num)
     {
-      leg_stepper->updateTipPosition(); // Updates current tip position through step cycle
-      leg_stepper->updateTipRotation();
-      leg_stepper->iteratePhase();
+      std::shared_ptr<Leg> leg = model_->getLegContainer()->at(leg_id_num);
+      if (leg->getLegState() == WALKING)
+      {
+        std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+        leg_stepper->updateTipPosition(); // Updates current tip position through step cycle
+        leg_stepper->updateTipRotation();
+        leg_stepper->iteratePhase();
+      }
+    });
+  }
+  else
+  {
+    for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+    {
+      std::shared_ptr<Leg> leg = leg_it_->second;
+      std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+      if (/*walk_state_ != STOPPED && */ leg->getLegState() == WALKING)
+      {
+        leg_stepper->updateTipPosition(); // Updates current tip position through step cycle
+        leg_stepper->updateTipRotation();
+        leg_stepper->iteratePhase();
+      }
     }
   }
   updateWalkPlane();
   odometry_ideal_ = odometry_ideal_.addPose(calculateOdometry(time_delta_));
+  updateOdometryPredictions();
   if (regenerate_walkspace_)
   {
-    generateWalkspace();
+    generateWalkspace(true);
   }
 }
 
@@ -792,6 +1003,39 @@ Pose WalkController::calculateOdometry(const double &time_period)
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void WalkController::updateOdometryPredictions(void)
+{
+  // Step timing is common to all legs
+  double swing_time = (double(step_.swing_period_) / step_.period_) / step_.frequency_;
+  double stance_time = (double(step_.stance_period_) / step_.period_) / step_.frequency_;
+
+  swing_end_predictions_.resize(model_->getLegCount());
+  for (leg_it_ = model_->getLegContainer()->begin(); leg_it_ != model_->getLegContainer()->end(); ++leg_it_)
+  {
+    std::shared_ptr<Leg> leg = leg_it_->second;
+    std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+    SwingEndPrediction &prediction = swing_end_predictions_[leg->getIDNumber()];
+    if (leg_stepper->getStanceProgress() >= 0.0)
+    {
+      prediction.time_to_swing_end_ = stance_time * (1.0 - leg_stepper->getStanceProgress()) + swing_time;
+    }
+    else
+    {
+      prediction.time_to_swing_end_ = swing_time * (1.0 - leg_stepper->getSwingProgress());
+    }
+    prediction.odometry_ = calculateOdometry(prediction.time_to_swing_end_);
+  }
+
+  const std::vector<double> &horizons = params_.odometry_prediction_horizons.data;
+  horizon_odometry_.resize(horizons.size());
+  for (uint i = 0; i < horizons.size(); ++i)
+  {
+    horizon_odometry_[i] = calculateOdometry(horizons[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 LegStepper::LegStepper(std::shared_ptr<WalkController> walker, std::shared_ptr<Leg> leg, const Pose &identity_tip_pose)
     : walker_(walker)
     , leg_(leg)
@@ -952,30 +1196,12 @@ Eigen::Vector3d LegStepper::calculateStanceSpanChange(void)
   Eigen::Vector3d default_shift = default_tip_pose_.position_ - identity_tip_pose_.position_;
   double target_workplane_height = setPrecision(default_shift[2], 3);
 
-  // Get bounding existing workplanes within workspace
-  Workspace workspace = leg_->getWorkspace();
-  Workspace::iterator upper_bound_it = workspace.upper_bound(target_workplane_height);
-  Workspace::iterator lower_bound_it = prev(upper_bound_it);
-  double upper_workplane_height = setPrecision(upper_bound_it->first, 3);
-  double lower_workplane_height = setPrecision(lower_bound_it->first, 3);
-  LimitMap upper_workplane = upper_bound_it->second;
-  LimitMap lower_workplane = lower_bound_it->second;
-
-  // Calculate interpolation of radii for target workplane height between existing workspace planes
-  double i = (target_workplane_height - lower_workplane_height) / (upper_workplane_height - lower_workplane_height);
+  // Get radius at target workplane height within workspace
   double stance_span_modifier = walker_->getParameters().stance_span_modifier.current_value;
   bool positive_y_axis = (Eigen::Vector3d::UnitY().dot(identity_tip_pose_.position_) > 0.0);
   int bearing = (positive_y_axis ^ (stance_span_modifier > 0.0)) ? 270 : 90;
   stance_span_modifier *= (positive_y_axis ? 1.0 : -1.0);
-  double radius = 0.0;
-  if (workspace.size() == 1)
-  {
-    radius = workspace.at(0.0).at(bearing);
-  }
-  else
-  {
-    radius = lower_workplane.at(bearing) * (1.0 - i) + upper_workplane.at(bearing) * i;
-  }
+  double radius = leg_->getWorkspaceGrid().getRadius(target_workplane_height, bearing);
   return Eigen::Vector3d(0.0, radius * stance_span_modifier, 0.0);
 }
 
@@ -1009,7 +1235,7 @@ void LegStepper::updateDefaultTipPosition(void)
   default_tip_pose_ = new_default_tip_pose;
   if (default_tip_position_delta > IK_TOLERANCE)
   {
-    //walker_->setRegenerateWalkspace();
+    walker_->setRegenerateWalkspace();
   }
 }
 
@@ -1031,14 +1257,20 @@ void LegStepper::updateTipPosition(void)
   }
   ROS_ASSERT(modified_stance_period != 0);
 
-  // Calculates number of iterations for ENTIRE swing period and time delta used for EACH bezier curve time input
-  int swing_iterations = int((double(step.swing_period_) / step.period_) / (step.frequency_ * time_delta));
-  swing_iterations = roundToEvenInt(swing_iterations); // Must be even
-  swing_delta_t_ = 1.0 / (swing_iterations / 2.0);     // 1 sec divided by number of iterations for each bezier curve
+  // Swing iteration constants depend only on step cycle so are taken from precomputed trajectory table
+  const TrajectoryTable &table = walker_->getTrajectoryTable();
+  int swing_iterations = table.swing_iterations_;
+  swing_delta_t_ = table.swing_delta_t_; // 1 sec divided by number of iterations for each bezier curve
 
-  // Calculates number of iterations for stance period and time delta used for bezier curve time input
-  int stance_iterations = int((double(modified_stance_period) / step.period_) / (step.frequency_ * time_delta));
-  stance_delta_t_ = 1.0 / stance_iterations; // 1 second divided by number of iterations
+  // Stance iteration constants are taken from trajectory table unless stance period is modified (i.e. first step)
+  bool tabulated_stance_period = (modified_stance_period == table.stance_period_);
+  int stance_iterations = table.stance_iterations_;
+  stance_delta_t_ = table.stance_delta_t_;
+  if (!tabulated_stance_period)
+  {
+    stance_iterations = int((double(modified_stance_period) / step.period_) / (step.frequency_ * time_delta));
+    stance_delta_t_ = 1.0 / stance_iterations; // 1 second divided by number of iterations
+  }
 
   // Generate default target
   target_tip_pose_.position_ = default_tip_pose_.position_ + 0.5 * stride_vector_;
@@ -1070,10 +1302,10 @@ void LegStepper::updateTipPosition(void)
         target_tip_pose_ = external_target_.pose_.removePose(external_target_.transform_);
         swing_clearance_ = swing_clearance_.normalized() * external_target_.swing_clearance_;
         // Add lead to compensate for moving target
+        // (Predicted by walk controller at end of previous cycle, at which the step phase equals the current phase)
         if (external_target_.frame_id_ == "odom_ideal")
         {
-          double time_to_swing_end = (swing_iterations - iteration) * time_delta;
-          Eigen::Vector3d target_lead = walker_->calculateOdometry(time_to_swing_end).position_;
+          Eigen::Vector3d target_lead = walker_->getSwingEndOdometry(leg_->getIDNumber()).position_;
           target_tip_pose_.position_ -= target_lead;
         }
       }
@@ -1116,17 +1348,18 @@ void LegStepper::updateTipPosition(void)
       forceNormalTouchdown();
     }
 
+    // Evaluate tip position delta from precomputed weights where available
+    int curve_iteration = first_half ? iteration : iteration - swing_iterations / 2;
+    const Eigen::Vector3d *swing_nodes = first_half ? swing_1_nodes_ : swing_2_nodes_;
+    double time_input = swing_delta_t_ * curve_iteration;
     Eigen::Vector3d delta_pos(0, 0, 0);
-    double time_input = 0;
-    if (first_half)
+    if (curve_iteration >= 1 && curve_iteration <= static_cast<int>(table.swing_weights_.size()))
     {
-      time_input = swing_delta_t_ * iteration;
-      delta_pos = swing_delta_t_ * quarticBezierDot(swing_1_nodes_, time_input);
+      delta_pos = bezierWeightedSum(swing_nodes, table.swing_weights_[curve_iteration - 1]);
     }
     else
     {
-      time_input = swing_delta_t_ * (iteration - swing_iterations / 2);
-      delta_pos = swing_delta_t_ * quarticBezierDot(swing_2_nodes_, time_input);
+      delta_pos = swing_delta_t_ * quarticBezierDot(swing_nodes, time_input);
     }
 
     ROS_ASSERT(time_input <= 1.0);
@@ -1170,7 +1403,15 @@ void LegStepper::updateTipPosition(void)
     // Uses derivative of bezier curve to ensure correct velocity along ground, this means the position may not
     // reach the target but this is less important than ensuring correct velocity according to stride vector
     double time_input = iteration * stance_delta_t_;
-    Eigen::Vector3d delta_pos = stance_delta_t_ * quarticBezierDot(stance_nodes_, time_input);
+    Eigen::Vector3d delta_pos(0, 0, 0);
+    if (tabulated_stance_period && iteration <= static_cast<int>(table.stance_weights_.size()))
+    {
+      delta_pos = bezierWeightedSum(stance_nodes_, table.stance_weights_[iteration - 1]);
+    }
+    else
+    {
+      delta_pos = stance_delta_t_ * quarticBezierDot(stance_nodes_, time_input);
+    }
     ROS_ASSERT(delta_pos.norm() < UNASSIGNED_VALUE);
     current_tip_pose_.position_ += delta_pos;
     current_tip_velocity_ = delta_pos / walker_->getTimeDelta();
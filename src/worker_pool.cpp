@@ -0,0 +1,165 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/worker_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkerPool::WorkerPool(const int& worker_count)
+{
+  int core_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  for (int i = 0; i < worker_count; ++i)
+  {
+    workers_.push_back(std::thread(&WorkerPool::work, this));
+
+    // Pin worker to own core, leaving first core for calling thread
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET((i + 1) % core_count, &cpu_set);
+    if (pthread_setaffinity_np(workers_.back().native_handle(), sizeof(cpu_set_t), &cpu_set) != 0)
+    {
+      ROS_WARN("\n[SHC] Unable to pin worker thread %d to core %d.\n", i, (i + 1) % core_count);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkerPool::~WorkerPool(void)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+  }
+  batch_started_.notify_all();
+  for (std::thread &worker : workers_)
+  {
+    worker.join();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WorkerPool::initRealTime(const int& core, const int& priority)
+{
+  bool success = true;
+  int core_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  struct sched_param scheduling_parameters;
+  scheduling_parameters.sched_priority = clamped(priority, sched_get_priority_min(SCHED_FIFO),
+                                                 sched_get_priority_max(SCHED_FIFO));
+  for (uint i = 0; i < workers_.size(); ++i)
+  {
+    pthread_t worker = workers_[i].native_handle();
+
+    // Pin worker to own core, skipping core of real time calling thread
+    if (core >= 0 && core_count > 1)
+    {
+      int worker_core = int(i) % (core_count - 1);
+      worker_core += (worker_core >= core) ? 1 : 0;
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(worker_core, &cpu_set);
+      if (pthread_setaffinity_np(worker, sizeof(cpu_set_t), &cpu_set) != 0)
+      {
+        ROS_WARN("\n[SHC] Unable to pin worker thread %d to core %d.\n", int(i), worker_core);
+        success = false;
+      }
+    }
+
+    int result = pthread_setschedparam(worker, SCHED_FIFO, &scheduling_parameters);
+    if (result != 0)
+    {
+      ROS_WARN("\n[SHC] Unable to set SCHED_FIFO priority %d of worker thread %d (%s).\n",
+               scheduling_parameters.sched_priority, int(i), strerror(result));
+      success = false;
+    }
+  }
+  return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::run(const int& task_count, const std::function<void(const int&)>& task)
+{
+  // Execute serially if no workers are available or there is no work to share
+  if (workers_.empty() || task_count <= 1)
+  {
+    for (int i = 0; i < task_count; ++i)
+    {
+      task(i);
+    }
+    return;
+  }
+
+  // Start new batch
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    task_count_ = task_count;
+    next_task_ = 0;
+    completed_tasks_ = 0;
+    generation_++;
+  }
+  batch_started_.notify_all();
+
+  // Calling thread shares tasks then waits for all tasks to complete and all workers to leave the batch
+  executeTasks();
+  std::unique_lock<std::mutex> lock(mutex_);
+  batch_completed_.wait(lock, [&]() { return completed_tasks_ == task_count_ && active_workers_ == 0; });
+  task_ = NULL;
+  task_count_ = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::work(void)
+{
+  uint64_t generation = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    batch_started_.wait(lock, [&]() { return !running_ || generation_ != generation; });
+    if (!running_)
+    {
+      return;
+    }
+    generation = generation_;
+
+    // Skip batch if already completed before this worker woke
+    if (task_ == NULL)
+    {
+      continue;
+    }
+
+    active_workers_++;
+    lock.unlock();
+    executeTasks();
+    lock.lock();
+    if (--active_workers_ == 0)
+    {
+      batch_completed_.notify_one();
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void WorkerPool::executeTasks(void)
+{
+  int index;
+  while ((index = next_task_++) < task_count_)
+  {
+    (*task_)(index);
+    completed_tasks_++;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
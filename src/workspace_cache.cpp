@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2019
+// Commonwealth Scientific and Industrial Research Organisation (CSIRO)
+// ABN 41 687 119 230
+//
+// Author: Fletcher Talbot
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "syropod_highlevel_controller/workspace_cache.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+
+/// Writes binary representation of input value to output stream.
+/// @param[in] stream The output stream
+/// @param[in] value The value to be written
+template <class T>
+inline void writeBinary(std::ofstream& stream, const T& value)
+{
+  stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// Reads binary representation of value from input stream.
+/// @param[in] stream The input stream
+/// @param[out] value The value read from stream
+/// @return Bool denoting if the value was successfully read
+template <class T>
+inline bool readBinary(std::ifstream& stream, T* value)
+{
+  stream.read(reinterpret_cast<char*>(value), sizeof(T));
+  return static_cast<bool>(stream);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+WorkspaceCache::WorkspaceCache(std::shared_ptr<Model> model, std::shared_ptr<WalkController> walker,
+                               const Parameters& params)
+  : model_(model)
+  , walker_(walker)
+  , params_(params)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string WorkspaceCache::generateKey(void)
+{
+  // Collate all values which workspace and walkspace generation depend upon
+  std::ostringstream key_data;
+  key_data << std::fixed << std::setprecision(6);
+  key_data << WORKSPACE_CACHE_VERSION << ":" << BEARING_STEP << ":" << MAX_POSITION_DELTA << ":";
+  key_data << MAX_WORKSPACE_RADIUS << ":" << WORKSPACE_LAYERS << ":" << SEARCH_STRIDE << ":" << IK_TOLERANCE << ":";
+  key_data << MAX_SEARCH_IK_ITERATIONS << ":" << params_.analytic_IK.data << ":";
+  key_data << params_.syropod_type.data << ":" << params_.body_clearance.data << ":";
+  key_data << params_.rough_terrain_mode.data << ":" << params_.overlapping_walkspaces.data << ":";
+  key_data << params_.gravity_aligned_tips.data << ":" << params_.clamp_joint_positions.data << ":";
+  key_data << params_.workspace_generation_method.data << ":";
+
+  // Current body pose rounded to mm precision (reflects body clearance achieved by start up sequence)
+  Pose current_pose = model_->getCurrentPose();
+  key_data << setPrecision(current_pose.position_, 3).transpose() << ":";
+  key_data << setPrecision(quaternionToEulerAngles(current_pose.rotation_), 3).transpose() << ":";
+
+  // Kinematic description and default stance of each leg
+  LegContainer::iterator leg_it;
+  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    int id_number = leg->getIDNumber();
+    key_data << leg->getIDName() << ":" << leg->getJointCount() << ":";
+    for (int i = 0; i <= leg->getJointCount(); ++i)
+    {
+      std::map<std::string, double>::const_iterator it;
+      const std::map<std::string, double>& link_parameters = params_.link_parameters[id_number][i].data;
+      for (it = link_parameters.begin(); it != link_parameters.end(); ++it)
+      {
+        key_data << it->first << "=" << it->second << ":";
+      }
+      if (i < leg->getJointCount())
+      {
+        const std::map<std::string, double>& joint_parameters = params_.joint_parameters[id_number][i].data;
+        for (it = joint_parameters.begin(); it != joint_parameters.end(); ++it)
+        {
+          key_data << it->first << "=" << it->second << ":";
+        }
+      }
+    }
+    std::shared_ptr<LegStepper> leg_stepper = leg->getLegStepper();
+    key_data << setPrecision(leg_stepper->getIdentityTipPose().position_, 3).transpose() << ":";
+    key_data << setPrecision(leg_stepper->getDefaultTipPose().position_, 3).transpose() << ":";
+  }
+
+  // Hash collated values (64-bit FNV-1a)
+  uint64_t hash = 14695981039346656037ULL;
+  std::string data = key_data.str();
+  for (char c : data)
+  {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ULL;
+  }
+  std::ostringstream key;
+  key << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return key.str();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::string WorkspaceCache::getCacheFilePath(const std::string& key)
+{
+  return getROSHomePath() + "/shc/workspace_cache/" + params_.syropod_type.data + "_" + key + ".bin";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WorkspaceCache::load(void)
+{
+  std::string key = generateKey();
+  std::string file_path = getCacheFilePath(key);
+  std::ifstream file(file_path, std::ios::binary);
+  if (!file)
+  {
+    ROS_INFO("\n[SHC] No cached workspace found (%s).\n", file_path.c_str());
+    return false;
+  }
+
+  // Validate header
+  uint32_t magic, version;
+  uint64_t stored_key_length;
+  bool valid = readBinary(file, &magic) && readBinary(file, &version) && readBinary(file, &stored_key_length);
+  valid = valid && magic == WORKSPACE_CACHE_MAGIC && version == WORKSPACE_CACHE_VERSION;
+  valid = valid && stored_key_length == key.size();
+  std::string stored_key(valid ? stored_key_length : 0, '\0');
+  valid = valid && file.read(&stored_key[0], stored_key_length) && stored_key == key;
+
+  // Read workspace of each leg
+  uint32_t leg_count = 0;
+  valid = valid && readBinary(file, &leg_count) && leg_count == static_cast<uint32_t>(model_->getLegCount());
+  std::map<int, Workspace> workspaces;
+  LegContainer* legs = model_->getLegContainer();
+  for (uint32_t i = 0; valid && i < leg_count; ++i)
+  {
+    int32_t leg_id;
+    uint32_t plane_count;
+    valid = readBinary(file, &leg_id) && readBinary(file, &plane_count);
+    valid = valid && legs->find(leg_id) != legs->end() && !workspaces.count(leg_id);
+    Workspace workspace;
+    for (uint32_t j = 0; valid && j < plane_count; ++j)
+    {
+      double height;
+      uint32_t bearing_count;
+      valid = readBinary(file, &height) && readBinary(file, &bearing_count);
+      Workplane workplane;
+      for (uint32_t k = 0; valid && k < bearing_count; ++k)
+      {
+        int32_t bearing;
+        double radius;
+        valid = readBinary(file, &bearing) && readBinary(file, &radius);
+        workplane[bearing] = radius;
+      }
+      workspace[height] = workplane;
+    }
+    valid = valid && !workspace.empty();
+    workspaces[leg_id] = workspace;
+  }
+
+  // Read walkspace
+  uint32_t bearing_count = 0;
+  valid = valid && readBinary(file, &bearing_count) && bearing_count > 0;
+  LimitMap walkspace;
+  for (uint32_t i = 0; valid && i < bearing_count; ++i)
+  {
+    int32_t bearing;
+    double radius;
+    valid = readBinary(file, &bearing) && readBinary(file, &radius);
+    walkspace[bearing] = radius;
+  }
+
+  if (!valid)
+  {
+    ROS_WARN("\n[SHC] Cached workspace file %s is invalid and will be regenerated.\n", file_path.c_str());
+    return false;
+  }
+
+  std::map<int, Workspace>::iterator workspace_it;
+  for (workspace_it = workspaces.begin(); workspace_it != workspaces.end(); ++workspace_it)
+  {
+    model_->getLegByIDNumber(workspace_it->first)->setWorkspace(workspace_it->second);
+  }
+  walker_->setWalkspace(walkspace);
+  ROS_INFO("\n[SHC] Loaded cached workspace (%s).\n", file_path.c_str());
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool WorkspaceCache::save(void)
+{
+  std::string key = generateKey();
+  std::string file_path = getCacheFilePath(key);
+  std::string temporary_file_path = file_path + ".tmp";
+  std::error_code error;
+  std::filesystem::create_directories(std::filesystem::path(file_path).parent_path(), error);
+  std::ofstream file(temporary_file_path, std::ios::binary | std::ios::trunc);
+  if (error || !file)
+  {
+    ROS_WARN("\n[SHC] Unable to write workspace cache file %s.\n", file_path.c_str());
+    return false;
+  }
+
+  // Write header
+  writeBinary(file, static_cast<uint32_t>(WORKSPACE_CACHE_MAGIC));
+  writeBinary(file, static_cast<uint32_t>(WORKSPACE_CACHE_VERSION));
+  writeBinary(file, static_cast<uint64_t>(key.size()));
+  file.write(key.data(), key.size());
+
+  // Write workspace of each leg
+  writeBinary(file, static_cast<uint32_t>(model_->getLegCount()));
+  LegContainer::iterator leg_it;
+  for (leg_it = model_->getLegContainer()->begin(); leg_it != model_->getLegContainer()->end(); ++leg_it)
+  {
+    std::shared_ptr<Leg> leg = leg_it->second;
+    Workspace workspace = leg->getWorkspace();
+    writeBinary(file, static_cast<int32_t>(leg->getIDNumber()));
+    writeBinary(file, static_cast<uint32_t>(workspace.size()));
+    Workspace::iterator workspace_it;
+    for (workspace_it = workspace.begin(); workspace_it != workspace.end(); ++workspace_it)
+    {
+      writeBinary(file, workspace_it->first);
+      writeBinary(file, static_cast<uint32_t>(workspace_it->second.size()));
+      Workplane::iterator workplane_it;
+      for (workplane_it = workspace_it->second.begin(); workplane_it != workspace_it->second.end(); ++workplane_it)
+      {
+        writeBinary(file, static_cast<int32_t>(workplane_it->first));
+        writeBinary(file, workplane_it->second);
+      }
+    }
+  }
+
+  // Write walkspace
+  LimitMap walkspace = walker_->getWalkspace();
+  writeBinary(file, static_cast<uint32_t>(walkspace.size()));
+  LimitMap::iterator walkspace_it;
+  for (walkspace_it = walkspace.begin(); walkspace_it != walkspace.end(); ++walkspace_it)
+  {
+    writeBinary(file, static_cast<int32_t>(walkspace_it->first));
+    writeBinary(file, walkspace_it->second);
+  }
+  file.close();
+
+  // Move completed file into place so partially written files are never loaded
+  std::filesystem::rename(temporary_file_path, file_path, error);
+  if (!file || error)
+  {
+    ROS_WARN("\n[SHC] Unable to write workspace cache file %s.\n", file_path.c_str());
+    return false;
+  }
+  ROS_INFO("\n[SHC] Saved workspace to cache (%s).\n", file_path.c_str());
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////